@@ -0,0 +1,1319 @@
+/*
+ * itclAutoIndex.c --
+ *
+ *      This file contains the binary autoload index for [incr Tcl]
+ *      classes and member function bodies.  "itcl::autoindex create"
+ *      scans source files for class definitions and "itcl::body" and
+ *      "itcl::configbody" commands and writes their names together with
+ *      the position of the defining command to an index file.
+ *      "itcl::autoindex add" reads an index file and each class or body
+ *      in it is then loaded on its own, when it is first needed, by
+ *      reading and evaluating just the text of its definition.  The
+ *      bodies and configbodies of a class are loaded along with it.
+ *      Classes are also entered into the Tcl "auto_index" array, so
+ *      that "unknown" finds them.
+ *
+ *      An index file looks like this, all numbers are 32 bit unsigned
+ *      in big-endian byte order, all strings are UTF-8 and preceded by
+ *      their length:
+ *
+ *          "ITCLIDX2"
+ *          <number of files>
+ *              <file name, relative to the directory of the index>
+ *              <file size> <hash of the file contents>...
+ *          <number of entries>
+ *              <full name> <namespace> <kind> <file number> <offset>
+ *              <length>...
+ *
+ *      The kind is ITCL_AUTOINDEX_CLASS, ITCL_AUTOINDEX_BODY or
+ *      ITCL_AUTOINDEX_CONFIGBODY.  Before a definition is read from a
+ *      source file, the size and hash of the file are compared with the
+ *      index.  A file that changed since the index was written is
+ *      sourced as a whole instead, as "auto_load" would do.
+ *
+ * See the file "license.terms" for information on usage and redistribution of
+ * this file, and for a DISCLAIMER OF ALL WARRANTIES.
+ */
+
+#include "itclInt.h"
+#include <limits.h>
+
+#define ITCL_AUTOINDEX_MAGIC "ITCLIDX2"
+#define ITCL_AUTOINDEX_MAGIC_LEN 8
+#define ITCL_AUTOINDEX_CLASS 0
+#define ITCL_AUTOINDEX_BODY 1
+#define ITCL_AUTOINDEX_CONFIGBODY 2
+
+/*
+ *  What is known about a source file named in an index.
+ */
+#define ITCL_AUTOINDEX_UNCHECKED 0  /* not compared with the index yet */
+#define ITCL_AUTOINDEX_SAME 1       /* matches the index */
+#define ITCL_AUTOINDEX_CHANGED 2    /* differs from the index */
+#define ITCL_AUTOINDEX_SOURCED 3    /* differs and was sourced */
+
+typedef struct ItclAutoIndexFile {
+    Tcl_Obj *pathPtr;             /* source file, joined to the directory
+                                   * of the index */
+    unsigned int size;            /* size recorded in the index */
+    unsigned int hash;            /* hash recorded in the index */
+    int state;                    /* ITCL_AUTOINDEX_UNCHECKED, ... */
+    Tcl_WideUInt statSize;        /* size and modification time of the */
+    Tcl_WideInt statMtime;        /* file when state was determined */
+} ItclAutoIndexFile;
+
+/*
+ *  An index file registered by "itcl::autoindex add".
+ */
+typedef struct ItclAutoIndex {
+    Tcl_Obj *pathPtr;             /* name of the index file */
+    int numFiles;                 /* number of source files */
+    ItclAutoIndexFile *files;     /* source files */
+    struct ItclAutoIndexEntry *entriesPtr;
+                                  /* entries read from the index */
+    struct ItclAutoIndex *nextPtr;
+} ItclAutoIndex;
+
+/*
+ *  Where to find the definition of one class or member function.
+ */
+typedef struct ItclAutoIndexEntry {
+    Tcl_Obj *namePtr;             /* full name of the class or member */
+    int kind;                     /* ITCL_AUTOINDEX_CLASS, ... */
+    ItclAutoIndex *indexPtr;      /* index the entry comes from */
+    int fileNum;                  /* source file in indexPtr */
+    Tcl_Obj *nsNamePtr;           /* namespace the definition is
+                                   * evaluated in */
+    unsigned int offset;          /* byte offset of the definition */
+    unsigned int length;          /* length of the definition in bytes */
+    int isLoading;                /* set while it is evaluated, a
+                                   * definition that needs itself is
+                                   * not loaded again */
+    struct ItclAutoIndexEntry *nextPtr;
+                                  /* next entry of the same index */
+    struct ItclAutoIndexEntry *nextMemberPtr;
+                                  /* next body or configbody of the
+                                   * same class */
+} ItclAutoIndexEntry;
+
+/*
+ *  The commands recognized by "itcl::autoindex create".  The number of
+ *  words includes the command name.
+ */
+static const struct {
+    const char *name;
+    int numWords;
+    int kind;
+} indexedCmds[] = {
+    {"itcl::class", 3, ITCL_AUTOINDEX_CLASS},
+    {"class", 3, ITCL_AUTOINDEX_CLASS},
+    {"itcl::type", 3, ITCL_AUTOINDEX_CLASS},
+    {"type", 3, ITCL_AUTOINDEX_CLASS},
+    {"itcl::widget", 3, ITCL_AUTOINDEX_CLASS},
+    {"widget", 3, ITCL_AUTOINDEX_CLASS},
+    {"itcl::widgetadaptor", 3, ITCL_AUTOINDEX_CLASS},
+    {"widgetadaptor", 3, ITCL_AUTOINDEX_CLASS},
+    {"itcl::extendedclass", 3, ITCL_AUTOINDEX_CLASS},
+    {"extendedclass", 3, ITCL_AUTOINDEX_CLASS},
+    {"itcl::body", 4, ITCL_AUTOINDEX_BODY},
+    {"body", 4, ITCL_AUTOINDEX_BODY},
+    {"itcl::configbody", 3, ITCL_AUTOINDEX_CONFIGBODY},
+    {"configbody", 3, ITCL_AUTOINDEX_CONFIGBODY},
+    {NULL, 0, 0}
+};
+
+static int ReadAutoIndex(Tcl_Interp *interp, ItclObjectInfo *infoPtr,
+        ItclAutoIndex *indexPtr);
+static void ForgetAutoIndex(Tcl_Interp *interp, ItclObjectInfo *infoPtr,
+        ItclAutoIndex *indexPtr);
+static void AddToTclAutoIndex(Tcl_Interp *interp, Tcl_Obj *namePtr);
+
+
+/*
+ * ------------------------------------------------------------------------
+ *  QualifyName()
+ *
+ *  Leaves the fully qualified form of name, as seen from the namespace
+ *  nsName, in the uninitialized DString.
+ * ------------------------------------------------------------------------
+ */
+static void
+QualifyName(
+    const char *nsName,
+    const char *name,
+    int length,
+    Tcl_DString *dsPtr)
+{
+    Tcl_DStringInit(dsPtr);
+    if ((length < 2) || (name[0] != ':') || (name[1] != ':')) {
+        Tcl_DStringAppend(dsPtr, nsName, -1);
+        if (strcmp(nsName, "::") != 0) {
+            Tcl_DStringAppend(dsPtr, "::", 2);
+        }
+    }
+    Tcl_DStringAppend(dsPtr, name, length);
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  IndexScript()
+ *
+ *  Appends an index entry to entriesPtr for each class definition,
+ *  "itcl::body" and "itcl::configbody" command in script, and descends
+ *  into the bodies of "namespace eval" commands.  Offsets are taken
+ *  relative to base, the start of the file.  Commands with
+ *  substitutions in the words that matter are skipped.
+ * ------------------------------------------------------------------------
+ */
+static void
+IndexScript(
+    Tcl_Obj *entriesPtr,
+    const char *base,
+    const char *script,
+    int length,
+    const char *nsName,
+    int fileNum)
+{
+    Tcl_Parse parse;
+    Tcl_Token *wordPtrs[4];
+    Tcl_Token *tokenPtr;
+    Tcl_DString name;
+    Tcl_Obj *entryPtr;
+    const char *p;
+    const char *cmdName;
+    int numWords;
+    int i;
+
+    p = script;
+    while (p < script + length) {
+        if (Tcl_ParseCommand(NULL, p, length - (int)(p - script), 0,
+                &parse) != TCL_OK) {
+            return;
+        }
+        p = parse.commandStart + parse.commandSize;
+        numWords = parse.numWords;
+        if ((numWords < 3) || (numWords > 4)) {
+            Tcl_FreeParse(&parse);
+            continue;
+        }
+        tokenPtr = parse.tokenPtr;
+        for (i = 0; i < numWords; i++) {
+            if ((tokenPtr->type != TCL_TOKEN_SIMPLE_WORD)
+                    || (tokenPtr->numComponents != 1)) {
+                break;
+            }
+            wordPtrs[i] = tokenPtr + 1;
+            tokenPtr += tokenPtr->numComponents + 1;
+        }
+        if (i < numWords) {
+            Tcl_FreeParse(&parse);
+            continue;
+        }
+
+        cmdName = wordPtrs[0]->start;
+        if ((wordPtrs[0]->size > 2) && (cmdName[0] == ':')
+                && (cmdName[1] == ':')) {
+            cmdName += 2;
+        }
+        if ((numWords == 4) && (wordPtrs[0]->size == 9)
+                && (strncmp(cmdName, "namespace", 9) == 0)
+                && (wordPtrs[1]->size == 4)
+                && (strncmp(wordPtrs[1]->start, "eval", 4) == 0)) {
+            QualifyName(nsName, wordPtrs[2]->start, wordPtrs[2]->size, &name);
+            IndexScript(entriesPtr, base, wordPtrs[3]->start,
+                    wordPtrs[3]->size, Tcl_DStringValue(&name), fileNum);
+            Tcl_DStringFree(&name);
+            Tcl_FreeParse(&parse);
+            continue;
+        }
+        for (i = 0; indexedCmds[i].name != NULL; i++) {
+            if ((indexedCmds[i].numWords == numWords)
+                    && ((int)strlen(indexedCmds[i].name) ==
+                    wordPtrs[0]->size - (int)(cmdName - wordPtrs[0]->start))
+                    && (strncmp(cmdName, indexedCmds[i].name,
+                    strlen(indexedCmds[i].name)) == 0)) {
+                break;
+            }
+        }
+        if (indexedCmds[i].name != NULL) {
+            QualifyName(nsName, wordPtrs[1]->start, wordPtrs[1]->size, &name);
+            entryPtr = Tcl_NewListObj(0, NULL);
+            Tcl_ListObjAppendElement(NULL, entryPtr, Tcl_NewStringObj(
+                    Tcl_DStringValue(&name), Tcl_DStringLength(&name)));
+            Tcl_ListObjAppendElement(NULL, entryPtr,
+                    Tcl_NewStringObj(nsName, -1));
+            Tcl_ListObjAppendElement(NULL, entryPtr,
+                    Tcl_NewIntObj(indexedCmds[i].kind));
+            Tcl_ListObjAppendElement(NULL, entryPtr, Tcl_NewIntObj(fileNum));
+            Tcl_ListObjAppendElement(NULL, entryPtr,
+                    Tcl_NewIntObj((int)(parse.commandStart - base)));
+            Tcl_ListObjAppendElement(NULL, entryPtr,
+                    Tcl_NewIntObj(parse.commandSize));
+            Tcl_ListObjAppendElement(NULL, entriesPtr, entryPtr);
+            Tcl_DStringFree(&name);
+        }
+        Tcl_FreeParse(&parse);
+    }
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  HashBytes()
+ *
+ *  Returns the 32 bit FNV-1a hash of the contents of a source file.
+ * ------------------------------------------------------------------------
+ */
+static unsigned int
+HashBytes(
+    const unsigned char *bytes,
+    int length)
+{
+    unsigned int hash = 2166136261U;
+    int i;
+
+    for (i = 0; i < length; i++) {
+        hash = (hash ^ bytes[i]) * 16777619U;
+    }
+    return hash & 0xffffffffU;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  AppendNumber()
+ *  AppendString()
+ *
+ *  Append a number or a string in the encoding of an index file.
+ * ------------------------------------------------------------------------
+ */
+static void
+AppendNumber(
+    Tcl_DString *dsPtr,
+    unsigned int value)
+{
+    char bytes[4];
+
+    bytes[0] = (char)((value >> 24) & 0xff);
+    bytes[1] = (char)((value >> 16) & 0xff);
+    bytes[2] = (char)((value >> 8) & 0xff);
+    bytes[3] = (char)(value & 0xff);
+    Tcl_DStringAppend(dsPtr, bytes, 4);
+}
+
+static void
+AppendString(
+    Tcl_DString *dsPtr,
+    Tcl_Obj *objPtr)
+{
+    const char *str;
+    int length;
+
+    str = Tcl_GetStringFromObj(objPtr, &length);
+    AppendNumber(dsPtr, (unsigned int)length);
+    Tcl_DStringAppend(dsPtr, str, length);
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ReadNumber()
+ *  ReadString()
+ *
+ *  Read a number or a string of an index file at *posPtr and advance
+ *  it.  Return 0 if the data ends early.
+ * ------------------------------------------------------------------------
+ */
+static int
+ReadNumber(
+    const unsigned char *bytes,
+    int length,
+    int *posPtr,
+    unsigned int *valuePtr)
+{
+    const unsigned char *p;
+
+    if (length - *posPtr < 4) {
+        return 0;
+    }
+    p = bytes + *posPtr;
+    *valuePtr = ((unsigned int)p[0] << 24) | ((unsigned int)p[1] << 16)
+            | ((unsigned int)p[2] << 8) | (unsigned int)p[3];
+    *posPtr += 4;
+    return 1;
+}
+
+static int
+ReadString(
+    const unsigned char *bytes,
+    int length,
+    int *posPtr,
+    Tcl_Obj **objPtrPtr)
+{
+    unsigned int size;
+
+    if (!ReadNumber(bytes, length, posPtr, &size)
+            || (size > (unsigned int)(length - *posPtr))) {
+        return 0;
+    }
+    *objPtrPtr = Tcl_NewStringObj((const char *)bytes + *posPtr, (int)size);
+    *posPtr += (int)size;
+    return 1;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  DirName()
+ *
+ *  Returns the directory part of a normalized path as a new object with
+ *  a reference count of 1.
+ * ------------------------------------------------------------------------
+ */
+static Tcl_Obj *
+DirName(
+    Tcl_Obj *pathPtr)
+{
+    Tcl_Obj *partsPtr;
+    Tcl_Obj *dirPtr;
+    int numParts;
+
+    partsPtr = Tcl_FSSplitPath(pathPtr, &numParts);
+    Tcl_IncrRefCount(partsPtr);
+    dirPtr = Tcl_FSJoinPath(partsPtr, (numParts > 1) ? numParts - 1 : 1);
+    Tcl_IncrRefCount(dirPtr);
+    Tcl_DecrRefCount(partsPtr);
+    return dirPtr;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ReadFileBytes()
+ *
+ *  Reads the contents of a file unchanged.  Returns a new byte array
+ *  object with a reference count of 0, or NULL along with an error
+ *  message in the interpreter, if there is one.
+ * ------------------------------------------------------------------------
+ */
+static Tcl_Obj *
+ReadFileBytes(
+    Tcl_Interp *interp,
+    Tcl_Obj *pathPtr)
+{
+    Tcl_Channel chan;
+    Tcl_Obj *contentPtr;
+
+    chan = Tcl_FSOpenFileChannel(interp, pathPtr, "r", 0);
+    if (chan == NULL) {
+        return NULL;
+    }
+    Tcl_SetChannelOption(NULL, chan, "-translation", "binary");
+    contentPtr = Tcl_NewObj();
+    if (Tcl_ReadChars(chan, contentPtr, -1, 0) < 0) {
+        if (interp != NULL) {
+            Tcl_AppendResult(interp, "error reading \"",
+                    Tcl_GetString(pathPtr), "\": ", Tcl_PosixError(interp),
+                    NULL);
+        }
+        Tcl_DecrRefCount(contentPtr);
+        Tcl_Close(NULL, chan);
+        return NULL;
+    }
+    Tcl_Close(NULL, chan);
+    return contentPtr;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  Itcl_AutoIndexCreateCmd()
+ *
+ *  Invoked by Tcl whenever the user issues an "itcl::autoindex create"
+ *  command.  Handles the following syntax:
+ *
+ *      itcl::autoindex create <indexFile> ?<sourceFile>...?
+ *
+ *  Writes an index of the classes and member function bodies defined
+ *  in the source files, which are expected to be encoded in UTF-8.
+ *  Returns the indexed names.
+ * ------------------------------------------------------------------------
+ */
+int
+Itcl_AutoIndexCreateCmd(
+    ClientData clientData,   /* infoPtr */
+    Tcl_Interp *interp,      /* current interpreter */
+    int objc,                /* number of arguments */
+    Tcl_Obj *const objv[])   /* argument objects */
+{
+    Tcl_Obj *entriesPtr;
+    Tcl_Obj *contentPtr;
+    Tcl_Obj *dirPtr;
+    Tcl_Obj *filePtr;
+    Tcl_Obj *namesPtr;
+    Tcl_Obj **entryv;
+    Tcl_Obj **fieldv;
+    Tcl_Channel chan;
+    Tcl_DString buffer;
+    const char *dir;
+    const char *file;
+    const char *script;
+    int dirLength;
+    int entryc;
+    int fieldc;
+    int length;
+    int value;
+    int i;
+    int j;
+    (void)clientData;
+
+    ItclShowArgs(1, "Itcl_AutoIndexCreateCmd", objc, objv);
+    if (objc < 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "indexFile ?sourceFile ...?");
+        return TCL_ERROR;
+    }
+
+    /*
+     *  Source files in the directory of the index, or below it, are
+     *  recorded relative to it, so the directory can be moved.
+     */
+    filePtr = Tcl_FSGetNormalizedPath(interp, objv[1]);
+    if (filePtr == NULL) {
+        return TCL_ERROR;
+    }
+    dirPtr = DirName(filePtr);
+    dir = Tcl_GetStringFromObj(dirPtr, &dirLength);
+
+    Tcl_DStringInit(&buffer);
+    Tcl_DStringAppend(&buffer, ITCL_AUTOINDEX_MAGIC, ITCL_AUTOINDEX_MAGIC_LEN);
+    AppendNumber(&buffer, (unsigned int)(objc - 2));
+    entriesPtr = Tcl_NewListObj(0, NULL);
+    Tcl_IncrRefCount(entriesPtr);
+    for (i = 2; i < objc; i++) {
+        filePtr = Tcl_FSGetNormalizedPath(interp, objv[i]);
+        if (filePtr == NULL) {
+            goto error;
+        }
+        file = Tcl_GetStringFromObj(filePtr, &length);
+        if ((length > dirLength + 1) && (strncmp(file, dir, dirLength) == 0)
+                && (file[dirLength] == '/')) {
+            filePtr = Tcl_NewStringObj(file + dirLength + 1, -1);
+        }
+        Tcl_IncrRefCount(filePtr);
+        AppendString(&buffer, filePtr);
+        Tcl_DecrRefCount(filePtr);
+
+        contentPtr = ReadFileBytes(interp, objv[i]);
+        if (contentPtr == NULL) {
+            goto error;
+        }
+        Tcl_IncrRefCount(contentPtr);
+        script = (const char *)Tcl_GetByteArrayFromObj(contentPtr, &length);
+        AppendNumber(&buffer, (unsigned int)length);
+        AppendNumber(&buffer,
+                HashBytes((const unsigned char *)script, length));
+        IndexScript(entriesPtr, script, script, length, "::", i - 2);
+        Tcl_DecrRefCount(contentPtr);
+    }
+
+    Tcl_ListObjGetElements(NULL, entriesPtr, &entryc, &entryv);
+    AppendNumber(&buffer, (unsigned int)entryc);
+    namesPtr = Tcl_NewListObj(0, NULL);
+    for (i = 0; i < entryc; i++) {
+        Tcl_ListObjGetElements(NULL, entryv[i], &fieldc, &fieldv);
+        AppendString(&buffer, fieldv[0]);
+        AppendString(&buffer, fieldv[1]);
+        for (j = 2; j < 6; j++) {
+            Tcl_GetIntFromObj(NULL, fieldv[j], &value);
+            AppendNumber(&buffer, (unsigned int)value);
+        }
+        Tcl_ListObjAppendElement(NULL, namesPtr, fieldv[0]);
+    }
+    Tcl_DecrRefCount(entriesPtr);
+    entriesPtr = NULL;
+
+    chan = Tcl_FSOpenFileChannel(interp, objv[1], "w", 0666);
+    if (chan == NULL) {
+        Tcl_DecrRefCount(namesPtr);
+        goto error;
+    }
+    Tcl_SetChannelOption(NULL, chan, "-translation", "binary");
+    if (Tcl_Write(chan, Tcl_DStringValue(&buffer),
+            Tcl_DStringLength(&buffer)) < 0) {
+        Tcl_AppendResult(interp, "error writing \"", Tcl_GetString(objv[1]),
+                "\": ", Tcl_PosixError(interp), NULL);
+        Tcl_Close(NULL, chan);
+        Tcl_DecrRefCount(namesPtr);
+        goto error;
+    }
+    Tcl_DStringFree(&buffer);
+    Tcl_DecrRefCount(dirPtr);
+    if (Tcl_Close(interp, chan) != TCL_OK) {
+        Tcl_DecrRefCount(namesPtr);
+        return TCL_ERROR;
+    }
+    Tcl_SetObjResult(interp, namesPtr);
+    return TCL_OK;
+
+error:
+    if (entriesPtr != NULL) {
+        Tcl_DecrRefCount(entriesPtr);
+    }
+    Tcl_DStringFree(&buffer);
+    Tcl_DecrRefCount(dirPtr);
+    return TCL_ERROR;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  Itcl_AutoIndexAddCmd()
+ *
+ *  Invoked by Tcl whenever the user issues an "itcl::autoindex add"
+ *  command.  Handles the following syntax:
+ *
+ *      itcl::autoindex add <indexFile>
+ *
+ *  Reads an index file for autoloading.  Where several index files
+ *  define the same name, the one added first wins.  Adding an index
+ *  file again replaces the entries read from it before.  An index
+ *  file that turns out to be malformed is not registered.
+ * ------------------------------------------------------------------------
+ */
+int
+Itcl_AutoIndexAddCmd(
+    ClientData clientData,   /* infoPtr */
+    Tcl_Interp *interp,      /* current interpreter */
+    int objc,                /* number of arguments */
+    Tcl_Obj *const objv[])   /* argument objects */
+{
+    ItclObjectInfo *infoPtr = (ItclObjectInfo *)clientData;
+    ItclAutoIndex *indexPtr;
+    ItclAutoIndex *oldIndexPtr;
+    ItclAutoIndex **slotPtr;
+    ItclAutoIndexEntry *entryPtr;
+    Tcl_Obj *pathPtr;
+
+    ItclShowArgs(1, "Itcl_AutoIndexAddCmd", objc, objv);
+    if (objc != 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "indexFile");
+        return TCL_ERROR;
+    }
+    pathPtr = Tcl_FSGetNormalizedPath(interp, objv[1]);
+    if (pathPtr == NULL) {
+        return TCL_ERROR;
+    }
+    slotPtr = &infoPtr->autoIndexes;
+    while ((*slotPtr != NULL) && (strcmp(Tcl_GetString((*slotPtr)->pathPtr),
+            Tcl_GetString(pathPtr)) != 0)) {
+        slotPtr = &(*slotPtr)->nextPtr;
+    }
+
+    /*
+     *  An index added again takes the place of the old one, unless a
+     *  definition from it is being loaded right now.
+     */
+    oldIndexPtr = *slotPtr;
+    if (oldIndexPtr != NULL) {
+        for (entryPtr = oldIndexPtr->entriesPtr; entryPtr != NULL;
+                entryPtr = entryPtr->nextPtr) {
+            if (entryPtr->isLoading) {
+                Tcl_AppendResult(interp, "cannot replace itcl index file \"",
+                        Tcl_GetString(pathPtr), "\" while loading from it",
+                        NULL);
+                return TCL_ERROR;
+            }
+        }
+        *slotPtr = oldIndexPtr->nextPtr;
+        ForgetAutoIndex(interp, infoPtr, oldIndexPtr);
+    }
+
+    indexPtr = (ItclAutoIndex *)ckalloc(sizeof(ItclAutoIndex));
+    memset(indexPtr, 0, sizeof(ItclAutoIndex));
+    indexPtr->pathPtr = Tcl_DuplicateObj(pathPtr);
+    Tcl_IncrRefCount(indexPtr->pathPtr);
+    indexPtr->nextPtr = *slotPtr;
+    *slotPtr = indexPtr;
+    if (ReadAutoIndex(interp, infoPtr, indexPtr) != TCL_OK) {
+        *slotPtr = indexPtr->nextPtr;
+        ForgetAutoIndex(interp, infoPtr, indexPtr);
+        return TCL_ERROR;
+    }
+    for (entryPtr = indexPtr->entriesPtr; entryPtr != NULL;
+            entryPtr = entryPtr->nextPtr) {
+        if (entryPtr->kind == ITCL_AUTOINDEX_CLASS) {
+            AddToTclAutoIndex(interp, entryPtr->namePtr);
+        }
+    }
+    return TCL_OK;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  AddToTclAutoIndex()
+ *  RemoveFromTclAutoIndex()
+ *
+ *  Enter an indexed class into the Tcl "auto_index" array, under the
+ *  key that "auto_load" looks for, so that the class is loaded when
+ *  its command is first used, or remove it again.  An entry that was
+ *  changed since is left alone.
+ * ------------------------------------------------------------------------
+ */
+static const char *
+TclAutoIndexKey(
+    Tcl_Obj *namePtr)
+{
+    const char *name;
+
+    /*
+     *  Like auto_mkindex, classes in the global namespace are entered
+     *  without the leading "::".
+     */
+    name = Tcl_GetString(namePtr);
+    if (strstr(name + 2, "::") == NULL) {
+        name += 2;
+    }
+    return name;
+}
+
+static Tcl_Obj *
+TclAutoIndexScript(
+    Tcl_Obj *namePtr)
+{
+    Tcl_Obj *scriptPtr;
+
+    scriptPtr = Tcl_NewStringObj("::itcl::autoindex load", -1);
+    Tcl_ListObjAppendElement(NULL, scriptPtr, namePtr);
+    return scriptPtr;
+}
+
+static void
+AddToTclAutoIndex(
+    Tcl_Interp *interp,
+    Tcl_Obj *namePtr)
+{
+    Tcl_SetVar2Ex(interp, "::auto_index", TclAutoIndexKey(namePtr),
+            TclAutoIndexScript(namePtr), TCL_GLOBAL_ONLY);
+}
+
+static void
+RemoveFromTclAutoIndex(
+    Tcl_Interp *interp,
+    Tcl_Obj *namePtr)
+{
+    Tcl_Obj *valuePtr;
+    Tcl_Obj *scriptPtr;
+
+    valuePtr = Tcl_GetVar2Ex(interp, "::auto_index",
+            TclAutoIndexKey(namePtr), TCL_GLOBAL_ONLY);
+    if (valuePtr == NULL) {
+        return;
+    }
+    scriptPtr = TclAutoIndexScript(namePtr);
+    Tcl_IncrRefCount(scriptPtr);
+    if (strcmp(Tcl_GetString(valuePtr), Tcl_GetString(scriptPtr)) == 0) {
+        Tcl_UnsetVar2(interp, "::auto_index", TclAutoIndexKey(namePtr),
+                TCL_GLOBAL_ONLY);
+    }
+    Tcl_DecrRefCount(scriptPtr);
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  MemberClassName()
+ *
+ *  Returns the name of the class of a fully qualified member name as a
+ *  new object with a reference count of 1.
+ * ------------------------------------------------------------------------
+ */
+static Tcl_Obj *
+MemberClassName(
+    const char *name)
+{
+    const char *tail;
+    Tcl_Obj *classNamePtr;
+
+    for (tail = name + strlen(name); tail > name + 1; tail--) {
+        if ((tail[-1] == ':') && (tail[-2] == ':')) {
+            break;
+        }
+    }
+    classNamePtr = Tcl_NewStringObj(name,
+            (tail > name + 1) ? (int)(tail - name) - 2 : 0);
+    Tcl_IncrRefCount(classNamePtr);
+    return classNamePtr;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ForgetAutoIndex()
+ *
+ *  Removes the entries of an index that is no longer in the list of
+ *  registered indexes from the tables of all index entries, and from
+ *  the "auto_index" array unless interp is NULL, then frees it.
+ * ------------------------------------------------------------------------
+ */
+static void
+ForgetAutoIndex(
+    Tcl_Interp *interp,
+    ItclObjectInfo *infoPtr,
+    ItclAutoIndex *indexPtr)
+{
+    ItclAutoIndexEntry *entryPtr;
+    ItclAutoIndexEntry **memberPtrPtr;
+    Tcl_HashEntry *hPtr;
+    Tcl_Obj *classNamePtr;
+    int i;
+
+    while (indexPtr->entriesPtr != NULL) {
+        entryPtr = indexPtr->entriesPtr;
+        indexPtr->entriesPtr = entryPtr->nextPtr;
+        if ((infoPtr->autoIndexEntriesPtr != NULL)
+                && (entryPtr->kind != ITCL_AUTOINDEX_CONFIGBODY)) {
+            hPtr = Tcl_FindHashEntry(infoPtr->autoIndexEntriesPtr,
+                    (char *)entryPtr->namePtr);
+            if ((hPtr != NULL) && (Tcl_GetHashValue(hPtr) == entryPtr)) {
+                Tcl_DeleteHashEntry(hPtr);
+            }
+            if ((interp != NULL) && (entryPtr->kind == ITCL_AUTOINDEX_CLASS)) {
+                RemoveFromTclAutoIndex(interp, entryPtr->namePtr);
+            }
+        }
+        if ((infoPtr->autoIndexMembersPtr != NULL)
+                && (entryPtr->kind != ITCL_AUTOINDEX_CLASS)) {
+            classNamePtr = MemberClassName(Tcl_GetString(entryPtr->namePtr));
+            hPtr = Tcl_FindHashEntry(infoPtr->autoIndexMembersPtr,
+                    (char *)classNamePtr);
+            Tcl_DecrRefCount(classNamePtr);
+            if (hPtr != NULL) {
+                memberPtrPtr = (ItclAutoIndexEntry **)&Tcl_GetHashValue(hPtr);
+                while ((*memberPtrPtr != NULL) && (*memberPtrPtr != entryPtr)) {
+                    memberPtrPtr = &(*memberPtrPtr)->nextMemberPtr;
+                }
+                if (*memberPtrPtr != NULL) {
+                    *memberPtrPtr = entryPtr->nextMemberPtr;
+                }
+                if (Tcl_GetHashValue(hPtr) == NULL) {
+                    Tcl_DeleteHashEntry(hPtr);
+                }
+            }
+        }
+        Tcl_DecrRefCount(entryPtr->namePtr);
+        Tcl_DecrRefCount(entryPtr->nsNamePtr);
+        ckfree((char *)entryPtr);
+    }
+    for (i = 0; i < indexPtr->numFiles; i++) {
+        Tcl_DecrRefCount(indexPtr->files[i].pathPtr);
+    }
+    if (indexPtr->files != NULL) {
+        ckfree((char *)indexPtr->files);
+    }
+    Tcl_DecrRefCount(indexPtr->pathPtr);
+    ckfree((char *)indexPtr);
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ReadAutoIndex()
+ *
+ *  Reads the entries of an index file into the table of all index
+ *  entries.  An entry for a name that is already known is ignored.
+ *  Bodies and configbodies are also listed under their class, a
+ *  configbody only there, its name may be that of a method.  Entries
+ *  must lie within the recorded size of their file.  On error, the
+ *  entries read so far stay in indexPtr for ForgetAutoIndex().
+ * ------------------------------------------------------------------------
+ */
+static int
+ReadAutoIndex(
+    Tcl_Interp *interp,
+    ItclObjectInfo *infoPtr,
+    ItclAutoIndex *indexPtr)
+{
+    ItclAutoIndexEntry *entryPtr;
+    ItclAutoIndexEntry **entryPtrPtr;
+    ItclAutoIndexEntry **memberPtrPtr;
+    Tcl_HashEntry *hPtr;
+    Tcl_Obj *contentPtr;
+    Tcl_Obj *dirPtr;
+    Tcl_Obj *classNamePtr;
+    Tcl_Obj *namePtr;
+    Tcl_Obj *nsNamePtr;
+    ItclAutoIndexFile *filePtr;
+    const unsigned char *bytes;
+    const char *name;
+    unsigned int numFiles;
+    unsigned int numEntries;
+    unsigned int values[4];
+    unsigned int i;
+    int length;
+    int pos;
+    int isNew;
+    int j;
+
+    contentPtr = ReadFileBytes(interp, indexPtr->pathPtr);
+    if (contentPtr == NULL) {
+        return TCL_ERROR;
+    }
+    Tcl_IncrRefCount(contentPtr);
+    bytes = Tcl_GetByteArrayFromObj(contentPtr, &length);
+    pos = ITCL_AUTOINDEX_MAGIC_LEN;
+    if ((length < pos) || (memcmp(bytes, ITCL_AUTOINDEX_MAGIC, pos) != 0)
+            || !ReadNumber(bytes, length, &pos, &numFiles)
+            || (numFiles > (unsigned int)(length - pos) / 12)) {
+        goto malformed;
+    }
+
+    dirPtr = DirName(indexPtr->pathPtr);
+    indexPtr->files = (ItclAutoIndexFile *)ckalloc((numFiles + 1)
+            * sizeof(ItclAutoIndexFile));
+    for (i = 0; i < numFiles; i++) {
+        if (!ReadString(bytes, length, &pos, &namePtr)) {
+            Tcl_DecrRefCount(dirPtr);
+            goto malformed;
+        }
+        Tcl_IncrRefCount(namePtr);
+        filePtr = &indexPtr->files[i];
+        filePtr->pathPtr = Tcl_FSJoinToPath(dirPtr, 1, &namePtr);
+        Tcl_IncrRefCount(filePtr->pathPtr);
+        Tcl_DecrRefCount(namePtr);
+        filePtr->state = ITCL_AUTOINDEX_UNCHECKED;
+        indexPtr->numFiles++;
+        if (!ReadNumber(bytes, length, &pos, &filePtr->size)
+                || !ReadNumber(bytes, length, &pos, &filePtr->hash)
+                || (filePtr->size > INT_MAX)) {
+            Tcl_DecrRefCount(dirPtr);
+            goto malformed;
+        }
+    }
+    Tcl_DecrRefCount(dirPtr);
+
+    if (infoPtr->autoIndexEntriesPtr == NULL) {
+        infoPtr->autoIndexEntriesPtr =
+                (Tcl_HashTable *)ckalloc(sizeof(Tcl_HashTable));
+        Tcl_InitObjHashTable(infoPtr->autoIndexEntriesPtr);
+        infoPtr->autoIndexMembersPtr =
+                (Tcl_HashTable *)ckalloc(sizeof(Tcl_HashTable));
+        Tcl_InitObjHashTable(infoPtr->autoIndexMembersPtr);
+    }
+    entryPtrPtr = &indexPtr->entriesPtr;
+    if (!ReadNumber(bytes, length, &pos, &numEntries)) {
+        goto malformed;
+    }
+    for (i = 0; i < numEntries; i++) {
+        if (!ReadString(bytes, length, &pos, &namePtr)) {
+            goto malformed;
+        }
+        Tcl_IncrRefCount(namePtr);
+        if (!ReadString(bytes, length, &pos, &nsNamePtr)) {
+            Tcl_DecrRefCount(namePtr);
+            goto malformed;
+        }
+        for (j = 0; j < 4; j++) {
+            if (!ReadNumber(bytes, length, &pos, &values[j])) {
+                break;
+            }
+        }
+        if ((j < 4) || (values[0] > ITCL_AUTOINDEX_CONFIGBODY)
+                || (values[1] >= numFiles)
+                || (values[3] > indexPtr->files[values[1]].size)
+                || (values[2] > indexPtr->files[values[1]].size - values[3])) {
+            Tcl_DecrRefCount(namePtr);
+            Tcl_DecrRefCount(nsNamePtr);
+            goto malformed;
+        }
+        isNew = 1;
+        if (values[0] != ITCL_AUTOINDEX_CONFIGBODY) {
+            hPtr = Tcl_CreateHashEntry(infoPtr->autoIndexEntriesPtr,
+                    (char *)namePtr, &isNew);
+        }
+        memberPtrPtr = NULL;
+        if (isNew && (values[0] != ITCL_AUTOINDEX_CLASS)) {
+            name = Tcl_GetString(namePtr);
+            classNamePtr = MemberClassName(name);
+            hPtr = Tcl_CreateHashEntry(infoPtr->autoIndexMembersPtr,
+                    (char *)classNamePtr, &isNew);
+            Tcl_DecrRefCount(classNamePtr);
+            if (isNew) {
+                Tcl_SetHashValue(hPtr, NULL);
+            }
+            isNew = 1;
+            memberPtrPtr = (ItclAutoIndexEntry **)&Tcl_GetHashValue(hPtr);
+            while (*memberPtrPtr != NULL) {
+                if (((*memberPtrPtr)->kind == (int)values[0])
+                        && (strcmp(Tcl_GetString((*memberPtrPtr)->namePtr),
+                        name) == 0)) {
+                    isNew = 0;
+                    break;
+                }
+                memberPtrPtr = &(*memberPtrPtr)->nextMemberPtr;
+            }
+        }
+        if (isNew) {
+            entryPtr = (ItclAutoIndexEntry *)ckalloc(
+                    sizeof(ItclAutoIndexEntry));
+            entryPtr->namePtr = namePtr;
+            Tcl_IncrRefCount(entryPtr->namePtr);
+            entryPtr->kind = (int)values[0];
+            entryPtr->indexPtr = indexPtr;
+            entryPtr->fileNum = (int)values[1];
+            entryPtr->nsNamePtr = nsNamePtr;
+            Tcl_IncrRefCount(entryPtr->nsNamePtr);
+            entryPtr->offset = values[2];
+            entryPtr->length = values[3];
+            entryPtr->isLoading = 0;
+            entryPtr->nextPtr = NULL;
+            entryPtr->nextMemberPtr = NULL;
+            *entryPtrPtr = entryPtr;
+            entryPtrPtr = &entryPtr->nextPtr;
+            if (entryPtr->kind != ITCL_AUTOINDEX_CONFIGBODY) {
+                hPtr = Tcl_FindHashEntry(infoPtr->autoIndexEntriesPtr,
+                        (char *)namePtr);
+                Tcl_SetHashValue(hPtr, entryPtr);
+            }
+            if (memberPtrPtr != NULL) {
+                *memberPtrPtr = entryPtr;
+            }
+        } else {
+            Tcl_DecrRefCount(nsNamePtr);
+        }
+        Tcl_DecrRefCount(namePtr);
+    }
+    Tcl_DecrRefCount(contentPtr);
+    return TCL_OK;
+
+malformed:
+    Tcl_DecrRefCount(contentPtr);
+    Tcl_AppendResult(interp, "malformed itcl index file \"",
+            Tcl_GetString(indexPtr->pathPtr), "\"", NULL);
+    return TCL_ERROR;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  CheckSourceFile()
+ *
+ *  Compares a source file with the size and hash recorded in the index
+ *  and returns 1 if it matches.  The file is only read again once its
+ *  size or modification time differs from the last check.
+ * ------------------------------------------------------------------------
+ */
+static int
+CheckSourceFile(
+    ItclAutoIndexFile *filePtr)
+{
+    Tcl_StatBuf *statBufPtr;
+    Tcl_Obj *contentPtr;
+    const unsigned char *bytes;
+    Tcl_WideUInt size;
+    Tcl_WideInt mtime;
+    int length;
+    int isSame;
+
+    statBufPtr = Tcl_AllocStatBuf();
+    if (Tcl_FSStat(filePtr->pathPtr, statBufPtr) != 0) {
+        ckfree((char *)statBufPtr);
+        if (filePtr->state != ITCL_AUTOINDEX_SOURCED) {
+            filePtr->state = ITCL_AUTOINDEX_CHANGED;
+        }
+        return 0;
+    }
+    size = Tcl_GetSizeFromStat(statBufPtr);
+    mtime = Tcl_GetModificationTimeFromStat(statBufPtr);
+    ckfree((char *)statBufPtr);
+    if ((filePtr->state != ITCL_AUTOINDEX_UNCHECKED)
+            && (size == filePtr->statSize) && (mtime == filePtr->statMtime)) {
+        return (filePtr->state == ITCL_AUTOINDEX_SAME);
+    }
+
+    isSame = 0;
+    if (size == filePtr->size) {
+        contentPtr = ReadFileBytes(NULL, filePtr->pathPtr);
+        if (contentPtr != NULL) {
+            Tcl_IncrRefCount(contentPtr);
+            bytes = Tcl_GetByteArrayFromObj(contentPtr, &length);
+            isSame = ((unsigned int)length == filePtr->size)
+                    && (HashBytes(bytes, length) == filePtr->hash);
+            Tcl_DecrRefCount(contentPtr);
+        }
+    }
+    filePtr->state = isSame ? ITCL_AUTOINDEX_SAME : ITCL_AUTOINDEX_CHANGED;
+    filePtr->statSize = size;
+    filePtr->statMtime = mtime;
+    return isSame;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  LoadAutoIndexEntry()
+ *
+ *  Reads the text of one indexed definition from its source file and
+ *  evaluates it in the namespace it was found in.  If the file changed
+ *  since the index was written, the whole file is sourced in the global
+ *  namespace instead, once.
+ * ------------------------------------------------------------------------
+ */
+static int
+LoadAutoIndexEntry(
+    Tcl_Interp *interp,
+    ItclAutoIndexEntry *entryPtr)
+{
+    ItclAutoIndexFile *filePtr;
+    Tcl_Channel chan;
+    Tcl_Encoding encoding;
+    Tcl_Namespace *nsPtr;
+    Tcl_CallFrame frame;
+    Tcl_DString bytes;
+    Tcl_DString script;
+    Tcl_Obj *pathPtr;
+    int result;
+
+    filePtr = &entryPtr->indexPtr->files[entryPtr->fileNum];
+    pathPtr = filePtr->pathPtr;
+    if (!CheckSourceFile(filePtr)) {
+        if (filePtr->state == ITCL_AUTOINDEX_SOURCED) {
+            return TCL_OK;
+        }
+        filePtr->state = ITCL_AUTOINDEX_SOURCED;
+        result = Itcl_PushCallFrame(interp, &frame,
+                Tcl_GetGlobalNamespace(interp), /*isProcCallFrame*/ 0);
+        if (result == TCL_OK) {
+            result = Tcl_FSEvalFile(interp, pathPtr);
+            Itcl_PopCallFrame(interp);
+        }
+        return result;
+    }
+    chan = Tcl_FSOpenFileChannel(interp, pathPtr, "r", 0);
+    if (chan == NULL) {
+        return TCL_ERROR;
+    }
+    Tcl_SetChannelOption(NULL, chan, "-translation", "binary");
+    Tcl_DStringInit(&bytes);
+    Tcl_DStringSetLength(&bytes, (int)entryPtr->length);
+    if ((Tcl_Seek(chan, (Tcl_WideInt)entryPtr->offset, SEEK_SET) < 0)
+            || (Tcl_Read(chan, Tcl_DStringValue(&bytes),
+            (int)entryPtr->length) != (int)entryPtr->length)) {
+        Tcl_AppendResult(interp, "error reading \"", Tcl_GetString(pathPtr),
+                "\": ", Tcl_PosixError(interp), NULL);
+        Tcl_Close(NULL, chan);
+        Tcl_DStringFree(&bytes);
+        return TCL_ERROR;
+    }
+    Tcl_Close(NULL, chan);
+
+    /*
+     *  Definitions inside "namespace eval" are evaluated in that
+     *  namespace, it may not exist yet.
+     */
+    nsPtr = Tcl_FindNamespace(interp, Tcl_GetString(entryPtr->nsNamePtr),
+            NULL, 0);
+    if (nsPtr == NULL) {
+        nsPtr = Tcl_CreateNamespace(interp,
+                Tcl_GetString(entryPtr->nsNamePtr), NULL, NULL);
+        if (nsPtr == NULL) {
+            Tcl_DStringFree(&bytes);
+            return TCL_ERROR;
+        }
+    }
+    encoding = Tcl_GetEncoding(NULL, "utf-8");
+    Tcl_ExternalToUtfDString(encoding, Tcl_DStringValue(&bytes),
+            Tcl_DStringLength(&bytes), &script);
+    Tcl_FreeEncoding(encoding);
+    Tcl_DStringFree(&bytes);
+    result = Itcl_PushCallFrame(interp, &frame, nsPtr, /*isProcCallFrame*/ 0);
+    if (result == TCL_OK) {
+        result = Tcl_EvalEx(interp, Tcl_DStringValue(&script),
+                Tcl_DStringLength(&script), 0);
+        Itcl_PopCallFrame(interp);
+    }
+    Tcl_DStringFree(&script);
+    return result;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  LoadIndexed()
+ *
+ *  Loads the definition of a fully qualified name from the index files
+ *  unless it is being loaded already.  A class is loaded together with
+ *  its indexed bodies and configbodies, as if its file was sourced.
+ *  Sets *loadedPtr to 1 if it was loaded.
+ * ------------------------------------------------------------------------
+ */
+static int
+LoadIndexed(
+    Tcl_Interp *interp,
+    ItclObjectInfo *infoPtr,
+    const char *name,
+    int length,
+    int *loadedPtr)
+{
+    ItclAutoIndexEntry *entryPtr;
+    ItclAutoIndexEntry *memberPtr;
+    Tcl_HashEntry *hPtr;
+    Tcl_Obj *namePtr;
+    int result;
+
+    *loadedPtr = 0;
+    if (infoPtr->autoIndexEntriesPtr == NULL) {
+        return TCL_OK;
+    }
+    namePtr = Tcl_NewStringObj(name, length);
+    Tcl_IncrRefCount(namePtr);
+    hPtr = Tcl_FindHashEntry(infoPtr->autoIndexEntriesPtr, (char *)namePtr);
+    if ((hPtr == NULL)
+            || ((ItclAutoIndexEntry *)Tcl_GetHashValue(hPtr))->isLoading) {
+        Tcl_DecrRefCount(namePtr);
+        return TCL_OK;
+    }
+    entryPtr = (ItclAutoIndexEntry *)Tcl_GetHashValue(hPtr);
+    entryPtr->isLoading = 1;
+    *loadedPtr = 1;
+    result = LoadAutoIndexEntry(interp, entryPtr);
+    if ((result == TCL_OK) && (entryPtr->kind == ITCL_AUTOINDEX_CLASS)) {
+        hPtr = Tcl_FindHashEntry(infoPtr->autoIndexMembersPtr,
+                (char *)namePtr);
+        memberPtr = (hPtr == NULL) ? NULL
+                : (ItclAutoIndexEntry *)Tcl_GetHashValue(hPtr);
+        for ( ; (memberPtr != NULL) && (result == TCL_OK);
+                memberPtr = memberPtr->nextMemberPtr) {
+            if (!memberPtr->isLoading) {
+                memberPtr->isLoading = 1;
+                result = LoadAutoIndexEntry(interp, memberPtr);
+                memberPtr->isLoading = 0;
+            }
+        }
+    }
+    entryPtr->isLoading = 0;
+    Tcl_DecrRefCount(namePtr);
+    return result;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  Itcl_AutoIndexLoadCmd()
+ *
+ *  Invoked by Tcl whenever the user issues an "itcl::autoindex load"
+ *  command.  Handles the following syntax:
+ *
+ *      itcl::autoindex load <fullName>
+ *
+ *  Loads the indexed definition of a class or member function body.
+ *  This is what the "auto_index" entries for classes invoke.  Returns
+ *  1 if the definition was loaded, and 0 otherwise.
+ * ------------------------------------------------------------------------
+ */
+int
+Itcl_AutoIndexLoadCmd(
+    ClientData clientData,   /* infoPtr */
+    Tcl_Interp *interp,      /* current interpreter */
+    int objc,                /* number of arguments */
+    Tcl_Obj *const objv[])   /* argument objects */
+{
+    ItclObjectInfo *infoPtr = (ItclObjectInfo *)clientData;
+    const char *name;
+    int length;
+    int loaded;
+
+    ItclShowArgs(1, "Itcl_AutoIndexLoadCmd", objc, objv);
+    if (objc != 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "fullName");
+        return TCL_ERROR;
+    }
+    name = Tcl_GetStringFromObj(objv[1], &length);
+    if (LoadIndexed(interp, infoPtr, name, length, &loaded) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    Tcl_SetObjResult(interp, Tcl_NewBooleanObj(loaded));
+    return TCL_OK;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclAutoload()
+ *
+ *  Autoloads the class or member function body with the given name.
+ *  The index files are consulted first, names not found there are
+ *  handed to the Tcl "auto_load" procedure.  Returns TCL_ERROR along
+ *  with an error message if loading fails, otherwise TCL_OK, whether
+ *  or not the name was found.
+ * ------------------------------------------------------------------------
+ */
+int
+ItclAutoload(
+    Tcl_Interp *interp,
+    const char *name)
+{
+    ItclObjectInfo *infoPtr;
+    Tcl_Namespace *nsPtr;
+    Tcl_DString buffer;
+    Tcl_Obj *objv[2];
+    int loaded;
+    int result;
+
+    infoPtr = (ItclObjectInfo *)Tcl_GetAssocData(interp,
+            ITCL_INTERP_DATA, NULL);
+    if (infoPtr->autoIndexEntriesPtr != NULL) {
+        /*
+         *  Relative names are sought in the current namespace and
+         *  then in the global one, as for Itcl_FindClassNamespace.
+         */
+        loaded = 0;
+        Tcl_DStringInit(&buffer);
+        if ((name[0] != ':') || (name[1] != ':')) {
+            nsPtr = Tcl_GetCurrentNamespace(interp);
+            if (nsPtr->parentPtr != NULL) {
+                Tcl_DStringAppend(&buffer, nsPtr->fullName, -1);
+                Tcl_DStringAppend(&buffer, "::", 2);
+                Tcl_DStringAppend(&buffer, name, -1);
+                result = LoadIndexed(interp, infoPtr,
+                        Tcl_DStringValue(&buffer),
+                        Tcl_DStringLength(&buffer), &loaded);
+                if ((result != TCL_OK) || loaded) {
+                    Tcl_DStringFree(&buffer);
+                    return result;
+                }
+                Tcl_DStringSetLength(&buffer, 0);
+            }
+            Tcl_DStringAppend(&buffer, "::", 2);
+        }
+        Tcl_DStringAppend(&buffer, name, -1);
+        result = LoadIndexed(interp, infoPtr, Tcl_DStringValue(&buffer),
+                Tcl_DStringLength(&buffer), &loaded);
+        Tcl_DStringFree(&buffer);
+        if ((result != TCL_OK) || loaded) {
+            return result;
+        }
+    }
+
+    objv[0] = Tcl_NewStringObj("::auto_load", -1);
+    objv[1] = Tcl_NewStringObj(name, -1);
+    Tcl_IncrRefCount(objv[0]);
+    Tcl_IncrRefCount(objv[1]);
+    result = Tcl_EvalObjv(interp, 2, objv, 0);
+    Tcl_DecrRefCount(objv[0]);
+    Tcl_DecrRefCount(objv[1]);
+    return result;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclDeleteAutoIndexes()
+ *
+ *  Frees the registered index files and their entries.  Called when
+ *  the interpreter is deleted.
+ * ------------------------------------------------------------------------
+ */
+void
+ItclDeleteAutoIndexes(
+    ItclObjectInfo *infoPtr)
+{
+    ItclAutoIndex *indexPtr;
+
+    if (infoPtr->autoIndexEntriesPtr != NULL) {
+        Tcl_DeleteHashTable(infoPtr->autoIndexEntriesPtr);
+        ckfree((char *)infoPtr->autoIndexEntriesPtr);
+        infoPtr->autoIndexEntriesPtr = NULL;
+        Tcl_DeleteHashTable(infoPtr->autoIndexMembersPtr);
+        ckfree((char *)infoPtr->autoIndexMembersPtr);
+        infoPtr->autoIndexMembersPtr = NULL;
+    }
+    while (infoPtr->autoIndexes != NULL) {
+        indexPtr = infoPtr->autoIndexes;
+        infoPtr->autoIndexes = indexPtr->nextPtr;
+        ForgetAutoIndex(NULL, infoPtr, indexPtr);
+    }
+}
@@ -21,6 +21,14 @@ MODULE_SCOPE const ItclStubs itclStubs;
 
 static int Initialize(Tcl_Interp *interp);
 
+/*
+ *  Counts the interpreters Itcl was initialized in, so that each
+ *  ItclObjectInfo gets a number that is not reused even when its
+ *  address is, see ItclObjectInfo.interpEpoch.
+ */
+static unsigned int interpEpochs = 0;
+TCL_DECLARE_MUTEX(interpEpochMutex)
+
 static const char initScript[] =
 "namespace eval ::itcl {\n"
 "    proc _find_init {} {\n"
@@ -216,6 +224,9 @@ Initialize (
      *  it to the itcl namespace for ownership.
      */
     infoPtr->interp = interp;
+    Tcl_MutexLock(&interpEpochMutex);
+    infoPtr->interpEpoch = ++interpEpochs;
+    Tcl_MutexUnlock(&interpEpochMutex);
     infoPtr->class_meta_type = (Tcl_ObjectMetadataType *)ckalloc(
             sizeof(Tcl_ObjectMetadataType));
     infoPtr->class_meta_type->version = TCL_OO_METADATA_VERSION_CURRENT;
@@ -232,7 +243,6 @@ Initialize (
     Tcl_InitHashTable(&infoPtr->namespaceClasses, TCL_ONE_WORD_KEYS);
     Tcl_InitHashTable(&infoPtr->procMethods, TCL_ONE_WORD_KEYS);
     Tcl_InitHashTable(&infoPtr->instances, TCL_STRING_KEYS);
-    Tcl_InitHashTable(&infoPtr->frameContext, TCL_ONE_WORD_KEYS);
     Tcl_InitObjHashTable(&infoPtr->classTypes);
 
     infoPtr->ensembleInfo = (EnsembleInfo *)ckalloc(sizeof(EnsembleInfo));
@@ -249,6 +259,8 @@ Initialize (
 
     Tcl_SetVar2(interp, ITCL_NAMESPACE"::internal::dicts::classes", NULL, "", 0);
     Tcl_SetVar2(interp, ITCL_NAMESPACE"::internal::dicts::objects", NULL, "", 0);
+    Tcl_TraceVar2(interp, ITCL_NAMESPACE"::internal::dicts::objects", NULL,
+            TCL_TRACE_READS, ItclObjectsDictTrace, infoPtr);
     Tcl_SetVar2(interp, ITCL_NAMESPACE"::internal::dicts::classOptions", NULL, "", 0);
     Tcl_SetVar2(interp,
             ITCL_NAMESPACE"::internal::dicts::classDelegatedOptions", NULL, "", 0);
@@ -285,6 +297,14 @@ Initialize (
     }
     infoPtr->useOldResolvers = opt;
     Itcl_InitStack(&infoPtr->clsStack);
+    Itcl_InitStack(&infoPtr->freeClassIds);
+    Tcl_InitObjHashTable(&infoPtr->emptyObjectTable);
+    infoPtr->optionsVarNamePtr = Tcl_NewStringObj("itcl_options", -1);
+    Tcl_IncrRefCount(infoPtr->optionsVarNamePtr);
+    infoPtr->namespaceWordPtr = Tcl_NewStringObj("namespace", -1);
+    Tcl_IncrRefCount(infoPtr->namespaceWordPtr);
+    infoPtr->inscopeWordPtr = Tcl_NewStringObj("inscope", -1);
+    Tcl_IncrRefCount(infoPtr->inscopeWordPtr);
 
     Tcl_SetAssocData(interp, ITCL_INTERP_DATA, NULL, infoPtr);
 
@@ -561,6 +581,8 @@ FreeItclObjectInfo(
 {
     ItclObjectInfo *infoPtr = (ItclObjectInfo *)clientData;
 
+    Tcl_UntraceVar2(infoPtr->interp, ITCL_NAMESPACE"::internal::dicts::objects",
+            NULL, TCL_TRACE_READS, ItclObjectsDictTrace, infoPtr);
     Tcl_DeleteHashTable(&infoPtr->instances);
     Tcl_DeleteHashTable(&infoPtr->classTypes);
     Tcl_DeleteHashTable(&infoPtr->procMethods);
@@ -568,6 +590,8 @@ FreeItclObjectInfo(
     Tcl_DeleteHashTable(&infoPtr->classes);
     Tcl_DeleteHashTable(&infoPtr->nameClasses);
     Tcl_DeleteHashTable(&infoPtr->namespaceClasses);
+    ItclDeleteAutoIndexes(infoPtr);
+    ItclDeleteProfile(infoPtr);
 
     assert (infoPtr->infoVarsPtr == NULL);
     assert (infoPtr->infoVars4Ptr == NULL);
@@ -102,7 +102,10 @@ static Tcl_ObjCmdProc Itcl_BiInitOptionsCmd;
  *  FORWARD DECLARATIONS
  */
 static Tcl_Obj* ItclReportPublicOpt(Tcl_Interp *interp,
-    ItclVariable *ivPtr, ItclObject *contextIoPtr);
+    ItclConfigVar *icvPtr, ItclObject *contextIoPtr);
+static Tcl_Var PublicVar(ItclObject *contextIoPtr, ItclVariable *ivPtr);
+static Tcl_Obj* PublicVarValue(Tcl_Interp *interp, ItclObject *contextIoPtr,
+    ItclVariable *ivPtr);
 
 static Tcl_ObjCmdProc ItclBiClassUnknownCmd;
 /*
@@ -579,18 +582,18 @@ Itcl_BiConfigureCmd(
     ItclObject *contextIoPtr;
 
     Tcl_Obj *resultPtr;
-    Tcl_Obj *objPtr;
+    Tcl_Obj *lastValuePtr;
     Tcl_DString buffer;
     Tcl_DString buffer2;
-    Tcl_HashSearch place;
     Tcl_HashEntry *hPtr;
     Tcl_Namespace *saveNsPtr;
     Tcl_Obj * const *unparsedObjv;
-    ItclClass *iclsPtr;
+    Tcl_Var varPtr;
+    ItclConfigTable *tablePtr;
+    ItclConfigVar *icvPtr;
     ItclVariable *ivPtr;
     ItclVarLookup *vlookup;
     ItclMemberCode *mcode;
-    ItclHierIter hier;
     ItclObjectInfo *infoPtr;
     const char *lastval;
     const char *token;
@@ -601,9 +604,9 @@ Itcl_BiConfigureCmd(
     (void)dummy;
 
     ItclShowArgs(1, "Itcl_BiConfigureCmd", objc, objv);
-    vlookup = NULL;
     token = NULL;
     hPtr = NULL;
+    lastValuePtr = NULL;
     unparsedObjc = objc;
     unparsedObjv = objv;
     Tcl_DStringInit(&buffer);
@@ -657,21 +660,12 @@ Itcl_BiConfigureCmd(
     if (unparsedObjc == 1) {
         resultPtr = Tcl_NewListObj(0, NULL);
 
-        Itcl_InitHierIter(&hier, contextIclsPtr);
-        while ((iclsPtr=Itcl_AdvanceHierIter(&hier)) != NULL) {
-            hPtr = Tcl_FirstHashEntry(&iclsPtr->variables, &place);
-            while (hPtr) {
-                ivPtr = (ItclVariable*)Tcl_GetHashValue(hPtr);
-                if (ivPtr->protection == ITCL_PUBLIC) {
-                    objPtr = ItclReportPublicOpt(interp, ivPtr, contextIoPtr);
-
-                    Tcl_ListObjAppendElement(NULL, resultPtr,
-                        objPtr);
-                }
-                hPtr = Tcl_NextHashEntry(&place);
-            }
+        tablePtr = ItclGetConfigTable(contextIclsPtr);
+        for (i = 0; i < tablePtr->numVars; i++) {
+            Tcl_ListObjAppendElement(NULL, resultPtr,
+                ItclReportPublicOpt(interp, &tablePtr->vars[i],
+                contextIoPtr));
         }
-        Itcl_DeleteHierIter(&hier);
 
         Tcl_SetObjResult(interp, resultPtr);
         return TCL_OK;
@@ -690,23 +684,14 @@ Itcl_BiConfigureCmd(
                 return TCL_ERROR;
             }
 
-            vlookup = NULL;
-            hPtr = ItclResolveVarEntry(contextIclsPtr, token+1);
-            if (hPtr) {
-                vlookup = (ItclVarLookup*)Tcl_GetHashValue(hPtr);
-
-                if (vlookup->ivPtr->protection != ITCL_PUBLIC) {
-                    vlookup = NULL;
-                }
-            }
-            if (!vlookup) {
+            icvPtr = ItclResolveConfigVar(contextIclsPtr, token);
+            if (!icvPtr) {
                 Tcl_AppendStringsToObj(Tcl_GetObjResult(interp),
                     "unknown option \"", token, "\"",
                     NULL);
                 return TCL_ERROR;
             }
-            resultPtr = ItclReportPublicOpt(interp,
-	            vlookup->ivPtr, contextIoPtr);
+            resultPtr = ItclReportPublicOpt(interp, icvPtr, contextIoPtr);
             Tcl_SetObjResult(interp, resultPtr);
             return TCL_OK;
         }
@@ -729,19 +714,23 @@ Itcl_BiConfigureCmd(
 	    result = TCL_ERROR;
             goto configureDone;
 	}
-        vlookup = NULL;
+        ivPtr = NULL;
         token = Tcl_GetString(unparsedObjv[i]);
         if (*token == '-') {
-            hPtr = ItclResolveVarEntry(contextIclsPtr, token+1);
-            if (hPtr == NULL) {
+            icvPtr = ItclResolveConfigVar(contextIclsPtr, token);
+            if (icvPtr != NULL) {
+                ivPtr = icvPtr->ivPtr;
+            } else if (ItclResolveVarEntry(contextIclsPtr, token+1) == NULL) {
+                /* a variable whose name starts with "-" */
                 hPtr = ItclResolveVarEntry(contextIclsPtr, token);
-	    }
-            if (hPtr) {
-                vlookup = (ItclVarLookup*)Tcl_GetHashValue(hPtr);
+                if (hPtr) {
+                    vlookup = (ItclVarLookup*)Tcl_GetHashValue(hPtr);
+                    ivPtr = vlookup->ivPtr;
+                }
             }
         }
 
-        if (!vlookup || (vlookup->ivPtr->protection != ITCL_PUBLIC)) {
+        if (!ivPtr || (ivPtr->protection != ITCL_PUBLIC)) {
             Tcl_AppendResult(interp, "unknown option \"", token, "\"",
                 NULL);
             result = TCL_ERROR;
@@ -754,30 +743,48 @@ Itcl_BiConfigureCmd(
             goto configureDone;
         }
 
-        ivPtr = vlookup->ivPtr;
-        Tcl_DStringSetLength(&buffer2, 0);
-	if (!(ivPtr->flags & ITCL_COMMON)) {
+        /*
+         *  Plain variables are updated in place, the ones with traces
+         *  (or arrays, to get the error) by name.
+         */
+        varName = NULL;
+        if (lastValuePtr != NULL) {
+            Tcl_DecrRefCount(lastValuePtr);
+            lastValuePtr = NULL;
+        }
+        varPtr = PublicVar(contextIoPtr, ivPtr);
+        if ((varPtr != NULL) && Itcl_IsPlainScalarVar(varPtr)) {
+            lastValuePtr = Itcl_GetScalarVar(varPtr);
+            if (lastValuePtr == NULL) {
+                lastValuePtr = Tcl_NewObj();
+            }
+            Tcl_IncrRefCount(lastValuePtr);
+            Itcl_SetScalarVar(varPtr, unparsedObjv[i+1]);
+        } else {
+            Tcl_DStringSetLength(&buffer2, 0);
+	    if (!(ivPtr->flags & ITCL_COMMON)) {
+                Tcl_DStringAppend(&buffer2,
+	                Tcl_GetString(contextIoPtr->varNsNamePtr), -1);
+	    }
             Tcl_DStringAppend(&buffer2,
-	            Tcl_GetString(contextIoPtr->varNsNamePtr), -1);
-	}
-        Tcl_DStringAppend(&buffer2,
-	        Tcl_GetString(ivPtr->iclsPtr->fullNamePtr), -1);
-        Tcl_DStringAppend(&buffer2, "::", 2);
-        Tcl_DStringAppend(&buffer2,
-	        Tcl_GetString(ivPtr->namePtr), -1);
-	varName = Tcl_DStringValue(&buffer2);
-        lastval = Tcl_GetVar2(interp, varName, NULL, 0);
-        Tcl_DStringSetLength(&buffer, 0);
-        Tcl_DStringAppend(&buffer, (lastval) ? lastval : "", -1);
-
-        token = Tcl_GetString(unparsedObjv[i+1]);
-        if (Tcl_SetVar2(interp, varName, NULL, token,
-                TCL_LEAVE_ERR_MSG) == NULL) {
-    	    Tcl_AppendObjToErrorInfo(interp, Tcl_ObjPrintf(
-    		    "\n    (error in configuration of public variable \"%s\")",
-    		    Tcl_GetString(ivPtr->fullNamePtr)));
-            result = TCL_ERROR;
-            goto configureDone;
+	            Tcl_GetString(ivPtr->iclsPtr->fullNamePtr), -1);
+            Tcl_DStringAppend(&buffer2, "::", 2);
+            Tcl_DStringAppend(&buffer2,
+	            Tcl_GetString(ivPtr->namePtr), -1);
+	    varName = Tcl_DStringValue(&buffer2);
+            lastval = Tcl_GetVar2(interp, varName, NULL, 0);
+            Tcl_DStringSetLength(&buffer, 0);
+            Tcl_DStringAppend(&buffer, (lastval) ? lastval : "", -1);
+
+            token = Tcl_GetString(unparsedObjv[i+1]);
+            if (Tcl_SetVar2(interp, varName, NULL, token,
+                    TCL_LEAVE_ERR_MSG) == NULL) {
+    	        Tcl_AppendObjToErrorInfo(interp, Tcl_ObjPrintf(
+    		        "\n    (error in configuration of public variable \"%s\")",
+    		        Tcl_GetString(ivPtr->fullNamePtr)));
+                result = TCL_ERROR;
+                goto configureDone;
+            }
         }
 
         /*
@@ -803,8 +810,14 @@ Itcl_BiConfigureCmd(
         	    Tcl_AppendObjToErrorInfo(interp, Tcl_ObjPrintf(
         		    "\n    (error in configuration of public variable \"%s\")",
         		    Tcl_GetString(ivPtr->fullNamePtr)));
-                Tcl_SetVar2(interp, varName,NULL,
-                    Tcl_DStringValue(&buffer), 0);
+                if (varName == NULL) {
+                    if (Itcl_IsPlainScalarVar(varPtr)) {
+                        Itcl_SetScalarVar(varPtr, lastValuePtr);
+                    }
+                } else {
+                    Tcl_SetVar2(interp, varName,NULL,
+                        Tcl_DStringValue(&buffer), 0);
+                }
 
                 goto configureDone;
             }
@@ -812,6 +825,9 @@ Itcl_BiConfigureCmd(
     }
 
 configureDone:
+    if (lastValuePtr != NULL) {
+        Tcl_DecrRefCount(lastValuePtr);
+    }
     if (infoPtr->unparsedObjc > 0) {
 	while (infoPtr->unparsedObjc-- > 1) {
 	    Tcl_DecrRefCount(infoPtr->unparsedObjv[infoPtr->unparsedObjc]);
@@ -855,8 +871,10 @@ Itcl_BiCgetCmd(
 
     Tcl_HashEntry *hPtr;
     ItclVarLookup *vlookup;
+    ItclConfigVar *icvPtr;
+    ItclVariable *ivPtr;
+    Tcl_Obj *valuePtr;
     const char *name;
-    const char *val;
     int result;
     (void)dummy;
 
@@ -891,25 +909,30 @@ Itcl_BiCgetCmd(
     }
     name = Tcl_GetString(objv[1]);
 
-    vlookup = NULL;
-    hPtr = ItclResolveVarEntry(contextIclsPtr, name+1);
-    if (hPtr) {
-        vlookup = (ItclVarLookup*)Tcl_GetHashValue(hPtr);
+    ivPtr = NULL;
+    if (*name == '-') {
+        icvPtr = ItclResolveConfigVar(contextIclsPtr, name);
+        if (icvPtr != NULL) {
+            ivPtr = icvPtr->ivPtr;
+        }
+    } else {
+        hPtr = ItclResolveVarEntry(contextIclsPtr, name+1);
+        if (hPtr) {
+            vlookup = (ItclVarLookup*)Tcl_GetHashValue(hPtr);
+            ivPtr = vlookup->ivPtr;
+        }
     }
 
-    if ((vlookup == NULL) || (vlookup->ivPtr->protection != ITCL_PUBLIC)) {
+    if ((ivPtr == NULL) || (ivPtr->protection != ITCL_PUBLIC)) {
         Tcl_AppendStringsToObj(Tcl_GetObjResult(interp),
             "unknown option \"", name, "\"",
             NULL);
         return TCL_ERROR;
     }
 
-    val = Itcl_GetInstanceVar(interp,
-            Tcl_GetString(vlookup->ivPtr->namePtr),
-            contextIoPtr, vlookup->ivPtr->iclsPtr);
-
-    if (val) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(val, -1));
+    valuePtr = PublicVarValue(interp, contextIoPtr, ivPtr);
+    if (valuePtr) {
+        Tcl_SetObjResult(interp, valuePtr);
     } else {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("<undefined>", -1));
     }
@@ -926,6 +949,8 @@ Itcl_BiCgetCmd(
  *
  *    -<varName> <initVal> <currentVal>
  *
+ *  The option is reported by its simple name unless the variable is
+ *  shadowed, then by as much of its qualified name as needed.
  *  Used by Itcl_BiConfigureCmd() to report configuration options.
  *  Returns a Tcl_Obj containing the information.
  * ------------------------------------------------------------------------
@@ -933,39 +958,16 @@ Itcl_BiCgetCmd(
 static Tcl_Obj*
 ItclReportPublicOpt(
     Tcl_Interp *interp,      /* interpreter containing the object */
-    ItclVariable *ivPtr,     /* public variable to be reported */
+    ItclConfigVar *icvPtr,   /* public variable to be reported */
     ItclObject *contextIoPtr) /* object containing this variable */
 {
-    const char *val;
-    ItclClass *iclsPtr;
-    Tcl_HashEntry *hPtr;
-    ItclVarLookup *vlookup;
-    Tcl_DString optName;
+    ItclVariable *ivPtr;
     Tcl_Obj *listPtr;
     Tcl_Obj *objPtr;
 
+    ivPtr = icvPtr->ivPtr;
     listPtr = Tcl_NewListObj(0, NULL);
-
-    /*
-     *  Determine how the option name should be reported.
-     *  If the simple name can be used to find it in the virtual
-     *  data table, then use the simple name.  Otherwise, this
-     *  is a shadowed variable; use the full name.
-     */
-    Tcl_DStringInit(&optName);
-    Tcl_DStringAppend(&optName, "-", -1);
-
-    iclsPtr = (ItclClass*)contextIoPtr->iclsPtr;
-    hPtr = ItclResolveVarEntry(iclsPtr,
-            Tcl_GetString(ivPtr->fullNamePtr));
-    assert(hPtr != NULL);
-    vlookup = (ItclVarLookup*)Tcl_GetHashValue(hPtr);
-    Tcl_DStringAppend(&optName, vlookup->leastQualName, -1);
-
-    objPtr = Tcl_NewStringObj(Tcl_DStringValue(&optName), -1);
-    Tcl_ListObjAppendElement(NULL, listPtr, objPtr);
-    Tcl_DStringFree(&optName);
-
+    Tcl_ListObjAppendElement(NULL, listPtr, icvPtr->optNamePtr);
 
     if (ivPtr->init) {
         objPtr = ivPtr->init;
@@ -974,19 +976,71 @@ ItclReportPublicOpt(
     }
     Tcl_ListObjAppendElement(NULL, listPtr, objPtr);
 
-    val = Itcl_GetInstanceVar(interp, Tcl_GetString(ivPtr->namePtr),
-            contextIoPtr, ivPtr->iclsPtr);
-
-    if (val) {
-        objPtr = Tcl_NewStringObj((const char *)val, -1);
-    } else {
+    objPtr = PublicVarValue(interp, contextIoPtr, ivPtr);
+    if (objPtr == NULL) {
         objPtr = Tcl_NewStringObj("<undefined>", -1);
     }
     Tcl_ListObjAppendElement(NULL, listPtr, objPtr);
 
     return listPtr;
 }
-
+
+/*
+ * ------------------------------------------------------------------------
+ *  PublicVar()
+ *
+ *  Returns the Tcl_Var of a public variable or common of an object,
+ *  or NULL if it is not known yet.
+ * ------------------------------------------------------------------------
+ */
+static Tcl_Var
+PublicVar(
+    ItclObject *contextIoPtr, /* object containing the variable */
+    ItclVariable *ivPtr)      /* public variable */
+{
+    Tcl_HashEntry *hPtr;
+
+    if (ivPtr->flags & ITCL_COMMON) {
+        hPtr = Tcl_FindHashEntry(&ivPtr->iclsPtr->classCommons,
+	        (char *)ivPtr);
+	if (hPtr == NULL) {
+	    return NULL;
+	}
+	return (Tcl_Var)Tcl_GetHashValue(hPtr);
+    }
+    return ItclGetObjectVar(contextIoPtr, ivPtr);
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  PublicVarValue()
+ *
+ *  Returns the current value of a public variable of an object, or
+ *  NULL if it is undefined.  Plain variables are read in place, others
+ *  by name so that traces fire.
+ * ------------------------------------------------------------------------
+ */
+static Tcl_Obj*
+PublicVarValue(
+    Tcl_Interp *interp,      /* interpreter containing the object */
+    ItclObject *contextIoPtr, /* object containing this variable */
+    ItclVariable *ivPtr)     /* public variable */
+{
+    Tcl_Var varPtr;
+    const char *val;
+
+    varPtr = PublicVar(contextIoPtr, ivPtr);
+    if ((varPtr != NULL) && Itcl_IsPlainScalarVar(varPtr)) {
+        return Itcl_GetScalarVar(varPtr);
+    }
+    val = Itcl_GetInstanceVar(interp, Tcl_GetString(ivPtr->namePtr),
+            contextIoPtr, ivPtr->iclsPtr);
+    if (val == NULL) {
+        return NULL;
+    }
+    return Tcl_NewStringObj(val, -1);
+}
+
 /*
  * ------------------------------------------------------------------------
  *  ItclReportOption()
@@ -1009,7 +1063,6 @@ ItclReportOption(
     Tcl_Obj *listPtr;
     Tcl_Obj *objPtr;
     ItclDelegatedOption *idoPtr;
-    const char *val;
 
     listPtr = Tcl_NewListObj(0, NULL);
     idoPtr = ioptPtr->iclsPtr->infoPtr->currIdoPtr;
@@ -1044,12 +1097,8 @@ ItclReportOption(
         objPtr = Tcl_NewStringObj("<undefined>", -1);
     }
     Tcl_ListObjAppendElement(NULL, listPtr, objPtr);
-    val = ItclGetInstanceVar(interp, "itcl_options",
-            Tcl_GetString(ioptPtr->namePtr),
-            contextIoPtr, ioptPtr->iclsPtr);
-    if (val) {
-        objPtr = Tcl_NewStringObj((const char *)val, -1);
-    } else {
+    objPtr = ItclGetOptionValue(interp, contextIoPtr, ioptPtr);
+    if (objPtr == NULL) {
         objPtr = Tcl_NewStringObj("<undefined>", -1);
     }
     Tcl_ListObjAppendElement(NULL, listPtr, objPtr);
@@ -1647,7 +1696,7 @@ ItclUnknownGuts(
     }
     icPtr = NULL;
     if (!isItclHull) {
-        FOREACH_HASH_VALUE(icPtr, &ioPtr->objectComponents) {
+        FOREACH_HASH_VALUE(icPtr, ioPtr->objectComponents) {
             if (icPtr->flags & ITCL_COMPONENT_INHERIT) {
 	        val = Itcl_GetInstanceVar(interp,
 	                Tcl_GetString(icPtr->namePtr), ioPtr,
@@ -1962,6 +2011,7 @@ ItclExtendedConfigure(
     ItclComponent *icPtr;
     ItclOption *ioptPtr;
     ItclObjectInfo *infoPtr;
+    Tcl_Obj *valuePtr;
     const char *val;
     int lObjc;
     int lObjc2;
@@ -2062,7 +2112,7 @@ ItclExtendedConfigure(
             result = Tcl_EvalEx(interp, "::itcl::builtin::getEclassOptions", -1, 0);
             return result;
 	}
-	FOREACH_HASH_VALUE(ioptPtr, &contextIoPtr->objectOptions) {
+	FOREACH_HASH_VALUE(ioptPtr, contextIoPtr->objectOptions) {
 	    hPtr2 = Tcl_CreateHashEntry(&unique,
 	            (char *)ioptPtr->namePtr, &isNew);
 	    if (!isNew) {
@@ -2083,18 +2133,15 @@ ItclExtendedConfigure(
 	        Tcl_ListObjAppendElement(interp, objPtr,
 		        Tcl_NewStringObj("", -1));
 	    }
-	    val = ItclGetInstanceVar(interp, "itcl_options",
-	            Tcl_GetString(ioptPtr->namePtr), contextIoPtr,
-		    contextIclsPtr);
-	    if (val == NULL) {
-		val = "<undefined>";
+	    valuePtr = ItclGetOptionValue(interp, contextIoPtr, ioptPtr);
+	    if (valuePtr == NULL) {
+		valuePtr = Tcl_NewStringObj("<undefined>", -1);
 	    }
-	    Tcl_ListObjAppendElement(interp, objPtr,
-	            Tcl_NewStringObj(val, -1));
+	    Tcl_ListObjAppendElement(interp, objPtr, valuePtr);
 	    Tcl_ListObjAppendElement(interp, listPtr, objPtr);
 	}
 	/* now check for delegated options */
-	FOREACH_HASH_VALUE(idoPtr, &contextIoPtr->objectDelegatedOptions) {
+	FOREACH_HASH_VALUE(idoPtr, contextIoPtr->objectDelegatedOptions) {
 
             if (idoPtr->icPtr != NULL) {
                 icPtr = idoPtr->icPtr;
@@ -2212,14 +2259,14 @@ ItclExtendedConfigure(
     }
     hPtr2 = NULL;
     /* first handle delegated options */
-    hPtr = Tcl_FindHashEntry(&contextIoPtr->objectDelegatedOptions, (char *)
+    hPtr = Tcl_FindHashEntry(contextIoPtr->objectDelegatedOptions, (char *)
             objv[1]);
     if (hPtr == NULL) {
 	Tcl_Obj *objPtr;
 	objPtr = Tcl_NewStringObj("*",1);
 	Tcl_IncrRefCount(objPtr);
         /* check if all options are delegated */
-        hPtr = Tcl_FindHashEntry(&contextIoPtr->objectDelegatedOptions,
+        hPtr = Tcl_FindHashEntry(contextIoPtr->objectDelegatedOptions,
 	        (char *)objPtr);
 	Tcl_DecrRefCount(objPtr);
         if (hPtr != NULL) {
@@ -2235,7 +2282,7 @@ ItclExtendedConfigure(
     componentIcPtr = NULL;
     /* check if it is not a local option defined before delegate option "*"
      */
-    hPtr2 = Tcl_FindHashEntry(&contextIoPtr->objectOptions,
+    hPtr2 = Tcl_FindHashEntry(contextIoPtr->objectOptions,
             (char *)objv[1]);
     if (hPtr != NULL) {
         idoPtr = (ItclDelegatedOption *)Tcl_GetHashValue(hPtr);
@@ -2334,7 +2381,7 @@ ItclExtendedConfigure(
             hPtr2 = Tcl_FindHashEntry(&contextIclsPtr->options,
 	            (char *) objv[1]);
             if (hPtr2 == NULL) {
-                hPtr2 = Tcl_FindHashEntry(&contextIoPtr->objectOptions,
+                hPtr2 = Tcl_FindHashEntry(contextIoPtr->objectOptions,
 	                (char *) objv[1]);
 	    } else {
 	       infoPtr->currIdoPtr = NULL;
@@ -2376,7 +2423,7 @@ ItclExtendedConfigure(
 	    result = TCL_ERROR;
 	    break;
 	}
-        hPtr = Tcl_FindHashEntry(&contextIoPtr->objectOptions,
+        hPtr = Tcl_FindHashEntry(contextIoPtr->objectOptions,
 	        (char *) objv[i]);
         if (hPtr == NULL) {
             if (contextIclsPtr->flags & ITCL_ECLASS) {
@@ -2396,7 +2443,7 @@ ItclExtendedConfigure(
                   continue;
                 }
 	    }
-            hPtr = Tcl_FindHashEntry(&contextIoPtr->objectDelegatedOptions,
+            hPtr = Tcl_FindHashEntry(contextIoPtr->objectDelegatedOptions,
 	            (char *) objv[i]);
             if (hPtr != NULL) {
 	        /* the option is delegated */
@@ -2558,9 +2605,8 @@ ItclExtendedConfigure(
 	        break;
 	    }
 	} else {
-	    if (ItclSetInstanceVar(interp, "itcl_options",
-	            Tcl_GetString(objv[i]), Tcl_GetString(objv[i+1]),
-		    contextIoPtr, ioptPtr->iclsPtr) == NULL) {
+	    if (ItclSetOptionValue(interp, contextIoPtr, ioptPtr,
+	            objv[i+1]) == NULL) {
 		result = TCL_ERROR;
 	        break;
 	    }
@@ -2698,18 +2744,18 @@ ItclExtendedCget(
     }
     /* now do the hard work */
     /* first handle delegated options */
-    hPtr = Tcl_FindHashEntry(&contextIoPtr->objectDelegatedOptions, (char *)
+    hPtr = Tcl_FindHashEntry(contextIoPtr->objectDelegatedOptions, (char *)
             objv[1]);
-    hPtr3 = Tcl_FindHashEntry(&contextIoPtr->objectOptions, (char *)
+    hPtr3 = Tcl_FindHashEntry(contextIoPtr->objectOptions, (char *)
             objv[1]);
     hPtr2 = NULL;
     if (hPtr == NULL) {
 	objPtr2 = Tcl_NewStringObj("*", -1);
         /* check for "*" option delegated */
-        hPtr = Tcl_FindHashEntry(&contextIoPtr->objectDelegatedOptions, (char *)
+        hPtr = Tcl_FindHashEntry(contextIoPtr->objectDelegatedOptions, (char *)
                 objPtr2);
 	Tcl_DecrRefCount(objPtr2);
-        hPtr2 = Tcl_FindHashEntry(&contextIoPtr->objectOptions, (char *)
+        hPtr2 = Tcl_FindHashEntry(contextIoPtr->objectOptions, (char *)
                 objv[1]);
     }
     if ((hPtr != NULL) && (hPtr2 == NULL) && (hPtr3 == NULL)) {
@@ -2799,11 +2845,9 @@ ItclExtendedCget(
 	Tcl_DecrRefCount(newObjv[0]);
         ckfree((char *)newObjv);
     } else {
-        val = ItclGetInstanceVar(interp, "itcl_options",
-                Tcl_GetString(ioptPtr->namePtr),
-		contextIoPtr, ioptPtr->iclsPtr);
-        if (val) {
-            Tcl_SetObjResult(interp, Tcl_NewStringObj(val, -1));
+        objPtr = ItclGetOptionValue(interp, contextIoPtr, ioptPtr);
+        if (objPtr != NULL) {
+            Tcl_SetObjResult(interp, objPtr);
         } else {
             Tcl_SetObjResult(interp, Tcl_NewStringObj("<undefined>", -1));
         }
@@ -2889,7 +2933,7 @@ ItclExtendedSetGet(
         return TCL_ERROR;
     }
     /* look if it is an methodvariable at all */
-    hPtr = Tcl_FindHashEntry(&contextIoPtr->objectMethodVariables,
+    hPtr = Tcl_FindHashEntry(contextIoPtr->objectMethodVariables,
             (char *) objv[1]);
     if (hPtr == NULL) {
 	Tcl_AppendResult(interp, "no such methodvariable \"",
@@ -3013,7 +3057,7 @@ Itcl_BiInstallComponentCmd(
     hPtr = Tcl_FindHashEntry(&contextIclsPtr->components, (char *)objv[1]);
     if (hPtr == NULL) {
 	numOpts = 0;
-	FOREACH_HASH_VALUE(idoPtr, &contextIoPtr->objectDelegatedOptions) {
+	FOREACH_HASH_VALUE(idoPtr, contextIoPtr->objectDelegatedOptions) {
             if (idoPtr == NULL) {
                 /* FIXME need code here !! */
 	    }
@@ -3161,36 +3205,39 @@ Itcl_BiDestroyCmd(
  *
  *    callinstance <instanceName> ?arg arg ...?
  *
+ *  The instance name made by mymethod knows the object's access
+ *  command (see ItclGetCallbackCommand), so the call goes straight
+ *  to the object, and it works from any context, e.g. from "after".
  * ------------------------------------------------------------------------
  */
-/* ARGSUSED */
-int
-Itcl_BiCallInstanceCmd(
+static int
+CallInstanceDone(
+    ClientData data[],
+    Tcl_Interp *interp,
+    int result)
+{
+    Tcl_Obj **newObjv = (Tcl_Obj **)data[0];
+    (void)interp;
+
+    Tcl_DecrRefCount(newObjv[0]);
+    ckfree((char *)newObjv);
+    return result;
+}
+
+static int
+NRBiCallInstanceCmd(
     void *dummy,   /* class definition */
     Tcl_Interp *interp,      /* current interpreter */
     int objc,                /* number of arguments */
     Tcl_Obj *const objv[])   /* argument objects */
 {
-    Tcl_HashEntry *hPtr;
-    Tcl_Obj *objPtr;
+    Tcl_Obj *cmdNamePtr;
     Tcl_Obj **newObjv;
-    ItclClass *contextIclsPtr;
-    ItclObject *contextIoPtr;
-    ItclObject *ioPtr;
+    ItclObjectInfo *infoPtr;
     const char *token;
-    int result;
     (void)dummy;
 
-    /*
-     *  Make sure that this command is being invoked in the proper
-     *  context.
-     */
     ItclShowArgs(1, "Itcl_BiCallInstanceCmd", objc, objv);
-    contextIclsPtr = NULL;
-    if (Itcl_GetContext(interp, &contextIclsPtr, &contextIoPtr) != TCL_OK) {
-        return TCL_ERROR;
-    }
-
     if (objc < 2) {
         token = Tcl_GetString(objv[0]);
         Tcl_AppendStringsToObj(Tcl_GetObjResult(interp),
@@ -3199,25 +3246,33 @@ Itcl_BiCallInstanceCmd(
         return TCL_ERROR;
     }
 
-    hPtr = Tcl_FindHashEntry(&contextIclsPtr->infoPtr->instances,
-            Tcl_GetString(objv[1]));
-    if (hPtr == NULL) {
+    infoPtr = (ItclObjectInfo *)Tcl_GetAssocData(interp,
+            ITCL_INTERP_DATA, NULL);
+    cmdNamePtr = ItclGetCallbackCommand(interp, infoPtr, objv[1]);
+    if (cmdNamePtr == NULL) {
 	Tcl_AppendResult(interp,
 	        "no such instanceName \"",
 		Tcl_GetString(objv[1]), "\"", NULL);
         return TCL_ERROR;
     }
-    ioPtr = (ItclObject *)Tcl_GetHashValue(hPtr);
-    objPtr =Tcl_NewObj();
-    Tcl_GetCommandFullName(interp, ioPtr->accessCmd, objPtr);
     newObjv = (Tcl_Obj **)ckalloc(sizeof(Tcl_Obj*) * (objc - 1));
-    newObjv[0] = objPtr;
+    newObjv[0] = cmdNamePtr;
     Tcl_IncrRefCount(newObjv[0]);
     memcpy(newObjv + 1, objv + 2, sizeof(Tcl_Obj *) * (objc - 2));
-    result = Tcl_EvalObjv(interp, objc - 1, newObjv, 0);
-    Tcl_DecrRefCount(newObjv[0]);
-    ckfree((char *)newObjv);
-    return result;
+    Tcl_NRAddCallback(interp, CallInstanceDone, newObjv, NULL, NULL, NULL);
+    return Tcl_NREvalObjv(interp, objc - 1, newObjv, 0);
+}
+
+/* ARGSUSED */
+int
+Itcl_BiCallInstanceCmd(
+    void *clientData,
+    Tcl_Interp *interp,
+    int objc,
+    Tcl_Obj *const objv[])
+{
+    return Tcl_NRCallObjProc(interp, NRBiCallInstanceCmd, clientData,
+            objc, objv);
 }
 /*
  * ------------------------------------------------------------------------
@@ -3376,8 +3431,8 @@ Itcl_BiMyMethodCmd(
 	resultPtr = Tcl_NewListObj(0, NULL);
 	Tcl_ListObjAppendElement(interp, resultPtr,
 	        Tcl_NewStringObj("::itcl::builtin::callinstance", -1));
-	Tcl_ListObjAppendElement(interp, resultPtr, Tcl_NewStringObj(
-		(Tcl_GetObjectNamespace(contextIoPtr->oPtr))->fullName, -1));
+	Tcl_ListObjAppendElement(interp, resultPtr,
+		ItclCallbackInstanceObj(contextIoPtr));
 	for (i = 1; i < objc; i++) {
 	    Tcl_ListObjAppendElement(interp, resultPtr, objv[i]);
 	}
@@ -3397,6 +3452,9 @@ Itcl_BiMyMethodCmd(
  *
  *    myproc ?arg arg ...?
  *
+ *  For a proc of the class itself, the first word is the proc's own
+ *  fully qualified name, so that all callbacks for the proc share it
+ *  and the command is resolved once rather than once per callback.
  * ------------------------------------------------------------------------
  */
 /* ARGSUSED */
@@ -3407,10 +3465,12 @@ Itcl_BiMyProcCmd(
     int objc,                /* number of arguments */
     Tcl_Obj *const objv[])   /* argument objects */
 {
+    Tcl_HashEntry *hPtr;
     Tcl_Obj *objPtr;
     Tcl_Obj *resultPtr;
     ItclClass *contextIclsPtr;
     ItclObject *contextIoPtr;
+    ItclMemberFunc *imPtr;
     int i;
     (void)dummy;
 
@@ -3427,9 +3487,21 @@ Itcl_BiMyProcCmd(
         Tcl_AppendResult(interp, "usage: myproc <name>", NULL);
         return TCL_ERROR;
     }
-    objPtr = Tcl_NewStringObj(contextIclsPtr->nsPtr->fullName, -1);
-    Tcl_AppendToObj(objPtr, "::", -1);
-    Tcl_AppendToObj(objPtr, Tcl_GetString(objv[1]), -1);
+    objPtr = NULL;
+    hPtr = Tcl_FindHashEntry(&contextIclsPtr->functions, (char *)objv[1]);
+    if (hPtr != NULL) {
+        imPtr = (ItclMemberFunc *)Tcl_GetHashValue(hPtr);
+	if ((imPtr->flags & ITCL_COMMON) && (imPtr->iclsPtr == contextIclsPtr)
+		&& (strcmp(Tcl_GetString(contextIclsPtr->fullNamePtr),
+		contextIclsPtr->nsPtr->fullName) == 0)) {
+	    objPtr = imPtr->fullNamePtr;
+	}
+    }
+    if (objPtr == NULL) {
+	objPtr = Tcl_NewStringObj(contextIclsPtr->nsPtr->fullName, -1);
+	Tcl_AppendToObj(objPtr, "::", -1);
+	Tcl_AppendToObj(objPtr, Tcl_GetString(objv[1]), -1);
+    }
     resultPtr = Tcl_NewListObj(0, NULL);
     Tcl_ListObjAppendElement(interp, resultPtr, objPtr);
 
@@ -3696,10 +3768,10 @@ Itcl_BiInitOptionsCmd(
         return TCL_ERROR;
     }
     /* first handle delegated options */
-    FOREACH_HASH_VALUE(idoptPtr, &ioPtr->objectDelegatedOptions) {
+    FOREACH_HASH_VALUE(idoptPtr, ioPtr->objectDelegatedOptions) {
 fprintf(stderr, "delopt!%s!\n", Tcl_GetString(idoptPtr->namePtr));
     }
-    FOREACH_HASH_VALUE(ioptPtr, &ioPtr->objectOptions) {
+    FOREACH_HASH_VALUE(ioptPtr, ioPtr->objectOptions) {
 fprintf(stderr, "opt!%s!\n", Tcl_GetString(ioptPtr->namePtr));
     }
     return result;
@@ -3791,7 +3863,7 @@ Itcl_BiIgnoreComponentOptionCmd(
         return TCL_ERROR;
     }
     if (ioPtr != NULL) {
-        hPtr = Tcl_FindHashEntry(&ioPtr->objectComponents, (char *)objv[1]);
+        hPtr = Tcl_FindHashEntry(ioPtr->objectComponents, (char *)objv[1]);
         if (hPtr == NULL) {
 	    Tcl_AppendResult(interp,
 	            "ignorecomponentoption cannot find component \"",
@@ -3806,7 +3878,8 @@ Itcl_BiIgnoreComponentOptionCmd(
             if (isNew) {
 	        Tcl_SetHashValue(hPtr, objv[idx]);
 	    }
-	    hPtr2 = Tcl_CreateHashEntry(&ioPtr->objectDelegatedOptions,
+	    hPtr2 = Tcl_CreateHashEntry(
+		    ItclObjectTable(ioPtr, &ioPtr->objectDelegatedOptions),
 	            (char *)objv[idx], &isNew);
 	    if (isNew) {
 		idoPtr = (ItclDelegatedOption *)ckalloc(sizeof(
@@ -32,12 +32,12 @@
  */
 #include "itclInt.h"
 
-static Tcl_NamespaceDeleteProc* _TclOONamespaceDeleteProc = NULL;
 static void ItclDeleteOption(char *cdata);
 
 /*
  *  FORWARD DECLARATIONS
  */
+static void BuildHierarchy(ItclClass *iclsPtr);
 static void ItclDestroyClass(ClientData cdata);
 static void ItclFreeClass (char* cdata);
 static void ItclDeleteFunction(ItclMemberFunc *imPtr);
@@ -126,11 +126,7 @@ ItclDeleteClassMetadata(
 	 * Itcl's idea of the class namespace is different from that of TclOO.
 	 * Make sure both get torn down and pulled from tables.
 	 */
-	Tcl_HashEntry *hPtr = Tcl_FindHashEntry(&iclsPtr->infoPtr->namespaceClasses,
-		(char *)ooNsPtr);
-	if (hPtr != NULL) {
-	    Tcl_DeleteHashEntry(hPtr);
-	}
+	ItclForgetNamespaceClass(iclsPtr->infoPtr, ooNsPtr);
 	Tcl_DeleteNamespace(iclsPtr->nsPtr);
     } else {
 	ItclDestroyClass2(iclsPtr);
@@ -276,6 +272,11 @@ Itcl_CreateClass(
     iclsPtr->interp = interp;
     iclsPtr->infoPtr = infoPtr;
     Itcl_PreserveData(infoPtr);
+    if (Itcl_GetStackSize(&infoPtr->freeClassIds) > 0) {
+        iclsPtr->classId = PTR2INT(Itcl_PopStack(&infoPtr->freeClassIds));
+    } else {
+        iclsPtr->classId = infoPtr->numClassIds++;
+    }
 
     Tcl_InitObjHashTable(&iclsPtr->variables);
     Tcl_InitObjHashTable(&iclsPtr->functions);
@@ -285,6 +286,7 @@ Itcl_CreateClass(
     Tcl_InitObjHashTable(&iclsPtr->delegatedFunctions);
     Tcl_InitObjHashTable(&iclsPtr->methodVariables);
     Tcl_InitObjHashTable(&iclsPtr->resolveCmds);
+    Tcl_InitHashTable(&iclsPtr->resolveCmdNames, TCL_STRING_KEYS);
 
     iclsPtr->numInstanceVars = 0;
     Tcl_InitHashTable(&iclsPtr->classCommons, TCL_ONE_WORD_KEYS);
@@ -294,11 +296,12 @@ Itcl_CreateClass(
     Itcl_InitList(&iclsPtr->bases);
     Itcl_InitList(&iclsPtr->derived);
 
-    resolveInfoPtr = (ItclResolveInfo *) ckalloc(sizeof(ItclResolveInfo));
-    memset(resolveInfoPtr, 0, sizeof(ItclResolveInfo));
+    resolveInfoPtr = (ItclResolveInfo *)ItclPoolAlloc(infoPtr,
+            sizeof(ItclResolveInfo));
     resolveInfoPtr->flags = ITCL_RESOLVE_CLASS;
     resolveInfoPtr->iclsPtr = iclsPtr;
-    iclsPtr->resolvePtr = (Tcl_Resolve *)ckalloc(sizeof(Tcl_Resolve));
+    iclsPtr->resolvePtr = (Tcl_Resolve *)ItclPoolAlloc(infoPtr,
+            sizeof(Tcl_Resolve));
     iclsPtr->resolvePtr->cmdProcPtr = Itcl_CmdAliasProc;
     iclsPtr->resolvePtr->varProcPtr = Itcl_VarAliasProc;
     iclsPtr->resolvePtr->clientData = resolveInfoPtr;
@@ -370,9 +373,6 @@ Itcl_CreateClass(
     ooNs = Tcl_GetObjectNamespace(oPtr);
     classNs = Tcl_FindNamespace(interp, Tcl_GetString(nameObjPtr),
             NULL, /* flags */ 0);
-    if (_TclOONamespaceDeleteProc == NULL) {
-        _TclOONamespaceDeleteProc = ooNs->deleteProc;
-    }
 
     if (classNs == NULL) {
 	Tcl_AppendResult(interp,
@@ -406,6 +406,7 @@ Itcl_CreateClass(
     hPtr = Tcl_CreateHashEntry(&infoPtr->nameClasses,
             (char *)iclsPtr->fullNamePtr, &newEntry);
     Tcl_SetHashValue(hPtr, iclsPtr);
+    infoPtr->classEpoch++;
 
 
     hPtr = Tcl_CreateHashEntry(&infoPtr->namespaceClasses, (char *)classNs,
@@ -581,7 +582,6 @@ CallDeleteOneObject(
     int result)
 {
     Tcl_HashEntry *hPtr;
-    Tcl_HashSearch place;
     ItclClass *iclsPtr2 = NULL;
     ItclObject *contextIoPtr;
     ItclClass *iclsPtr = (ItclClass *)data[0];
@@ -601,34 +601,27 @@ CallDeleteOneObject(
         return result;
     }
     /*
-     * Fix 227804: Whenever an object to delete was found we
-     * have to reset the search to the beginning as the
-     * current entry in the search was deleted and accessing it
-     * is therefore not allowed anymore.
+     * Delete the first instance which is still alive.  Deleted objects
+     * leave the instance list only when they are freed, so the list
+     * is searched from the start each time.
      */
 
-    hPtr = Tcl_FirstHashEntry(&infoPtr->objects, &place);
-    if (hPtr) {
-        contextIoPtr = (ItclObject*)Tcl_GetHashValue(hPtr);
-
-        while (contextIoPtr->iclsPtr != iclsPtr) {
-            hPtr = Tcl_NextHashEntry(&place);
-            if (hPtr == NULL) {
-                break;
-            }
+    for (contextIoPtr = iclsPtr->instancesPtr; contextIoPtr != NULL;
+            contextIoPtr = contextIoPtr->nextInstancePtr) {
+        if (ItclIsLiveObject(contextIoPtr)) {
+            break;
         }
-        if (hPtr) {
-	    callbackPtr = Itcl_GetCurrentCallbackPtr(interp);
-            if (Itcl_DeleteObject(interp, contextIoPtr) != TCL_OK) {
-                iclsPtr2 = iclsPtr;
-                goto deleteClassFail;
-            }
-
-            Tcl_NRAddCallback(interp, CallDeleteOneObject, iclsPtr,
-	            infoPtr, NULL, NULL);
-            return Itcl_NRRunCallbacks(interp, callbackPtr);
+    }
+    if (contextIoPtr != NULL) {
+	callbackPtr = Itcl_GetCurrentCallbackPtr(interp);
+        if (Itcl_DeleteObject(interp, contextIoPtr) != TCL_OK) {
+            iclsPtr2 = iclsPtr;
+            goto deleteClassFail;
         }
 
+        Tcl_NRAddCallback(interp, CallDeleteOneObject, iclsPtr,
+	        infoPtr, NULL, NULL);
+        return Itcl_NRRunCallbacks(interp, callbackPtr);
     }
 
     return TCL_OK;
@@ -992,6 +985,7 @@ ItclFreeClass(
         elem = Itcl_NextListElem(elem);
     }
     Itcl_DeleteList(&iclsPtr->derived);
+    ItclInvalidateInstanceLayout(iclsPtr);
 
     /*
      *  Tear down the variable resolution table.  Some records
@@ -1006,7 +1000,7 @@ ItclFreeClass(
              *  If this is a common variable owned by this class,
              *  then release the class's hold on it. FIXME !!!
              */
-            ckfree((char*)vlookup);
+            ItclPoolFree(iclsPtr->infoPtr, vlookup, sizeof(ItclVarLookup));
         }
     }
 
@@ -1021,10 +1015,12 @@ ItclFreeClass(
             break;
         }
         clookupPtr = (ItclCmdLookup *)Tcl_GetHashValue(hPtr);
-        ckfree((char *)clookupPtr);
+        ItclPoolFree(iclsPtr->infoPtr, clookupPtr, sizeof(ItclCmdLookup));
 	Tcl_DeleteHashEntry(hPtr);
     }
     Tcl_DeleteHashTable(&iclsPtr->resolveCmds);
+    Tcl_DeleteHashTable(&iclsPtr->resolveCmdNames);
+    ItclDeleteMethodMap(iclsPtr);
 
     /*
      *  Delete all option definitions.
@@ -1110,6 +1106,8 @@ ItclFreeClass(
     }
     Itcl_DeleteList(&iclsPtr->bases);
     Tcl_DeleteHashTable(&iclsPtr->heritage);
+    ItclInvalidateHierarchy(iclsPtr);
+    Itcl_PushStack(INT2PTR(iclsPtr->classId), &iclsPtr->infoPtr->freeClassIds);
 
     /* remove owerself from the all classes entry */
     hPtr = Tcl_FindHashEntry(&iclsPtr->infoPtr->nameClasses,
@@ -1117,13 +1115,10 @@ ItclFreeClass(
     if (hPtr != NULL) {
         Tcl_DeleteHashEntry(hPtr);
     }
+    iclsPtr->infoPtr->classEpoch++;
 
     /* remove owerself from the all namespaceClasses entry */
-    hPtr = Tcl_FindHashEntry(&iclsPtr->infoPtr->namespaceClasses,
-            (char *)iclsPtr->nsPtr);
-    if (hPtr != NULL) {
-        Tcl_DeleteHashEntry(hPtr);
-    }
+    ItclForgetNamespaceClass(iclsPtr->infoPtr, iclsPtr->nsPtr);
 
     /* remove owerself from the all classes entry */
     hPtr = Tcl_FindHashEntry(&iclsPtr->infoPtr->classes, (char *)iclsPtr);
@@ -1171,15 +1166,20 @@ ItclFreeClass(
         Tcl_DecrRefCount(iclsPtr->initCode);
     }
 
-    Itcl_ReleaseData(iclsPtr->infoPtr);
-
     Tcl_DecrRefCount(iclsPtr->namePtr);
     Tcl_DecrRefCount(iclsPtr->fullNamePtr);
 
     if (iclsPtr->resolvePtr != NULL) {
-        ckfree((char *)iclsPtr->resolvePtr->clientData);
-        ckfree((char *)iclsPtr->resolvePtr);
+        ItclPoolFree(iclsPtr->infoPtr, iclsPtr->resolvePtr->clientData,
+                sizeof(ItclResolveInfo));
+        ItclPoolFree(iclsPtr->infoPtr, iclsPtr->resolvePtr,
+                sizeof(Tcl_Resolve));
     }
+
+    /*
+     *  Released last, the pooled records above depend on it.
+     */
+    Itcl_ReleaseData(iclsPtr->infoPtr);
     ckfree(iclsPtr);
 }
 
@@ -1201,6 +1201,57 @@ Itcl_IsClassNamespace(
 }
 
 
+/*
+ * ------------------------------------------------------------------------
+ *  ItclNamespaceClass()
+ *
+ *  Returns the class represented by the given namespace, or NULL if
+ *  the namespace is not a class namespace.  A class namespace of its
+ *  own carries the class as clientData, set by Itcl_CreateClass and
+ *  cleared by Tcl when the namespace is deleted; the class is not
+ *  freed before, ItclDestroyClass2 holds a reference.  The namespace
+ *  of the TclOO object of the class, usually also the class namespace,
+ *  has TclOO's clientData and is looked up in the namespaceClasses
+ *  table, from which ItclForgetNamespaceClass removes it.
+ * ------------------------------------------------------------------------
+ */
+ItclClass *
+ItclNamespaceClass(
+    ItclObjectInfo *infoPtr,   /* info for this interpreter */
+    Tcl_Namespace *nsPtr)      /* namespace being tested */
+{
+    Tcl_HashEntry *hPtr;
+
+    if (nsPtr->deleteProc == ItclDestroyClass2) {
+        return (ItclClass *)nsPtr->clientData;
+    }
+    hPtr = Tcl_FindHashEntry(&infoPtr->namespaceClasses, (char *)nsPtr);
+    if (hPtr == NULL) {
+        return NULL;
+    }
+    return (ItclClass *)Tcl_GetHashValue(hPtr);
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclForgetNamespaceClass()
+ *
+ *  Removes a namespace from the namespaceClasses table.
+ * ------------------------------------------------------------------------
+ */
+void
+ItclForgetNamespaceClass(
+    ItclObjectInfo *infoPtr,   /* info for this interpreter */
+    Tcl_Namespace *nsPtr)      /* namespace no longer representing a class */
+{
+    Tcl_HashEntry *hPtr;
+
+    hPtr = Tcl_FindHashEntry(&infoPtr->namespaceClasses, (char *)nsPtr);
+    if (hPtr != NULL) {
+        Tcl_DeleteHashEntry(hPtr);
+    }
+}
+
 /*
  * ------------------------------------------------------------------------
  *  Itcl_IsClass()
@@ -1279,20 +1330,13 @@ Itcl_FindClass(
      *  definition, then search again.
      */
     if (autoload) {
-        Tcl_DString buf;
-
-        Tcl_DStringInit(&buf);
-        Tcl_DStringAppend(&buf, "::auto_load ", -1);
-        Tcl_DStringAppend(&buf, path, -1);
-        if (Tcl_EvalEx(interp, Tcl_DStringValue(&buf), -1, 0) != TCL_OK) {
+        if (ItclAutoload(interp, path) != TCL_OK) {
             Tcl_AppendObjToErrorInfo(interp, Tcl_ObjPrintf(
                     "\n    (while attempting to autoload class \"%s\")",
                     path));
-            Tcl_DStringFree(&buf);
             return NULL;
         }
         Tcl_ResetResult(interp);
-        Tcl_DStringFree(&buf);
 
 	return Itcl_FindClass(interp, path, 0);
     }
@@ -1728,7 +1772,8 @@ ItclResolveVarEntry(
 		    if (newEntry) {
 			if (!vlookup) {
 			    /* create new (or overwrite) */
-			    vlookup = (ItclVarLookup *)ckalloc(sizeof(ItclVarLookup));
+			    vlookup = (ItclVarLookup *)ItclPoolAlloc(
+				    iclsPtr->infoPtr, sizeof(ItclVarLookup));
 			    vlookup->usage = 0;
 
 			setResVar:
@@ -1818,6 +1863,413 @@ ItclResolveVarEntry(
     }
 }
 
+/*
+ * ------------------------------------------------------------------------
+ *  ItclGetConfigTable()
+ *
+ *  Returns the public variables of a class hierarchy as used by the
+ *  built-in "configure" and "cget" methods, building the table on
+ *  first use.  Each option starts out known by the name "configure"
+ *  reports for it.  The table is discarded by
+ *  ItclInvalidateInstanceLayout() whenever variables or the heritage
+ *  of the class change.
+ * ------------------------------------------------------------------------
+ */
+ItclConfigTable *
+ItclGetConfigTable(
+    ItclClass *iclsPtr)       /* most specific class of an object */
+{
+    ItclConfigTable *tablePtr;
+    ItclConfigVar *icvPtr;
+    ItclVariable *ivPtr;
+    ItclVarLookup *vlookup;
+    ItclHierIter hier;
+    ItclClass *iclsPtr2;
+    Tcl_HashEntry *entryPtr;
+    int numVars;
+    int isNew;
+    FOREACH_HASH_DECLS;
+
+    if (iclsPtr->configTablePtr != NULL) {
+        return iclsPtr->configTablePtr;
+    }
+    numVars = 0;
+    Itcl_InitHierIter(&hier, iclsPtr);
+    while ((iclsPtr2 = Itcl_AdvanceHierIter(&hier)) != NULL) {
+        FOREACH_HASH_VALUE(ivPtr, &iclsPtr2->variables) {
+	    if (ivPtr->protection == ITCL_PUBLIC) {
+	        numVars++;
+	    }
+	}
+    }
+    Itcl_DeleteHierIter(&hier);
+
+    tablePtr = (ItclConfigTable *)ckalloc(sizeof(ItclConfigTable));
+    tablePtr->numVars = 0;
+    tablePtr->vars = (ItclConfigVar *)ckalloc(
+            (numVars + 1) * sizeof(ItclConfigVar));
+    Tcl_InitHashTable(&tablePtr->names, TCL_STRING_KEYS);
+
+    Itcl_InitHierIter(&hier, iclsPtr);
+    while ((iclsPtr2 = Itcl_AdvanceHierIter(&hier)) != NULL) {
+        FOREACH_HASH_VALUE(ivPtr, &iclsPtr2->variables) {
+	    if (ivPtr->protection != ITCL_PUBLIC) {
+	        continue;
+	    }
+	    /*
+	     *  Report the option by its simple name unless the variable
+	     *  is shadowed, then with as much qualification as needed.
+	     */
+	    entryPtr = ItclResolveVarEntry(iclsPtr,
+	            Tcl_GetString(ivPtr->fullNamePtr));
+	    assert(entryPtr != NULL);
+	    vlookup = (ItclVarLookup *)Tcl_GetHashValue(entryPtr);
+	    icvPtr = &tablePtr->vars[tablePtr->numVars++];
+	    icvPtr->ivPtr = ivPtr;
+	    icvPtr->optNamePtr = Tcl_NewStringObj("-", 1);
+	    Tcl_AppendToObj(icvPtr->optNamePtr, vlookup->leastQualName, -1);
+	    Tcl_IncrRefCount(icvPtr->optNamePtr);
+	    entryPtr = Tcl_CreateHashEntry(&tablePtr->names,
+	            Tcl_GetString(icvPtr->optNamePtr), &isNew);
+	    if (isNew) {
+	        Tcl_SetHashValue(entryPtr, icvPtr);
+	    }
+	}
+    }
+    Itcl_DeleteHierIter(&hier);
+    iclsPtr->configTablePtr = tablePtr;
+    return tablePtr;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclResolveConfigVar()
+ *
+ *  Returns the public variable behind the configuration option
+ *  "-<name>" of a class, or NULL if there is none.  <name> is resolved
+ *  like any variable name in the class scope, so qualified names work
+ *  as well; names resolved once are remembered in the config table.
+ * ------------------------------------------------------------------------
+ */
+ItclConfigVar *
+ItclResolveConfigVar(
+    ItclClass *iclsPtr,       /* most specific class of an object */
+    const char *optName)      /* option name including the "-" */
+{
+    ItclConfigTable *tablePtr;
+    ItclVarLookup *vlookup;
+    Tcl_HashEntry *hPtr;
+    int isNew;
+    int i;
+
+    tablePtr = ItclGetConfigTable(iclsPtr);
+    hPtr = Tcl_FindHashEntry(&tablePtr->names, optName);
+    if (hPtr != NULL) {
+        return (ItclConfigVar *)Tcl_GetHashValue(hPtr);
+    }
+    if (*optName != '-') {
+        return NULL;
+    }
+    hPtr = ItclResolveVarEntry(iclsPtr, optName+1);
+    if (hPtr == NULL) {
+        return NULL;
+    }
+    vlookup = (ItclVarLookup *)Tcl_GetHashValue(hPtr);
+    if (vlookup->ivPtr->protection != ITCL_PUBLIC) {
+        return NULL;
+    }
+    for (i = 0; i < tablePtr->numVars; i++) {
+        if (tablePtr->vars[i].ivPtr == vlookup->ivPtr) {
+	    hPtr = Tcl_CreateHashEntry(&tablePtr->names, optName, &isNew);
+	    Tcl_SetHashValue(hPtr, &tablePtr->vars[i]);
+	    return &tablePtr->vars[i];
+	}
+    }
+    return NULL;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclDeleteConfigTable()
+ *
+ *  Discards the config table of a class, if it has one.
+ * ------------------------------------------------------------------------
+ */
+void
+ItclDeleteConfigTable(
+    ItclClass *iclsPtr)       /* class definition */
+{
+    ItclConfigTable *tablePtr;
+    int i;
+
+    tablePtr = iclsPtr->configTablePtr;
+    if (tablePtr == NULL) {
+        return;
+    }
+    for (i = 0; i < tablePtr->numVars; i++) {
+        Tcl_DecrRefCount(tablePtr->vars[i].optNamePtr);
+    }
+    ckfree((char *)tablePtr->vars);
+    Tcl_DeleteHashTable(&tablePtr->names);
+    ckfree((char *)tablePtr);
+    iclsPtr->configTablePtr = NULL;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  HierarchyIndex()
+ *
+ *  Returns the position of basePtr in the linearized hierarchy of
+ *  iclsPtr.  Lower positions are more specific.
+ * ------------------------------------------------------------------------
+ */
+static int
+HierarchyIndex(
+    ItclClass *iclsPtr,
+    ItclClass *basePtr)
+{
+    int i;
+
+    if (iclsPtr->hierarchy == NULL) {
+        BuildHierarchy(iclsPtr);
+    }
+    for (i = 0; i < iclsPtr->hierarchySize; i++) {
+        if (iclsPtr->hierarchy[i] == basePtr) {
+            break;
+        }
+    }
+    return i;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  EnterFunctionName()
+ *
+ *  Enters one name of the member function imPtr into the command
+ *  resolution tables of iclsPtr.  The key object is shared, not
+ *  copied.  If the name is already taken, it is only redirected to
+ *  imPtr when "override" is set and imPtr comes from a more specific
+ *  class than the current holder.
+ * ------------------------------------------------------------------------
+ */
+static void
+EnterFunctionName(
+    ItclClass *iclsPtr,
+    Tcl_Obj *keyPtr,
+    ItclMemberFunc *imPtr,
+    int override)
+{
+    Tcl_HashEntry *hPtr;
+    ItclCmdLookup *clookupPtr;
+    int newEntry;
+
+    hPtr = Tcl_CreateHashEntry(&iclsPtr->resolveCmds, (char *)keyPtr,
+            &newEntry);
+    if (newEntry) {
+        clookupPtr = (ItclCmdLookup *)ItclPoolAlloc(iclsPtr->infoPtr,
+                sizeof(ItclCmdLookup));
+        memset(clookupPtr, 0, sizeof(ItclCmdLookup));
+        clookupPtr->imPtr = imPtr;
+        Tcl_SetHashValue(hPtr, clookupPtr);
+        hPtr = Tcl_CreateHashEntry(&iclsPtr->resolveCmdNames,
+                Tcl_GetString(keyPtr), &newEntry);
+        Tcl_SetHashValue(hPtr, clookupPtr);
+        return;
+    }
+    clookupPtr = (ItclCmdLookup *)Tcl_GetHashValue(hPtr);
+    if (override && (clookupPtr->imPtr != imPtr)
+            && (HierarchyIndex(iclsPtr, imPtr->iclsPtr)
+            < HierarchyIndex(iclsPtr, clookupPtr->imPtr->iclsPtr))) {
+        clookupPtr->imPtr = imPtr;
+    }
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  FunctionNameKeys()
+ *
+ *  Creates the names a member function can be called by:
+ *
+ *     func
+ *     class::func
+ *     namesp1::class::func
+ *     ::namesp1::class::func
+ *
+ *  They are all tails of the fully qualified name, so that string is
+ *  put together once and the keys are cut from it.  Returns the number
+ *  of keys, which hold a reference each.  Release them with
+ *  ReleaseFunctionNameKeys().
+ * ------------------------------------------------------------------------
+ */
+#define ITCL_NUM_STATIC_KEYS 8
+
+static int
+FunctionNameKeys(
+    ItclMemberFunc *imPtr,
+    Tcl_Obj **staticKeys,       /* ITCL_NUM_STATIC_KEYS entries */
+    Tcl_Obj ***keysPtr)
+{
+    Tcl_Namespace *nsPtr;
+    Tcl_DString buffer;
+    Tcl_Obj **keys;
+    const char *name;
+    const char *full;
+    int numKeys, length, nameLength, start, i;
+
+    numKeys = 1;
+    for (nsPtr = imPtr->iclsPtr->nsPtr; nsPtr != NULL;
+            nsPtr = nsPtr->parentPtr) {
+        numKeys++;
+    }
+    keys = staticKeys;
+    if (numKeys > ITCL_NUM_STATIC_KEYS) {
+        keys = (Tcl_Obj **)ckalloc(numKeys * sizeof(Tcl_Obj *));
+    }
+
+    Tcl_DStringInit(&buffer);
+    Tcl_DStringAppend(&buffer, imPtr->iclsPtr->nsPtr->fullName, -1);
+    Tcl_DStringAppend(&buffer, "::", 2);
+    name = Tcl_GetStringFromObj(imPtr->namePtr, &nameLength);
+    Tcl_DStringAppend(&buffer, name, nameLength);
+    full = Tcl_DStringValue(&buffer);
+    length = Tcl_DStringLength(&buffer);
+
+    start = length - nameLength;
+    keys[0] = Tcl_NewStringObj(full + start, length - start);
+    i = 1;
+    for (nsPtr = imPtr->iclsPtr->nsPtr; nsPtr != NULL;
+            nsPtr = nsPtr->parentPtr) {
+        start -= strlen(nsPtr->name) + 2;
+        keys[i++] = Tcl_NewStringObj(full + start, length - start);
+    }
+    for (i = 0; i < numKeys; i++) {
+        Tcl_IncrRefCount(keys[i]);
+    }
+    Tcl_DStringFree(&buffer);
+    *keysPtr = keys;
+    return numKeys;
+}
+
+static void
+ReleaseFunctionNameKeys(
+    Tcl_Obj **staticKeys,
+    Tcl_Obj **keys,
+    int numKeys)
+{
+    int i;
+
+    for (i = 0; i < numKeys; i++) {
+        Tcl_DecrRefCount(keys[i]);
+    }
+    if (keys != staticKeys) {
+        ckfree((char *)keys);
+    }
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  EnterClassFunctions()
+ *
+ *  Enters the names of all member functions defined in fromPtr into
+ *  the command resolution tables of iclsPtr.  Names already taken
+ *  are left alone.
+ * ------------------------------------------------------------------------
+ */
+static void
+EnterClassFunctions(
+    ItclClass *iclsPtr,
+    ItclClass *fromPtr)
+{
+    Tcl_HashEntry *hPtr;
+    Tcl_HashSearch place;
+    ItclMemberFunc *imPtr;
+    Tcl_Obj *staticKeys[ITCL_NUM_STATIC_KEYS];
+    Tcl_Obj **keys;
+    int numKeys, i;
+
+    hPtr = Tcl_FirstHashEntry(&fromPtr->functions, &place);
+    while (hPtr) {
+        imPtr = (ItclMemberFunc*)Tcl_GetHashValue(hPtr);
+        numKeys = FunctionNameKeys(imPtr, staticKeys, &keys);
+        for (i = 0; i < numKeys; i++) {
+            EnterFunctionName(iclsPtr, keys[i], imPtr, 0);
+        }
+        ReleaseFunctionNameKeys(staticKeys, keys, numKeys);
+        hPtr = Tcl_NextHashEntry(&place);
+    }
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  BuildDelegatedTables()
+ *
+ *  Collects the delegated member functions of the whole hierarchy in
+ *  the class, the most specific definition of each name winning.
+ *  Part of Itcl_BuildVirtualTables().
+ * ------------------------------------------------------------------------
+ */
+static void
+BuildDelegatedTables(
+    ItclClass *iclsPtr)
+{
+    Tcl_HashEntry *hPtr;
+    Tcl_HashSearch place;
+    ItclDelegatedFunction *idmPtr;
+    ItclHierIter hier;
+    ItclClass *iclsPtr2;
+    ItclCmdLookup *clookupPtr;
+    int newEntry;
+
+    /*
+     *  Scan through all classes in the hierarchy, from most to
+     *  least specific.  Look for the first (most-specific) definition
+     *  of each delegated member function, and enter it into the table.
+     */
+    Itcl_InitHierIter(&hier, iclsPtr);
+    iclsPtr2 = Itcl_AdvanceHierIter(&hier);
+    while (iclsPtr2 != NULL) {
+        hPtr = Tcl_FirstHashEntry(&iclsPtr2->delegatedFunctions, &place);
+        while (hPtr) {
+            idmPtr = (ItclDelegatedFunction *)Tcl_GetHashValue(hPtr);
+	    hPtr = Tcl_FindHashEntry(&iclsPtr->delegatedFunctions,
+	            (char *)idmPtr->namePtr);
+	    if (hPtr == NULL) {
+	        hPtr = Tcl_CreateHashEntry(&iclsPtr->delegatedFunctions,
+		        (char *)idmPtr->namePtr, &newEntry);
+                Tcl_SetHashValue(hPtr, idmPtr);
+	    }
+            hPtr = Tcl_NextHashEntry(&place);
+        }
+        iclsPtr2 = Itcl_AdvanceHierIter(&hier);
+    }
+    Itcl_DeleteHierIter(&hier);
+
+    /*
+     *  Delegated functions of an extendedclass are dispatched through
+     *  its "unknown" method.  Enter their names into the string keyed
+     *  resolution table, so that the command resolver finds them
+     *  without another lookup.
+     */
+    if (iclsPtr->flags & ITCL_ECLASS) {
+        hPtr = Tcl_FindHashEntry(&iclsPtr->resolveCmdNames, "unknown");
+	if (hPtr != NULL) {
+	    clookupPtr = (ItclCmdLookup *)Tcl_GetHashValue(hPtr);
+	    hPtr = Tcl_FirstHashEntry(&iclsPtr->delegatedFunctions, &place);
+	    while (hPtr) {
+		Tcl_HashEntry *hPtr2;
+
+		idmPtr = (ItclDelegatedFunction *)Tcl_GetHashValue(hPtr);
+		hPtr2 = Tcl_CreateHashEntry(&iclsPtr->resolveCmdNames,
+		        Tcl_GetString(idmPtr->namePtr), &newEntry);
+		if (newEntry) {
+		    Tcl_SetHashValue(hPtr2, clookupPtr);
+		}
+		hPtr = Tcl_NextHashEntry(&place);
+	    }
+	}
+    }
+}
+
 /*
  * ------------------------------------------------------------------------
  *  Itcl_BuildVirtualTables()
@@ -1839,6 +2291,17 @@ ItclResolveVarEntry(
  *  in a derived class may shadow members with the same name in a
  *  base class.  In that case, the simple name in the resolution
  *  table will point to the most-specific member.
+ *
+ *  Only the functions of the class itself are entered name by name.
+ *  The entries for everything inherited are taken over from the
+ *  tables of the base classes, which already hold the result for
+ *  their part of the hierarchy; their key objects are shared.  Once
+ *  built, the tables are kept up to date by ItclAddMemberFuncNames()
+ *  as functions are added, and classes derived from this one are
+ *  rebuilt here as well.
+ *
+ *  The cached instance layout of this class and of all derived
+ *  classes is discarded as well.
  * ------------------------------------------------------------------------
  */
 void
@@ -1847,18 +2310,14 @@ Itcl_BuildVirtualTables(
 {
     Tcl_HashEntry *hPtr;
     Tcl_HashSearch place;
-    Tcl_Namespace* nsPtr;
-    Tcl_DString buffer, buffer2, *bufferC, *bufferC2, *bufferSwp;
-    Tcl_Obj *objPtr;
-    ItclMemberFunc *imPtr;
-    ItclDelegatedFunction *idmPtr;
     ItclHierIter hier;
+    Itcl_ListElem *elem;
+    ItclClass *basePtr;
     ItclClass *iclsPtr2;
     ItclCmdLookup *clookupPtr;
-    int newEntry;
 
-    Tcl_DStringInit(&buffer);
-    Tcl_DStringInit(&buffer2);
+    ItclInvalidateInstanceLayout(iclsPtr);
+    iclsPtr->infoPtr->classEpoch++;
 
     /*
      *  Clear the command resolution table.
@@ -1869,98 +2328,140 @@ Itcl_BuildVirtualTables(
             break;
         }
         clookupPtr = (ItclCmdLookup *)Tcl_GetHashValue(hPtr);
-        ckfree((char *)clookupPtr);
+        ItclPoolFree(iclsPtr->infoPtr, clookupPtr, sizeof(ItclCmdLookup));
 	Tcl_DeleteHashEntry(hPtr);
     }
     Tcl_DeleteHashTable(&iclsPtr->resolveCmds);
+    Tcl_DeleteHashTable(&iclsPtr->resolveCmdNames);
     Tcl_InitObjHashTable(&iclsPtr->resolveCmds);
+    Tcl_InitHashTable(&iclsPtr->resolveCmdNames, TCL_STRING_KEYS);
 
     /*
-     *  Scan through all classes in the hierarchy, from most to
-     *  least specific.  Look for the first (most-specific) definition
-     *  of each member function, and enter it into the table.
+     *  The class itself is the most specific, so its own functions go
+     *  in first.  Then the bases in the order they were inherited,
+     *  each one standing for its whole hierarchy.  The first entry
+     *  for a name wins, which gives the same result as walking the
+     *  linearized hierarchy.  A base whose tables were never built
+     *  is walked class by class instead.
      */
-    Itcl_InitHierIter(&hier, iclsPtr);
-    iclsPtr2 = Itcl_AdvanceHierIter(&hier);
-    while (iclsPtr2 != NULL) {
-        hPtr = Tcl_FirstHashEntry(&iclsPtr2->functions, &place);
-        while (hPtr) {
-            imPtr = (ItclMemberFunc*)Tcl_GetHashValue(hPtr);
-
-            /*
-             *  Create all possible names for this function and enter
-             *  them into the command resolution table:
-             *     func
-             *     class::func
-             *     namesp1::class::func
-             *     namesp2::namesp1::class::func
-             *     ...
-             */
-            Tcl_DStringSetLength(&buffer, 0);
-            Tcl_DStringAppend(&buffer, Tcl_GetString(imPtr->namePtr), -1);
-            bufferC = &buffer; bufferC2 = &buffer2;
-            nsPtr = iclsPtr2->nsPtr;
-
-            while (1) {
-		objPtr = Tcl_NewStringObj(Tcl_DStringValue(bufferC),
-				Tcl_DStringLength(bufferC));
-                hPtr = Tcl_CreateHashEntry(&iclsPtr->resolveCmds,
-                        (char *)objPtr, &newEntry);
-
-                if (newEntry) {
-		    clookupPtr = (ItclCmdLookup *)ckalloc(sizeof(ItclCmdLookup));
-		    memset(clookupPtr, 0, sizeof(ItclCmdLookup));
-		    clookupPtr->imPtr = imPtr;
-                    Tcl_SetHashValue(hPtr, clookupPtr);
-                } else {
-		    Tcl_DecrRefCount(objPtr);
-		}
-
-                if (nsPtr == NULL) {
-                    break;
-                }
-
-                Tcl_DStringSetLength(bufferC2, 0);
-                Tcl_DStringAppend(bufferC2, nsPtr->name, -1);
-                Tcl_DStringAppend(bufferC2, "::", 2);
-                Tcl_DStringAppend(bufferC2, Tcl_DStringValue(bufferC),
-				Tcl_DStringLength(bufferC));
-                bufferSwp = bufferC; bufferC = bufferC2; bufferC2 = bufferSwp;
-
-                nsPtr = nsPtr->parentPtr;
+    EnterClassFunctions(iclsPtr, iclsPtr);
+    elem = Itcl_FirstListElem(&iclsPtr->bases);
+    while (elem != NULL) {
+        basePtr = (ItclClass *)Itcl_GetListValue(elem);
+        if (basePtr->flags & ITCL_CLASS_VTABLES_BUILT) {
+            hPtr = Tcl_FirstHashEntry(&basePtr->resolveCmds, &place);
+            while (hPtr) {
+                clookupPtr = (ItclCmdLookup *)Tcl_GetHashValue(hPtr);
+                EnterFunctionName(iclsPtr,
+                        (Tcl_Obj *)Tcl_GetHashKey(&basePtr->resolveCmds, hPtr),
+                        clookupPtr->imPtr, 0);
+                hPtr = Tcl_NextHashEntry(&place);
             }
-            hPtr = Tcl_NextHashEntry(&place);
+        } else {
+            Itcl_InitHierIter(&hier, basePtr);
+            while ((iclsPtr2 = Itcl_AdvanceHierIter(&hier)) != NULL) {
+                EnterClassFunctions(iclsPtr, iclsPtr2);
+            }
+            Itcl_DeleteHierIter(&hier);
         }
-        iclsPtr2 = Itcl_AdvanceHierIter(&hier);
+        elem = Itcl_NextListElem(elem);
     }
-    Itcl_DeleteHierIter(&hier);
+    iclsPtr->flags |= ITCL_CLASS_VTABLES_BUILT;
+
+    BuildDelegatedTables(iclsPtr);
 
     /*
-     *  Scan through all classes in the hierarchy, from most to
-     *  least specific.  Look for the first (most-specific) definition
-     *  of each delegated member function, and enter it into the table.
+     *  Derived classes took their entries from this table.
      */
-    Itcl_InitHierIter(&hier, iclsPtr);
-    iclsPtr2 = Itcl_AdvanceHierIter(&hier);
-    while (iclsPtr2 != NULL) {
-        hPtr = Tcl_FirstHashEntry(&iclsPtr2->delegatedFunctions, &place);
-        while (hPtr) {
-            idmPtr = (ItclDelegatedFunction *)Tcl_GetHashValue(hPtr);
-	    hPtr = Tcl_FindHashEntry(&iclsPtr->delegatedFunctions,
-	            (char *)idmPtr->namePtr);
-	    if (hPtr == NULL) {
-	        hPtr = Tcl_CreateHashEntry(&iclsPtr->delegatedFunctions,
-		        (char *)idmPtr->namePtr, &newEntry);
-                Tcl_SetHashValue(hPtr, idmPtr);
-	    }
-            hPtr = Tcl_NextHashEntry(&place);
+    elem = Itcl_FirstListElem(&iclsPtr->derived);
+    while (elem != NULL) {
+        iclsPtr2 = (ItclClass *)Itcl_GetListValue(elem);
+        if (iclsPtr2->flags & ITCL_CLASS_VTABLES_BUILT) {
+            Itcl_BuildVirtualTables(iclsPtr2);
         }
-        iclsPtr2 = Itcl_AdvanceHierIter(&hier);
+        elem = Itcl_NextListElem(elem);
     }
-    Itcl_DeleteHierIter(&hier);
+}
 
-    Tcl_DStringFree(&buffer);
-    Tcl_DStringFree(&buffer2);
+/*
+ * ------------------------------------------------------------------------
+ *  ItclFinishVirtualTables()
+ *
+ *  Called at the end of a class definition.  Builds the member lookup
+ *  tables if that has not happened yet.  Otherwise the functions
+ *  defined since then are in already, and only the delegated
+ *  functions are collected.
+ * ------------------------------------------------------------------------
+ */
+void
+ItclFinishVirtualTables(
+    ItclClass *iclsPtr)
+{
+    if (!(iclsPtr->flags & ITCL_CLASS_VTABLES_BUILT)) {
+        Itcl_BuildVirtualTables(iclsPtr);
+        return;
+    }
+    ItclInvalidateInstanceLayout(iclsPtr);
+    iclsPtr->infoPtr->classEpoch++;
+    BuildDelegatedTables(iclsPtr);
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  AddFunctionNames()
+ *
+ *  Enters the names of imPtr into iclsPtr and all classes derived
+ *  from it whose tables have been built.
+ * ------------------------------------------------------------------------
+ */
+static void
+AddFunctionNames(
+    ItclClass *iclsPtr,
+    ItclMemberFunc *imPtr,
+    Tcl_Obj **keys,
+    int numKeys)
+{
+    Itcl_ListElem *elem;
+    int i;
+
+    if (!(iclsPtr->flags & ITCL_CLASS_VTABLES_BUILT)) {
+        return;
+    }
+    for (i = 0; i < numKeys; i++) {
+        EnterFunctionName(iclsPtr, keys[i], imPtr, 1);
+    }
+    elem = Itcl_FirstListElem(&iclsPtr->derived);
+    while (elem != NULL) {
+        AddFunctionNames((ItclClass *)Itcl_GetListValue(elem), imPtr,
+                keys, numKeys);
+        elem = Itcl_NextListElem(elem);
+    }
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclAddMemberFuncNames()
+ *
+ *  Called when a member function is created.  If the lookup tables of
+ *  its class are built already, enters the new function into them and
+ *  into those of the derived classes, instead of rebuilding them.
+ * ------------------------------------------------------------------------
+ */
+void
+ItclAddMemberFuncNames(
+    ItclMemberFunc *imPtr)
+{
+    Tcl_Obj *staticKeys[ITCL_NUM_STATIC_KEYS];
+    Tcl_Obj **keys;
+    int numKeys;
+
+    if (!(imPtr->iclsPtr->flags & ITCL_CLASS_VTABLES_BUILT)) {
+        return;
+    }
+    numKeys = FunctionNameKeys(imPtr, staticKeys, &keys);
+    AddFunctionNames(imPtr->iclsPtr, imPtr, keys, numKeys);
+    ReleaseFunctionNameKeys(staticKeys, keys, numKeys);
+    imPtr->iclsPtr->infoPtr->classEpoch++;
 }
 
 
@@ -2028,6 +2529,7 @@ Itcl_CreateVariable(
     ivPtr = (ItclVariable*)Itcl_Alloc(sizeof(ItclVariable));
     ivPtr->iclsPtr      = iclsPtr;
     ivPtr->infoPtr      = iclsPtr->infoPtr;
+    ivPtr->slot         = iclsPtr->numVarSlots++;
     ivPtr->protection   = Itcl_Protection(interp, 0);
     ivPtr->codePtr      = mCodePtr;
     ivPtr->namePtr      = namePtr;
@@ -2052,6 +2554,7 @@ Itcl_CreateVariable(
     Tcl_SetHashValue(hPtr, ivPtr);
     Itcl_PreserveData(ivPtr);
     Itcl_EventuallyFree(ivPtr, (Tcl_FreeProc *) Itcl_DeleteVariable);
+    ItclInvalidateInstanceLayout(iclsPtr);
 
     *ivPtrPtr = ivPtr;
     return TCL_OK;
@@ -2095,7 +2598,7 @@ Itcl_CreateOption(
         return TCL_ERROR;
     }
 
-    iclsPtr->numOptions++;
+    ioptPtr->slot = iclsPtr->numOptions++;
     ioptPtr->iclsPtr = iclsPtr;
     ioptPtr->codePtr = NULL;
     ioptPtr->fullNamePtr = Tcl_NewStringObj(
@@ -2285,13 +2788,136 @@ Itcl_GetCommonVar(
 }
 
 
+/*
+ * ------------------------------------------------------------------------
+ *  BuildHierarchy()
+ *
+ *  Computes the linearized hierarchy of a class:  the class itself,
+ *  followed by the hierarchies of its base classes in the order they
+ *  were inherited.  This is the depth-first order in which the class
+ *  hierarchy has always been traversed.  The result is cached in the
+ *  class until ItclInvalidateHierarchy() is called.
+ * ------------------------------------------------------------------------
+ */
+static void
+BuildHierarchy(
+    ItclClass *iclsPtr)   /* class definition */
+{
+    Itcl_ListElem *elem;
+    ItclClass *basePtr;
+    int size;
+
+    size = 1;
+    for (elem = Itcl_FirstListElem(&iclsPtr->bases); elem != NULL;
+            elem = Itcl_NextListElem(elem)) {
+        basePtr = (ItclClass *)Itcl_GetListValue(elem);
+        if (basePtr->hierarchy == NULL) {
+            BuildHierarchy(basePtr);
+        }
+        size += basePtr->hierarchySize;
+    }
+
+    iclsPtr->hierarchy = (ItclClass **)ckalloc(size * sizeof(ItclClass *));
+    iclsPtr->hierarchy[0] = iclsPtr;
+    size = 1;
+    for (elem = Itcl_FirstListElem(&iclsPtr->bases); elem != NULL;
+            elem = Itcl_NextListElem(elem)) {
+        basePtr = (ItclClass *)Itcl_GetListValue(elem);
+        memcpy(iclsPtr->hierarchy + size, basePtr->hierarchy,
+                basePtr->hierarchySize * sizeof(ItclClass *));
+        size += basePtr->hierarchySize;
+    }
+    iclsPtr->hierarchySize = size;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclInvalidateHierarchy()
+ *
+ *  Discards the linearized hierarchy of a class and of all classes
+ *  derived from it.  Called whenever the list of base classes changes
+ *  and when the class goes away.
+ * ------------------------------------------------------------------------
+ */
+void
+ItclInvalidateHierarchy(
+    ItclClass *iclsPtr)   /* class definition */
+{
+    Itcl_ListElem *elem;
+
+    if (iclsPtr->hierarchy == NULL) {
+        return;
+    }
+    ckfree((char *)iclsPtr->hierarchy);
+    iclsPtr->hierarchy = NULL;
+    iclsPtr->hierarchySize = 0;
+    if (iclsPtr->ancestorBits != NULL) {
+        ckfree((char *)iclsPtr->ancestorBits);
+        iclsPtr->ancestorBits = NULL;
+        iclsPtr->ancestorWords = 0;
+    }
+    for (elem = Itcl_FirstListElem(&iclsPtr->derived); elem != NULL;
+            elem = Itcl_NextListElem(elem)) {
+        ItclInvalidateHierarchy((ItclClass *)Itcl_GetListValue(elem));
+    }
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclClassIsa()
+ *
+ *  Checks whether basePtr appears anywhere in the hierarchy of
+ *  iclsPtr, including iclsPtr itself.  This is the same question as
+ *  a lookup in iclsPtr->heritage, but answered from a bitset indexed
+ *  by class id which is built from the cached hierarchy on first use.
+ *
+ *  Returns non-zero if iclsPtr "is-a" basePtr, and zero otherwise.
+ * ------------------------------------------------------------------------
+ */
+int
+ItclClassIsa(
+    ItclClass *iclsPtr,   /* class being tested */
+    ItclClass *basePtr)   /* class to test for "is-a" relationship */
+{
+    int i;
+    int id;
+
+    if (iclsPtr->ancestorBits == NULL) {
+        if (iclsPtr->hierarchy == NULL) {
+            BuildHierarchy(iclsPtr);
+        }
+        id = 0;
+        for (i = 0; i < iclsPtr->hierarchySize; i++) {
+            if (iclsPtr->hierarchy[i]->classId > id) {
+                id = iclsPtr->hierarchy[i]->classId;
+            }
+        }
+        iclsPtr->ancestorWords = id / 32 + 1;
+        iclsPtr->ancestorBits = (unsigned int *)ckalloc(
+                iclsPtr->ancestorWords * sizeof(unsigned int));
+        memset(iclsPtr->ancestorBits, 0,
+                iclsPtr->ancestorWords * sizeof(unsigned int));
+        for (i = 0; i < iclsPtr->hierarchySize; i++) {
+            id = iclsPtr->hierarchy[i]->classId;
+            iclsPtr->ancestorBits[id / 32] |= 1U << (id % 32);
+        }
+    }
+    id = basePtr->classId;
+    return (id / 32 < iclsPtr->ancestorWords)
+            && (iclsPtr->ancestorBits[id / 32] & (1U << (id % 32)));
+}
+
 /*
  * ------------------------------------------------------------------------
  *  Itcl_InitHierIter()
  *
  *  Initializes an iterator for traversing the hierarchy of the given
  *  class.  Subsequent calls to Itcl_AdvanceHierIter() will return
- *  the base classes in order from most-to-least specific.
+ *  the base classes in order from most-to-least specific.  The
+ *  hierarchy cached in the class is copied onto the iterator's own
+ *  stack, so the iterator stays valid if the class graph changes
+ *  while it is used; the stack spills to the heap only for hierarchies
+ *  of more than five classes.
  * ------------------------------------------------------------------------
  */
 void
@@ -2299,11 +2925,21 @@ Itcl_InitHierIter(
     ItclHierIter *iter,   /* iterator used for traversal */
     ItclClass *iclsPtr)   /* class definition for start of traversal */
 {
+    int i;
+
     Itcl_InitStack(&iter->stack);
-    Itcl_PushStack(iclsPtr, &iter->stack);
     iter->current = iclsPtr;
+    if (iclsPtr == NULL) {
+        return;
+    }
+    if (iclsPtr->hierarchy == NULL) {
+        BuildHierarchy(iclsPtr);
+    }
+    for (i = iclsPtr->hierarchySize - 1; i >= 0; i--) {
+        Itcl_PushStack(iclsPtr->hierarchy[i], &iter->stack);
+    }
 }
-
+
 /*
  * ------------------------------------------------------------------------
  *  Itcl_DeleteHierIter()
@@ -2319,7 +2955,7 @@ Itcl_DeleteHierIter(
     Itcl_DeleteStack(&iter->stack);
     iter->current = NULL;
 }
-
+
 /*
  * ------------------------------------------------------------------------
  *  Itcl_AdvanceHierIter()
@@ -2333,26 +2969,10 @@ ItclClass*
 Itcl_AdvanceHierIter(
     ItclHierIter *iter)  /* iterator used for traversal */
 {
-    Itcl_ListElem *elem;
-    ItclClass *iclsPtr;
-
     iter->current = (ItclClass*)Itcl_PopStack(&iter->stack);
-
-    /*
-     *  Push classes onto the stack in reverse order, so that
-     *  they will be popped off in the proper order.
-     */
-    if (iter->current) {
-        iclsPtr = (ItclClass*)iter->current;
-        elem = Itcl_LastListElem(&iclsPtr->bases);
-        while (elem) {
-            Itcl_PushStack(Itcl_GetListValue(elem), &iter->stack);
-            elem = Itcl_PrevListElem(elem);
-        }
-    }
     return iter->current;
 }
-
+
 /*
  * ------------------------------------------------------------------------
  *  Itcl_DeleteVariable()
@@ -2471,6 +3091,9 @@ ItclDeleteFunction(
             Tcl_DeleteHashEntry(hPtr);
         }
     }
+    if (imPtr->profilePtr != NULL) {
+        ItclProfileForget(imPtr);
+    }
     if (imPtr->codePtr != NULL) {
         Itcl_ReleaseData(imPtr->codePtr);
     }
@@ -387,6 +387,42 @@ Itcl_FindObjectsCmd(
         return TCL_ERROR;
     }
 
+    /*
+     *  With a -class qualifier, only direct instances of that class
+     *  can match, so walk its instance list instead of every command
+     *  in the interpreter.  Names are reported as below:  short names
+     *  for objects in the current namespace, full names otherwise.
+     */
+    if (iclsPtr != NULL) {
+        if ((isaDefn != NULL) && !ItclClassIsa(iclsPtr, isaDefn)) {
+            return TCL_OK;
+        }
+        for (contextIoPtr = iclsPtr->instancesPtr; contextIoPtr != NULL;
+                contextIoPtr = contextIoPtr->nextInstancePtr) {
+            if ((contextIoPtr->accessCmd == NULL)
+                    || !ItclIsLiveObject(contextIoPtr)) {
+                continue;
+            }
+            cmd = contextIoPtr->accessCmd;
+	    Tcl_GetCommandInfoFromToken(cmd, &cmdInfo);
+            if (forceFullNames || cmdInfo.namespacePtr != activeNs) {
+                objPtr = Tcl_NewStringObj(NULL, 0);
+                Tcl_GetCommandFullName(interp, cmd, objPtr);
+            } else {
+                objPtr = Tcl_NewStringObj(Tcl_GetCommandName(interp, cmd),
+                        -1);
+            }
+            if (!pattern || Tcl_StringCaseMatch(Tcl_GetString(objPtr),
+                    pattern, 0)) {
+                Tcl_ListObjAppendElement(NULL, Tcl_GetObjResult(interp),
+                        objPtr);
+            } else {
+                Tcl_DecrRefCount(objPtr);
+            }
+        }
+        return TCL_OK;
+    }
+
     /*
      *  Search through all commands in the current namespace first,
      *  in the global namespace next, then in all child namespaces
@@ -446,16 +482,9 @@ Itcl_FindObjectsCmd(
 			pattern, 0))) {
                     if ((iclsPtr == NULL) ||
 		            (contextIoPtr->iclsPtr == iclsPtr)) {
-                        if (isaDefn == NULL) {
+                        if ((isaDefn == NULL) ||
+                                ItclClassIsa(contextIoPtr->iclsPtr, isaDefn)) {
                             match = 1;
-                        } else {
-                            entry = Tcl_FindHashEntry(
-                                &contextIoPtr->iclsPtr->heritage,
-                                (char*)isaDefn);
-
-                            if (entry) {
-                                match = 1;
-                            }
                         }
                     }
                 }
@@ -644,6 +673,264 @@ Itcl_DelObjectCmd(
 }
 
 
+/*
+ *  Internal representation of the names returned by "itcl::scope", and
+ *  of fully qualified names passed to Itcl_GetScopedVar.  It holds on
+ *  to the variable the name resolved to (the array for an element
+ *  reference), so that it can be reached again without a namespace
+ *  lookup.  The variable is preserved, and the rep is used only in the
+ *  interpreter that resolved it and only while the variable is neither
+ *  dead, which it becomes when its object or namespace is deleted, nor
+ *  turned into a link by "upvar" or "global" after it was unset.
+ */
+typedef struct ItclScopeRep {
+    ItclObjectInfo *infoPtr;    /* interpreter data the name was
+                                 * resolved with */
+    unsigned int interpEpoch;   /* its interpEpoch, in case a later
+                                 * interpreter gets the same address */
+    Tcl_Var var;                /* variable, preserved */
+    int indexOffset;            /* offset of the "(" of an element
+                                 * reference in the string rep, or -1 */
+} ItclScopeRep;
+
+static void FreeScopeRep(Tcl_Obj *objPtr);
+static void DupScopeRep(Tcl_Obj *srcPtr, Tcl_Obj *dupPtr);
+static int ScopeRepIsValid(ItclObjectInfo *infoPtr, Tcl_Obj *objPtr);
+
+static const Tcl_ObjType itclScopedVarType = {
+    "itclScopedVar",
+    FreeScopeRep,
+    DupScopeRep,
+    NULL,
+    NULL
+};
+
+/*
+ *  Free and duplicate procs for the "itclScopedVar" type.  The string
+ *  rep is always kept, so no update proc is needed.
+ */
+static void
+FreeScopeRep(
+    Tcl_Obj *objPtr)
+{
+    ItclScopeRep *repPtr;
+
+    repPtr = (ItclScopeRep *)objPtr->internalRep.twoPtrValue.ptr1;
+    Itcl_ReleaseVar(repPtr->var);
+    ckfree((char *)repPtr);
+    objPtr->typePtr = NULL;
+}
+
+static void
+DupScopeRep(
+    Tcl_Obj *srcPtr,
+    Tcl_Obj *dupPtr)
+{
+    ItclScopeRep *repPtr;
+
+    repPtr = (ItclScopeRep *)ckalloc(sizeof(ItclScopeRep));
+    *repPtr = *(ItclScopeRep *)srcPtr->internalRep.twoPtrValue.ptr1;
+    Itcl_PreserveVar(repPtr->var);
+    dupPtr->internalRep.twoPtrValue.ptr1 = repPtr;
+    dupPtr->internalRep.twoPtrValue.ptr2 = NULL;
+    dupPtr->typePtr = &itclScopedVarType;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  SetScopeRep()
+ *
+ *  Makes objPtr, a fully qualified variable name, remember that it
+ *  names var (or an element of it, if indexOffset is not -1).
+ * ------------------------------------------------------------------------
+ */
+static void
+SetScopeRep(
+    ItclObjectInfo *infoPtr,    /* interpreter data */
+    Tcl_Obj *objPtr,            /* variable name */
+    Tcl_Var var,                /* variable it resolves to */
+    int indexOffset)            /* offset of the element index or -1 */
+{
+    ItclScopeRep *repPtr;
+
+    Itcl_PreserveVar(var);
+    if (objPtr->typePtr == &itclScopedVarType) {
+        repPtr = (ItclScopeRep *)objPtr->internalRep.twoPtrValue.ptr1;
+	Itcl_ReleaseVar(repPtr->var);
+    } else {
+        Tcl_GetString(objPtr);
+        if ((objPtr->typePtr != NULL)
+                && (objPtr->typePtr->freeIntRepProc != NULL)) {
+            objPtr->typePtr->freeIntRepProc(objPtr);
+        }
+        repPtr = (ItclScopeRep *)ckalloc(sizeof(ItclScopeRep));
+        objPtr->internalRep.twoPtrValue.ptr1 = repPtr;
+        objPtr->internalRep.twoPtrValue.ptr2 = NULL;
+        objPtr->typePtr = &itclScopedVarType;
+    }
+    repPtr->infoPtr = infoPtr;
+    repPtr->interpEpoch = infoPtr->interpEpoch;
+    repPtr->var = var;
+    repPtr->indexOffset = indexOffset;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ScopeRepIsValid()
+ *
+ *  Returns 1 if objPtr has an "itclScopedVar" rep that can be used in
+ *  the interpreter of infoPtr, and 0 if the name has to be looked up.
+ * ------------------------------------------------------------------------
+ */
+static int
+ScopeRepIsValid(
+    ItclObjectInfo *infoPtr,    /* interpreter data */
+    Tcl_Obj *objPtr)            /* variable name */
+{
+    ItclScopeRep *repPtr;
+
+    if (objPtr->typePtr != &itclScopedVarType) {
+        return 0;
+    }
+    repPtr = (ItclScopeRep *)objPtr->internalRep.twoPtrValue.ptr1;
+    return (repPtr->infoPtr == infoPtr)
+	    && (repPtr->interpEpoch == infoPtr->interpEpoch)
+            && !Itcl_IsVarDead(repPtr->var)
+	    && !TclIsVarLink((Var *)repPtr->var);
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  Itcl_GetScopedVar()
+ *
+ *  Returns the variable named by objPtr, usually a name returned by
+ *  "itcl::scope".  For an element reference such as "::x(idx)" the
+ *  array is returned, and *indexPtr (if not NULL) is set to the index
+ *  within the string rep of objPtr; otherwise *indexPtr is set to
+ *  NULL.  Names from "itcl::scope" carry the variable with them, so
+ *  no lookup is done unless the variable has gone away since, e.g.
+ *  because its object was deleted, or has been made a link to another
+ *  variable by "upvar".  Other fully qualified names get
+ *  the same rep on their first use.  Returns NULL along with an error
+ *  message in the interpreter if there is no such variable.
+ * ------------------------------------------------------------------------
+ */
+Tcl_Var
+Itcl_GetScopedVar(
+    Tcl_Interp *interp,         /* current interpreter */
+    Tcl_Obj *objPtr,            /* variable name */
+    const char **indexPtr)      /* returns the element index or NULL */
+{
+    ItclObjectInfo *infoPtr;
+    ItclScopeRep *repPtr;
+    Tcl_Var var;
+    const char *name;
+    const char *openParen;
+    int indexOffset;
+    int length;
+
+    infoPtr = (ItclObjectInfo *)Tcl_GetAssocData(interp,
+            ITCL_INTERP_DATA, NULL);
+    name = Tcl_GetStringFromObj(objPtr, &length);
+    if (ScopeRepIsValid(infoPtr, objPtr)) {
+        repPtr = (ItclScopeRep *)objPtr->internalRep.twoPtrValue.ptr1;
+	if (indexPtr != NULL) {
+	    *indexPtr = (repPtr->indexOffset < 0) ? NULL
+		    : name + repPtr->indexOffset + 1;
+	}
+	return repPtr->var;
+    }
+
+    /*
+     *  Look the name up the way Tcl does: a name ending in ")" with
+     *  a "(" before it is an array element.
+     */
+    indexOffset = -1;
+    if ((length > 0) && (name[length-1] == ')')) {
+        openParen = strchr(name, '(');
+	if (openParen != NULL) {
+	    indexOffset = (int)(openParen - name);
+	}
+    }
+    if (indexOffset < 0) {
+        var = Itcl_FindNamespaceVar(interp, name, NULL, 0);
+    } else {
+        Tcl_Obj *arrayNamePtr;
+
+        arrayNamePtr = Tcl_NewStringObj(name, indexOffset);
+	Tcl_IncrRefCount(arrayNamePtr);
+        var = Itcl_FindNamespaceVar(interp, Tcl_GetString(arrayNamePtr),
+	        NULL, 0);
+	Tcl_DecrRefCount(arrayNamePtr);
+    }
+    if (var == NULL) {
+        Tcl_ResetResult(interp);
+        Tcl_AppendResult(interp, "can't find variable \"", name, "\"",
+	        NULL);
+        return NULL;
+    }
+    while (TclIsVarLink((Var *)var)) {
+        var = (Tcl_Var)((Var *)var)->value.linkPtr;
+    }
+    if ((name[0] == ':') && (name[1] == ':')) {
+        SetScopeRep(infoPtr, objPtr, var, indexOffset);
+	name = Tcl_GetString(objPtr);
+    }
+    if (indexPtr != NULL) {
+        *indexPtr = (indexOffset < 0) ? NULL : name + indexOffset + 1;
+    }
+    return var;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclScopedVarCmd()
+ *
+ *  Invoked by Tcl to report what a variable name refers to:
+ *
+ *    ::itcl::internal::commands::scopedvar <name>
+ *
+ *  Returns a list of the fully qualified name of the variable found by
+ *  Itcl_GetScopedVar (with the element index, if any) and a flag that
+ *  is 1 if the variable came from the name's internal representation
+ *  without a lookup.
+ * ------------------------------------------------------------------------
+ */
+int
+ItclScopedVarCmd(
+    ClientData clientData,   /* info for the interpreter */
+    Tcl_Interp *interp,      /* current interpreter */
+    int objc,                /* number of arguments */
+    Tcl_Obj *const objv[])   /* argument objects */
+{
+    ItclObjectInfo *infoPtr = (ItclObjectInfo *)clientData;
+    Tcl_Obj *resultPtr;
+    Tcl_Obj *namePtr;
+    Tcl_Var var;
+    const char *index;
+    int cached;
+
+    if (objc != 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "name");
+        return TCL_ERROR;
+    }
+    cached = ScopeRepIsValid(infoPtr, objv[1]);
+    var = Itcl_GetScopedVar(interp, objv[1], &index);
+    if (var == NULL) {
+        return TCL_ERROR;
+    }
+    namePtr = Tcl_NewObj();
+    Itcl_GetVariableFullName(interp, var, namePtr);
+    if (index != NULL) {
+        Tcl_AppendToObj(namePtr, index - 1, -1);
+    }
+    resultPtr = Tcl_NewListObj(0, NULL);
+    Tcl_ListObjAppendElement(NULL, resultPtr, namePtr);
+    Tcl_ListObjAppendElement(NULL, resultPtr, Tcl_NewIntObj(cached));
+    Tcl_SetObjResult(interp, resultPtr);
+    return TCL_OK;
+}
+
 /*
  * ------------------------------------------------------------------------
  *  Itcl_ScopeCmd()
@@ -666,6 +953,9 @@ Itcl_DelObjectCmd(
  *  a name in a format that Tcl can use to find the same variable from
  *  any context.
  *
+ *  The name returned remembers the variable it names, see
+ *  Itcl_GetScopedVar.
+ *
  *  Returns TCL_OK/TCL_ERROR to indicate success/failure.
  * ------------------------------------------------------------------------
  */
@@ -680,7 +970,7 @@ Itcl_ScopeCmd(
     Tcl_Namespace *contextNsPtr;
     Tcl_HashEntry *hPtr;
     Tcl_Object oPtr;
-    Tcl_Obj *objPtr2;
+    Tcl_Obj *resultPtr;
     Tcl_Var var;
     Tcl_HashEntry *entry;
     ItclClass *contextIclsPtr;
@@ -690,6 +980,7 @@ Itcl_ScopeCmd(
     char *openParen;
     char *p;
     char *token;
+    int indexOffset;
     int doAppend;
     int result;
     (void)dummy;
@@ -744,6 +1035,9 @@ Itcl_ScopeCmd(
     contextIoPtr = NULL;
     contextIclsPtr = NULL;
     oPtr = NULL;
+    var = NULL;
+    resultPtr = Tcl_NewObj();
+    Tcl_IncrRefCount(resultPtr);
     infoPtr = (ItclObjectInfo *)Tcl_GetAssocData(interp, ITCL_INTERP_DATA, NULL);
     hPtr = Tcl_FindHashEntry(&infoPtr->namespaceClasses, (char *)contextNsPtr);
     if (hPtr != NULL) {
@@ -764,18 +1058,16 @@ Itcl_ScopeCmd(
         vlookup = (ItclVarLookup*)Tcl_GetHashValue(entry);
 
         if (vlookup->ivPtr->flags & ITCL_COMMON) {
-            Tcl_Obj *resultPtr = Tcl_GetObjResult(interp);
 	    if (vlookup->ivPtr->protection != ITCL_PUBLIC) {
 	        Tcl_AppendToObj(resultPtr, ITCL_VARIABLES_NAMESPACE, -1);
 	    }
 	    Tcl_AppendToObj(resultPtr,
 		    Tcl_GetString(vlookup->ivPtr->fullNamePtr), -1);
-            if (openParen) {
-                *openParen = '(';
-                Tcl_AppendToObj(resultPtr, openParen, -1);
-                openParen = NULL;
-            }
-            result = TCL_OK;
+	    hPtr = Tcl_FindHashEntry(&vlookup->ivPtr->iclsPtr->classCommons,
+	            (char *)vlookup->ivPtr);
+	    if (hPtr != NULL) {
+	        var = (Tcl_Var)Tcl_GetHashValue(hPtr);
+	    }
             goto scopeCmdDone;
         }
 
@@ -814,29 +1106,19 @@ Itcl_ScopeCmd(
             }
         }
 
-        objPtr2 = Tcl_NewStringObj(NULL, 0);
-        Tcl_IncrRefCount(objPtr2);
-	Tcl_AppendToObj(objPtr2, ITCL_VARIABLES_NAMESPACE, -1);
-	Tcl_AppendToObj(objPtr2,
+	Tcl_AppendToObj(resultPtr, ITCL_VARIABLES_NAMESPACE, -1);
+	Tcl_AppendToObj(resultPtr,
 		(Tcl_GetObjectNamespace(contextIoPtr->oPtr))->fullName, -1);
 
         if (doAppend) {
-            Tcl_AppendToObj(objPtr2,
+            Tcl_AppendToObj(resultPtr,
 	            Tcl_GetString(vlookup->ivPtr->fullNamePtr), -1);
+	    var = ItclGetObjectVar(contextIoPtr, vlookup->ivPtr);
         } else {
-            Tcl_AppendToObj(objPtr2, "::", -1);
-            Tcl_AppendToObj(objPtr2,
+            Tcl_AppendToObj(resultPtr, "::", -1);
+            Tcl_AppendToObj(resultPtr,
 	            Tcl_GetString(vlookup->ivPtr->namePtr), -1);
 	}
-
-        if (openParen) {
-            *openParen = '(';
-            Tcl_AppendToObj(objPtr2, openParen, -1);
-            openParen = NULL;
-        }
-        /* fix for SF bug #238 use Tcl_AppendResult instead of Tcl_AppendElement */
-        Tcl_AppendResult(interp, Tcl_GetString(objPtr2), NULL);
-        Tcl_DecrRefCount(objPtr2);
     } else {
 
         /*
@@ -848,8 +1130,6 @@ Itcl_ScopeCmd(
          *    careful to add the index (everything from openParen
          *    onward) as well.
          */
-        Tcl_Obj *resultPtr = Tcl_GetObjResult(interp);
-
         var = Itcl_FindNamespaceVar(interp, token, contextNsPtr,
             TCL_NAMESPACE_ONLY);
 
@@ -863,14 +1143,23 @@ Itcl_ScopeCmd(
         }
 
         Itcl_GetVariableFullName(interp, var, resultPtr);
+    }
+
+scopeCmdDone:
+    if (result == TCL_OK) {
+        indexOffset = -1;
         if (openParen) {
             *openParen = '(';
+	    Tcl_GetStringFromObj(resultPtr, &indexOffset);
             Tcl_AppendToObj(resultPtr, openParen, -1);
             openParen = NULL;
         }
+	if ((var != NULL) && !Itcl_IsVarDead(var)) {
+	    SetScopeRep(infoPtr, resultPtr, var, indexOffset);
+	}
+	Tcl_SetObjResult(interp, resultPtr);
     }
-
-scopeCmdDone:
+    Tcl_DecrRefCount(resultPtr);
     if (openParen) {
         *openParen = '(';
     }
@@ -895,6 +1184,10 @@ scopeCmdDone:
  *  Tcl, but it preserves the list structure of the input arguments,
  *  so it is a lot more useful.
  *
+ *  All results share the "namespace" and "inscope" words, and those
+ *  made in the same class share the namespace word, so that Tcl
+ *  resolves them once and not once per callback.
+ *
  *  Returns TCL_OK/TCL_ERROR to indicate success/failure.
  * ------------------------------------------------------------------------
  */
@@ -908,8 +1201,10 @@ Itcl_CodeCmd(
 {
     Tcl_Namespace *contextNs = Tcl_GetCurrentNamespace(interp);
 
+    Tcl_HashEntry *hPtr;
     Tcl_Obj *listPtr;
     Tcl_Obj *objPtr;
+    ItclObjectInfo *infoPtr;
     const char *token;
     int pos;
     (void)dummy;
@@ -963,14 +1258,17 @@ Itcl_CodeCmd(
      *  current namespace context, and appending the remaining
      *  arguments AS A LIST...
      */
+    infoPtr = (ItclObjectInfo *)Tcl_GetAssocData(interp,
+            ITCL_INTERP_DATA, NULL);
     listPtr = Tcl_NewListObj(0, NULL);
 
-    Tcl_ListObjAppendElement(interp, listPtr,
-        Tcl_NewStringObj("namespace", -1));
-    Tcl_ListObjAppendElement(interp, listPtr,
-        Tcl_NewStringObj("inscope", -1));
+    Tcl_ListObjAppendElement(interp, listPtr, infoPtr->namespaceWordPtr);
+    Tcl_ListObjAppendElement(interp, listPtr, infoPtr->inscopeWordPtr);
 
-    if (contextNs == Tcl_GetGlobalNamespace(interp)) {
+    hPtr = Tcl_FindHashEntry(&infoPtr->namespaceClasses, (char *)contextNs);
+    if (hPtr != NULL) {
+        objPtr = ((ItclClass *)Tcl_GetHashValue(hPtr))->fullNamePtr;
+    } else if (contextNs == Tcl_GetGlobalNamespace(interp)) {
         objPtr = Tcl_NewStringObj("::", -1);
     } else {
         objPtr = Tcl_NewStringObj(contextNs->fullName, -1);
@@ -987,7 +1285,305 @@ Itcl_CodeCmd(
     return TCL_OK;
 }
 
+/*
+ *  Internal representation of the instance word of the callbacks made
+ *  by mymethod, "::itcl::builtin::callinstance <instance> ...".  It
+ *  holds on to the object's access command, so that callinstance can
+ *  go straight to the object without looking up the instance name and
+ *  the command name.  It is used only until the command is deleted,
+ *  after that the instance name is looked up again.
+ */
+typedef struct ItclCallbackRep {
+    Tcl_Command accessCmd;      /* object access command, held */
+    Tcl_Obj *cmdNamePtr;        /* name of the command when last used */
+} ItclCallbackRep;
+
+static void FreeCallbackRep(Tcl_Obj *objPtr);
+static void DupCallbackRep(Tcl_Obj *srcPtr, Tcl_Obj *dupPtr);
+
+static const Tcl_ObjType itclCallbackType = {
+    "itclCallback",
+    FreeCallbackRep,
+    DupCallbackRep,
+    NULL,
+    NULL
+};
+
+/*
+ *  Free and duplicate procs for the "itclCallback" type.  The string
+ *  rep is always kept, so no update proc is needed.
+ */
+static void
+FreeCallbackRep(
+    Tcl_Obj *objPtr)
+{
+    ItclCallbackRep *repPtr;
+    Command *cmdPtr;
+
+    repPtr = (ItclCallbackRep *)objPtr->internalRep.twoPtrValue.ptr1;
+    cmdPtr = (Command *)repPtr->accessCmd;
+    TclCleanupCommandMacro(cmdPtr);
+    Tcl_DecrRefCount(repPtr->cmdNamePtr);
+    ckfree((char *)repPtr);
+    objPtr->typePtr = NULL;
+}
+
+static void
+DupCallbackRep(
+    Tcl_Obj *srcPtr,
+    Tcl_Obj *dupPtr)
+{
+    ItclCallbackRep *repPtr;
+
+    repPtr = (ItclCallbackRep *)ckalloc(sizeof(ItclCallbackRep));
+    *repPtr = *(ItclCallbackRep *)srcPtr->internalRep.twoPtrValue.ptr1;
+    ((Command *)repPtr->accessCmd)->refCount++;
+    Tcl_IncrRefCount(repPtr->cmdNamePtr);
+    dupPtr->internalRep.twoPtrValue.ptr1 = repPtr;
+    dupPtr->internalRep.twoPtrValue.ptr2 = NULL;
+    dupPtr->typePtr = &itclCallbackType;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  SetCallbackRep()
+ *
+ *  Makes the instance name objPtr remember the access command of its
+ *  object, and returns the internal rep.
+ * ------------------------------------------------------------------------
+ */
+static ItclCallbackRep *
+SetCallbackRep(
+    Tcl_Interp *interp,         /* interpreter of the object */
+    Tcl_Obj *objPtr,            /* instance name */
+    Tcl_Command accessCmd)      /* object access command */
+{
+    ItclCallbackRep *repPtr;
+
+    Tcl_GetString(objPtr);
+    if ((objPtr->typePtr != NULL)
+            && (objPtr->typePtr->freeIntRepProc != NULL)) {
+        objPtr->typePtr->freeIntRepProc(objPtr);
+    }
+    repPtr = (ItclCallbackRep *)ckalloc(sizeof(ItclCallbackRep));
+    repPtr->accessCmd = accessCmd;
+    ((Command *)accessCmd)->refCount++;
+    repPtr->cmdNamePtr = Tcl_NewObj();
+    Tcl_GetCommandFullName(interp, accessCmd, repPtr->cmdNamePtr);
+    Tcl_IncrRefCount(repPtr->cmdNamePtr);
+    objPtr->internalRep.twoPtrValue.ptr1 = repPtr;
+    objPtr->internalRep.twoPtrValue.ptr2 = NULL;
+    objPtr->typePtr = &itclCallbackType;
+    return repPtr;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclCallbackInstanceObj()
+ *
+ *  Returns the instance name for the callbacks of object ioPtr, the
+ *  name of the object's namespace.  The object keeps one such name
+ *  for all its callbacks, which knows the object's access command.
+ * ------------------------------------------------------------------------
+ */
+Tcl_Obj *
+ItclCallbackInstanceObj(
+    ItclObject *ioPtr)          /* object the callbacks are for */
+{
+    if (ioPtr->callbackNamePtr == NULL) {
+        ioPtr->callbackNamePtr = Tcl_NewStringObj(
+	        Tcl_GetObjectNamespace(ioPtr->oPtr)->fullName, -1);
+	Tcl_IncrRefCount(ioPtr->callbackNamePtr);
+    }
+    if ((ioPtr->callbackNamePtr->typePtr != &itclCallbackType)
+            && (ioPtr->accessCmd != NULL)) {
+        SetCallbackRep(ioPtr->interp, ioPtr->callbackNamePtr,
+	        ioPtr->accessCmd);
+    }
+    return ioPtr->callbackNamePtr;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclGetCallbackCommand()
+ *
+ *  Returns the name of the access command of the object with instance
+ *  name instNamePtr, or NULL if there is no such object.  The name is
+ *  owned by instNamePtr and stays valid as long as its internal rep,
+ *  callers that evaluate it must hold a reference.  If instNamePtr
+ *  already knows the command and the command still exists, neither
+ *  the object nor the command is looked up by name, and the command
+ *  name resolves from its own cache.
+ * ------------------------------------------------------------------------
+ */
+Tcl_Obj *
+ItclGetCallbackCommand(
+    Tcl_Interp *interp,         /* current interpreter */
+    ItclObjectInfo *infoPtr,    /* info for the interpreter */
+    Tcl_Obj *instNamePtr)       /* instance name */
+{
+    Tcl_HashEntry *hPtr;
+    ItclCallbackRep *repPtr;
+    ItclObject *ioPtr;
+    Command *cmdPtr;
+
+    if (instNamePtr->typePtr == &itclCallbackType) {
+        repPtr = (ItclCallbackRep *)instNamePtr->internalRep.twoPtrValue.ptr1;
+	cmdPtr = (Command *)repPtr->accessCmd;
+	if (!(cmdPtr->flags & CMD_IS_DELETED)
+	        && ((Tcl_Interp *)cmdPtr->nsPtr->interp == interp)) {
+	    if (Tcl_GetCommandFromObj(interp, repPtr->cmdNamePtr)
+	            != repPtr->accessCmd) {
+		/*
+		 *  The object was renamed.
+		 */
+		Tcl_DecrRefCount(repPtr->cmdNamePtr);
+		repPtr->cmdNamePtr = Tcl_NewObj();
+		Tcl_GetCommandFullName(interp, repPtr->accessCmd,
+		        repPtr->cmdNamePtr);
+		Tcl_IncrRefCount(repPtr->cmdNamePtr);
+	    }
+	    return repPtr->cmdNamePtr;
+	}
+    }
+
+    hPtr = Tcl_FindHashEntry(&infoPtr->instances, Tcl_GetString(instNamePtr));
+    if (hPtr == NULL) {
+        return NULL;
+    }
+    ioPtr = (ItclObject *)Tcl_GetHashValue(hPtr);
+    if (ioPtr->accessCmd == NULL) {
+        return NULL;
+    }
+    repPtr = SetCallbackRep(interp, instNamePtr, ioPtr->accessCmd);
+    return repPtr->cmdNamePtr;
+}
+
 
+/*
+ * ------------------------------------------------------------------------
+ *  LocalUnsetTrace()
+ *
+ *  Unset trace on the variable made by "itcl::local".  Deletes the
+ *  object, unless it is already being deleted or the interpreter is
+ *  going away, and lets go of its access command.
+ * ------------------------------------------------------------------------
+ */
+static char *
+LocalUnsetTrace(
+    ClientData clientData,   /* object access command, held */
+    Tcl_Interp *interp,      /* interpreter of the variable */
+    const char *name1,       /* variable name (unused) */
+    const char *name2,       /* element name (unused) */
+    int flags)               /* trace flags */
+{
+    Command *cmdPtr = (Command *)clientData;
+    Tcl_HashEntry *hPtr;
+    Itcl_InterpState state;
+    ItclObjectInfo *infoPtr;
+    ItclObject *ioPtr;
+    (void)name1;
+    (void)name2;
+
+    if (!(flags & TCL_INTERP_DESTROYED)
+            && !(cmdPtr->flags & CMD_IS_DELETED)) {
+        infoPtr = (ItclObjectInfo *)Tcl_GetAssocData(interp,
+	        ITCL_INTERP_DATA, NULL);
+	hPtr = Tcl_FindHashEntry(&infoPtr->objectCmds, (char *)cmdPtr);
+	if (hPtr != NULL) {
+	    ioPtr = (ItclObject *)Tcl_GetHashValue(hPtr);
+	    if (!ioPtr->destructorHasBeenCalled
+	            && !(ioPtr->flags & ITCL_OBJECT_IS_DELETED)) {
+		/*
+		 *  The frame may be going away on return from a
+		 *  procedure, keep its result.
+		 */
+		state = Itcl_SaveInterpState(interp, TCL_OK);
+		Itcl_DeleteObject(interp, ioPtr);
+		Itcl_RestoreInterpState(interp, state);
+	    }
+	}
+    }
+    TclCleanupCommandMacro(cmdPtr);
+    return NULL;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  Itcl_LocalCmd()
+ *
+ *  Invoked by Tcl whenever the user issues a "local" command to
+ *  create an object that lives as long as the current call frame.
+ *  Handles the following syntax:
+ *
+ *    local <className> <objName> ?<arg> <arg>...?
+ *
+ *  Creates the object in the current frame, then sets the variable
+ *  "itcl-local-<objName>" in that frame and puts an unset trace on it.
+ *  When the frame goes away (or the variable is unset), the trace
+ *  deletes the object.  The trace holds on to the object's access
+ *  command, so neither the object nor the command is looked up by name
+ *  again.
+ *
+ *  Returns TCL_OK/TCL_ERROR to indicate success/failure.
+ * ------------------------------------------------------------------------
+ */
+/* ARGSUSED */
+int
+Itcl_LocalCmd(
+    ClientData dummy,        /* unused */
+    Tcl_Interp *interp,      /* current interpreter */
+    int objc,                /* number of arguments */
+    Tcl_Obj *const objv[])   /* argument objects */
+{
+    Tcl_Obj *objNamePtr;
+    Tcl_Obj *varNamePtr;
+    Tcl_Command cmd;
+    const char *varName;
+    int result;
+    (void)dummy;
+
+    ItclShowArgs(1, "Itcl_LocalCmd", objc, objv);
+    if (objc < 3) {
+        Tcl_WrongNumArgs(interp, 1, objv, "class name ?arg ...?");
+        return TCL_ERROR;
+    }
+
+    result = Tcl_EvalObjv(interp, objc-1, objv+1, 0);
+    if (result != TCL_OK) {
+        return result;
+    }
+    objNamePtr = Tcl_GetObjResult(interp);
+    Tcl_IncrRefCount(objNamePtr);
+    varNamePtr = Tcl_NewStringObj("itcl-local-", -1);
+    Tcl_AppendObjToObj(varNamePtr, objNamePtr);
+    Tcl_IncrRefCount(varNamePtr);
+    if (Tcl_ObjSetVar2(interp, varNamePtr, NULL, objNamePtr,
+            TCL_LEAVE_ERR_MSG) == NULL) {
+        result = TCL_ERROR;
+	goto localCmdDone;
+    }
+    cmd = Tcl_GetCommandFromObj(interp, objNamePtr);
+    if (cmd != NULL) {
+        varName = Tcl_GetString(varNamePtr);
+	((Command *)cmd)->refCount++;
+	if (Tcl_TraceVar2(interp, varName, NULL,
+		TCL_TRACE_UNSETS|TCL_LEAVE_ERR_MSG, LocalUnsetTrace,
+		cmd) != TCL_OK) {
+	    TclCleanupCommandMacro((Command *)cmd);
+	    result = TCL_ERROR;
+	    goto localCmdDone;
+	}
+    }
+    Tcl_SetObjResult(interp, objNamePtr);
+
+localCmdDone:
+    Tcl_DecrRefCount(varNamePtr);
+    Tcl_DecrRefCount(objNamePtr);
+    return result;
+}
+
+
 /*
  * ------------------------------------------------------------------------
  *  Itcl_IsObjectCmd()
@@ -1572,7 +2168,8 @@ Itcl_AddObjectOptionCmd(
     Tcl_AppendToObj(ioptPtr->fullNamePtr, "::", 2);
     Tcl_AppendToObj(ioptPtr->fullNamePtr, Tcl_GetString(ioptPtr->namePtr), -1);
     Tcl_IncrRefCount(ioptPtr->fullNamePtr);
-    hPtr = Tcl_CreateHashEntry(&ioPtr->objectOptions,
+    hPtr = Tcl_CreateHashEntry(
+	    ItclObjectTable(ioPtr, &ioPtr->objectOptions),
             (char *)ioptPtr->namePtr, &isNew);
     Tcl_SetHashValue(hPtr, ioptPtr);
     ItclSetInstanceVar(interp, "itcl_options",
@@ -1635,7 +2232,8 @@ Itcl_AddDelegatedOptionCmd(
     if (result != TCL_OK) {
         return result;
     }
-    hPtr = Tcl_CreateHashEntry(&ioPtr->objectDelegatedOptions,
+    hPtr = Tcl_CreateHashEntry(
+	    ItclObjectTable(ioPtr, &ioPtr->objectDelegatedOptions),
             (char *)idoPtr->namePtr, &isNew);
     Tcl_SetHashValue(hPtr, idoPtr);
     return result;
@@ -1714,7 +2312,8 @@ Itcl_AddDelegatedFunctionCmd(
     componentNamePtr = Tcl_NewStringObj(val, -1);
     Tcl_IncrRefCount(componentNamePtr);
     DelegateFunction(interp, ioPtr, ioPtr->iclsPtr, componentNamePtr, idmPtr);
-    hPtr = Tcl_CreateHashEntry(&ioPtr->objectDelegatedFunctions,
+    hPtr = Tcl_CreateHashEntry(
+	    ItclObjectTable(ioPtr, &ioPtr->objectDelegatedFunctions),
             (char *)idmPtr->namePtr, &isNew);
     Tcl_DecrRefCount(componentNamePtr);
     Tcl_SetHashValue(hPtr, idmPtr);
@@ -1773,8 +2372,9 @@ Itcl_AddComponentCmd(
         return TCL_ERROR;
     }
     contextIclsPtr = contextIoPtr->iclsPtr;
-    hPtr = Tcl_CreateHashEntry(&contextIoPtr->objectComponents, (char *)objv[2],
-            &isNew);
+    hPtr = Tcl_CreateHashEntry(
+	    ItclObjectTable(contextIoPtr, &contextIoPtr->objectComponents),
+            (char *)objv[2], &isNew);
     if (!isNew) {
 	Tcl_AppendResult(interp, "Itcl_AddComponentCmd component \"",
 	        Tcl_GetString(objv[2]), "\" already exists for object \"",
@@ -1803,7 +2403,8 @@ Itcl_AddComponentCmd(
     }
     ivPtr = (ItclVariable *)Tcl_GetHashValue(hPtr);
     /* add entry to the virtual tables */
-    vlookup = (ItclVarLookup *)ckalloc(sizeof(ItclVarLookup));
+    vlookup = (ItclVarLookup *)ItclPoolAlloc(contextIclsPtr->infoPtr,
+            sizeof(ItclVarLookup));
     vlookup->ivPtr = ivPtr;
     vlookup->usage = 0;
     vlookup->leastQualName = NULL;
@@ -1876,13 +2477,7 @@ Itcl_AddComponentCmd(
     Itcl_PopCallFrame(interp);
     varPtr = Tcl_NewNamespaceVar(interp, varNsPtr,
             Tcl_GetString(ivPtr->namePtr));
-    hPtr = Tcl_CreateHashEntry(&contextIoPtr->objectVariables,
-            (char *)ivPtr, &isNew);
-    if (isNew) {
-	Itcl_PreserveVar(varPtr);
-        Tcl_SetHashValue(hPtr, varPtr);
-    } else {
-    }
+    ItclSetObjectVar(contextIoPtr, ivPtr, varPtr);
     return result;
 }
 
@@ -2191,3 +2786,648 @@ Itcl_ClassWidgetClassCmd(
     Tcl_AppendResult(interp, "invalid command name \"widgetclass\"", NULL);
     return TCL_ERROR;
 }
+
+/*
+ * ------------------------------------------------------------------------
+ *  Class definition snapshots
+ *
+ *  "::itcl::internal::commands::snapshot record" evaluates a script,
+ *  usually one sourcing the files of an application, and writes the
+ *  classes defined by it to a snapshot file.  Each class body is stored
+ *  split into its commands, so "snapshot load" can define the classes
+ *  again by dispatching the parser commands with the stored words,
+ *  without compiling the class bodies.  A snapshot is only loaded if
+ *  it was written by the same versions of itcl and Tcl and the source
+ *  files still hash to the value it was recorded with.  Only the class
+ *  definitions are restored, anything else the script did is up to the
+ *  caller.  Files the script reads besides the listed ones are not
+ *  checked, so the command stays internal for now.
+ * ------------------------------------------------------------------------
+ */
+
+#define ITCL_SNAPSHOT_MAGIC "itcl-snapshot"
+#define ITCL_SNAPSHOT_FORMAT "3"
+
+/*
+ *  The commands defining the different kinds of classes.  The widget
+ *  commands pass the class body on as a string, their bodies are
+ *  stored as they are.
+ */
+static const struct {
+    int flags;
+    const char *cmdName;
+    int splitBody;
+} snapshotClassCmds[] = {
+    {ITCL_CLASS, "::itcl::class", 1},
+    {ITCL_TYPE, "::itcl::type", 1},
+    {ITCL_ECLASS, "::itcl::extendedclass", 1},
+    {ITCL_ECLASS|ITCL_NWIDGET, "::itcl::nwidget", 1},
+    {ITCL_WIDGET, "::itcl::widget", 0},
+    {ITCL_WIDGETADAPTOR, "::itcl::widgetadaptor", 0},
+    {0, NULL, 0}
+};
+
+/*
+ * ------------------------------------------------------------------------
+ *  SplitClassBody()
+ *
+ *  Splits a class body into a list with one entry per command.  An
+ *  entry is "w" followed by the words of the command if all of them
+ *  are literal, or "s" and the text of the command if it needs
+ *  substitutions, so that it is left to the script evaluator.
+ * ------------------------------------------------------------------------
+ */
+static Tcl_Obj *
+SplitClassBody(
+    Tcl_Obj *bodyPtr)
+{
+    Tcl_Parse parse;
+    Tcl_Token *tokenPtr;
+    Tcl_Obj *listPtr;
+    Tcl_Obj *entryPtr;
+    const char *script;
+    const char *p;
+    int length;
+    int i;
+
+    listPtr = Tcl_NewListObj(0, NULL);
+    script = Tcl_GetStringFromObj(bodyPtr, &length);
+    p = script;
+    while (p < script + length) {
+        if (Tcl_ParseCommand(NULL, p, length - (int)(p - script), 0,
+                &parse) != TCL_OK) {
+            entryPtr = Tcl_NewListObj(0, NULL);
+            Tcl_ListObjAppendElement(NULL, entryPtr,
+                    Tcl_NewStringObj("s", 1));
+            Tcl_ListObjAppendElement(NULL, entryPtr,
+                    Tcl_NewStringObj(p, length - (int)(p - script)));
+            Tcl_ListObjAppendElement(NULL, listPtr, entryPtr);
+            break;
+        }
+        if (parse.numWords > 0) {
+            entryPtr = Tcl_NewListObj(0, NULL);
+            Tcl_ListObjAppendElement(NULL, entryPtr,
+                    Tcl_NewStringObj("w", 1));
+            tokenPtr = parse.tokenPtr;
+            for (i = 0; i < parse.numWords; i++) {
+                if (tokenPtr->type != TCL_TOKEN_SIMPLE_WORD) {
+                    break;
+                }
+                if (tokenPtr->numComponents == 0) {
+                    Tcl_ListObjAppendElement(NULL, entryPtr, Tcl_NewObj());
+                } else {
+                    Tcl_ListObjAppendElement(NULL, entryPtr,
+                            Tcl_NewStringObj(tokenPtr[1].start,
+                            tokenPtr[1].size));
+                }
+                tokenPtr += tokenPtr->numComponents + 1;
+            }
+            if (i < parse.numWords) {
+                Tcl_DecrRefCount(entryPtr);
+                entryPtr = Tcl_NewListObj(0, NULL);
+                Tcl_ListObjAppendElement(NULL, entryPtr,
+                        Tcl_NewStringObj("s", 1));
+                Tcl_ListObjAppendElement(NULL, entryPtr,
+                        Tcl_NewStringObj(parse.commandStart,
+                        parse.commandSize));
+            }
+            Tcl_ListObjAppendElement(NULL, listPtr, entryPtr);
+        }
+        p = parse.commandStart + parse.commandSize;
+        Tcl_FreeParse(&parse);
+    }
+    return listPtr;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclSnapshotAddClass()
+ *
+ *  Called at the end of a successful class definition while
+ *  "snapshot record" is active.  Remembers the command that defined the
+ *  class, its name and its body, split if possible.
+ * ------------------------------------------------------------------------
+ */
+void
+ItclSnapshotAddClass(
+    ItclObjectInfo *infoPtr,
+    ItclClass *iclsPtr,
+    Tcl_Obj *bodyPtr,
+    int isSplit)
+{
+    Tcl_Obj *recordPtr;
+    int i;
+
+    for (i = 0; snapshotClassCmds[i].cmdName != NULL; i++) {
+        if (snapshotClassCmds[i].flags == (iclsPtr->flags &
+                (ITCL_CLASS|ITCL_TYPE|ITCL_ECLASS|ITCL_NWIDGET|ITCL_WIDGET|
+                ITCL_WIDGETADAPTOR))) {
+            break;
+        }
+    }
+    if (snapshotClassCmds[i].cmdName == NULL) {
+        return;
+    }
+    recordPtr = Tcl_NewListObj(0, NULL);
+    Tcl_ListObjAppendElement(NULL, recordPtr,
+            Tcl_NewStringObj(snapshotClassCmds[i].cmdName, -1));
+    Tcl_ListObjAppendElement(NULL, recordPtr, iclsPtr->fullNamePtr);
+    if (!snapshotClassCmds[i].splitBody) {
+        Tcl_ListObjAppendElement(NULL, recordPtr, Tcl_NewStringObj("s", 1));
+        Tcl_ListObjAppendElement(NULL, recordPtr, bodyPtr);
+    } else {
+        Tcl_ListObjAppendElement(NULL, recordPtr, Tcl_NewStringObj("w", 1));
+        Tcl_ListObjAppendElement(NULL, recordPtr,
+                isSplit ? bodyPtr : SplitClassBody(bodyPtr));
+    }
+    Tcl_ListObjAppendElement(NULL, infoPtr->snapshotPtr, recordPtr);
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclSnapshotAddBody()
+ *
+ *  Called at the end of a successful "itcl::body" or "itcl::configbody"
+ *  command while "snapshot record" is active.  Remembers the command,
+ *  with the member name fully qualified, after the record of its
+ *  class.  objv holds the words following the member name.
+ * ------------------------------------------------------------------------
+ */
+void
+ItclSnapshotAddBody(
+    ItclObjectInfo *infoPtr,
+    ItclClass *iclsPtr,
+    const char *cmdName,
+    const char *member,
+    int objc,
+    Tcl_Obj *const objv[])
+{
+    Tcl_Obj *recordPtr;
+    Tcl_Obj *cmdPtr;
+    Tcl_Obj *namePtr;
+
+    namePtr = Tcl_DuplicateObj(iclsPtr->fullNamePtr);
+    Tcl_AppendToObj(namePtr, "::", 2);
+    Tcl_AppendToObj(namePtr, member, -1);
+    cmdPtr = Tcl_NewListObj(0, NULL);
+    Tcl_ListObjAppendElement(NULL, cmdPtr, Tcl_NewStringObj(cmdName, -1));
+    Tcl_ListObjAppendElement(NULL, cmdPtr, namePtr);
+    Tcl_ListObjReplace(NULL, cmdPtr, 2, 0, objc, objv);
+
+    recordPtr = Tcl_NewListObj(0, NULL);
+    Tcl_ListObjAppendElement(NULL, recordPtr, Tcl_NewStringObj(cmdName, -1));
+    Tcl_ListObjAppendElement(NULL, recordPtr, iclsPtr->fullNamePtr);
+    Tcl_ListObjAppendElement(NULL, recordPtr, Tcl_NewStringObj("c", 1));
+    Tcl_ListObjAppendElement(NULL, recordPtr, cmdPtr);
+    Tcl_ListObjAppendElement(NULL, infoPtr->snapshotPtr, recordPtr);
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclEvalSnapshotBody()
+ *
+ *  Evaluates a class body split by SplitClassBody.  Used instead of
+ *  Tcl_EvalObjEx by ItclClassBaseCmd for classes defined by
+ *  "snapshot load".
+ * ------------------------------------------------------------------------
+ */
+int
+ItclEvalSnapshotBody(
+    Tcl_Interp *interp,
+    Tcl_Obj *bodyPtr)
+{
+    Tcl_Obj **entryv;
+    Tcl_Obj **wordv;
+    int entryc;
+    int wordc;
+    int result;
+    int i;
+
+    result = Tcl_ListObjGetElements(interp, bodyPtr, &entryc, &entryv);
+    for (i = 0; (result == TCL_OK) && (i < entryc); i++) {
+        result = Tcl_ListObjGetElements(interp, entryv[i], &wordc, &wordv);
+        if (result != TCL_OK) {
+            break;
+        }
+        if ((wordc > 1) && (*Tcl_GetString(wordv[0]) == 'w')) {
+            result = Tcl_EvalObjv(interp, wordc-1, wordv+1, 0);
+        } else if (wordc == 2) {
+            result = Tcl_EvalObjEx(interp, wordv[1], 0);
+        } else {
+            Tcl_AppendResult(interp, "malformed snapshot class body", NULL);
+            result = TCL_ERROR;
+        }
+    }
+    return result;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  SnapshotTclVersion()
+ *
+ *  Leaves the version of the Tcl library in use, as major.minor.patch,
+ *  in versionStr.  Snapshots are only loaded into the same version.
+ * ------------------------------------------------------------------------
+ */
+static void
+SnapshotTclVersion(
+    char *versionStr)
+{
+    int major, minor, patch;
+
+    Tcl_GetVersion(&major, &minor, &patch, NULL);
+    sprintf(versionStr, "%d.%d.%d", major, minor, patch);
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  HashSnapshotSources()
+ *
+ *  Computes the FNV-1a hash over the contents of the files named in
+ *  listPtr.  Leaves the hash as 16 hex digits in hashStr.
+ * ------------------------------------------------------------------------
+ */
+static int
+HashSnapshotSources(
+    Tcl_Interp *interp,
+    Tcl_Obj *listPtr,
+    char *hashStr)
+{
+    Tcl_WideUInt hash;
+    Tcl_Channel chan;
+    Tcl_Obj **filev;
+    Tcl_Obj *contentPtr;
+    const unsigned char *bytes;
+    int filec;
+    int length;
+    int i;
+    int j;
+
+    if (Tcl_ListObjGetElements(interp, listPtr, &filec, &filev) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    hash = (Tcl_WideUInt)0xcbf29ce484222325ULL;
+    for (i = 0; i < filec; i++) {
+        chan = Tcl_FSOpenFileChannel(interp, filev[i], "r", 0);
+        if (chan == NULL) {
+            return TCL_ERROR;
+        }
+        Tcl_SetChannelOption(NULL, chan, "-translation", "binary");
+        contentPtr = Tcl_NewObj();
+        Tcl_IncrRefCount(contentPtr);
+        if (Tcl_ReadChars(chan, contentPtr, -1, 0) < 0) {
+            Tcl_AppendResult(interp, "error reading \"",
+                    Tcl_GetString(filev[i]), "\": ",
+                    Tcl_PosixError(interp), NULL);
+            Tcl_DecrRefCount(contentPtr);
+            Tcl_Close(NULL, chan);
+            return TCL_ERROR;
+        }
+        Tcl_Close(NULL, chan);
+        bytes = Tcl_GetByteArrayFromObj(contentPtr, &length);
+        for (j = 0; j < length; j++) {
+            hash ^= bytes[j];
+            hash *= (Tcl_WideUInt)0x100000001b3ULL;
+        }
+        /* keep "ab" "c" apart from "a" "bc" */
+        hash ^= (Tcl_WideUInt)length;
+        hash *= (Tcl_WideUInt)0x100000001b3ULL;
+        Tcl_DecrRefCount(contentPtr);
+    }
+    sprintf(hashStr, "%016" TCL_LL_MODIFIER "x", hash);
+    return TCL_OK;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  Itcl_SnapshotRecordCmd()
+ *
+ *  Invoked by Tcl whenever the user issues a "snapshot record" command.
+ *  Handles the following syntax:
+ *
+ *      ::itcl::internal::commands::snapshot record <fileName> \
+ *              <sourceFiles> <script>
+ *
+ *  Evaluates the script and writes the classes it defined to the
+ *  snapshot file, together with the "itcl::body" and "itcl::configbody"
+ *  commands run for them.  Returns the names of these classes.
+ * ------------------------------------------------------------------------
+ */
+int
+Itcl_SnapshotRecordCmd(
+    ClientData clientData,   /* infoPtr */
+    Tcl_Interp *interp,      /* current interpreter */
+    int objc,                /* number of arguments */
+    Tcl_Obj *const objv[])   /* argument objects */
+{
+    ItclObjectInfo *infoPtr = (ItclObjectInfo *)clientData;
+    Tcl_Obj *savedPtr;
+    Tcl_Obj *recordsPtr;
+    Tcl_Obj *resultPtr;
+    Tcl_Obj *contentPtr;
+    Tcl_Obj **recordv;
+    Tcl_Obj **fieldv;
+    Tcl_HashTable lastDefs;
+    Tcl_HashEntry *hPtr;
+    Tcl_Channel chan;
+    char hashStr[TCL_INTEGER_SPACE*2];
+    char versionStr[TCL_INTEGER_SPACE*3];
+    int recordc;
+    int fieldc;
+    int isNew;
+    int result;
+    int i;
+
+    ItclShowArgs(1, "Itcl_SnapshotRecordCmd", objc, objv);
+    if (objc != 4) {
+        Tcl_WrongNumArgs(interp, 1, objv, "fileName sourceFiles script");
+        return TCL_ERROR;
+    }
+    if (HashSnapshotSources(interp, objv[2], hashStr) != TCL_OK) {
+        return TCL_ERROR;
+    }
+
+    savedPtr = infoPtr->snapshotPtr;
+    recordsPtr = Tcl_NewListObj(0, NULL);
+    Tcl_IncrRefCount(recordsPtr);
+    infoPtr->snapshotPtr = recordsPtr;
+    result = Tcl_EvalObjEx(interp, objv[3], 0);
+    infoPtr->snapshotPtr = savedPtr;
+    if (result != TCL_OK) {
+        Tcl_DecrRefCount(recordsPtr);
+        return result;
+    }
+
+    /*
+     *  Leave out the classes deleted by the script again.  Of a class
+     *  defined more than once only the last definition is kept, with
+     *  the bodies given after it.
+     */
+    Tcl_ListObjGetElements(NULL, recordsPtr, &recordc, &recordv);
+    Tcl_InitObjHashTable(&lastDefs);
+    for (i = 0; i < recordc; i++) {
+        Tcl_ListObjGetElements(NULL, recordv[i], &fieldc, &fieldv);
+        if (*Tcl_GetString(fieldv[2]) != 'c') {
+            hPtr = Tcl_CreateHashEntry(&lastDefs, (char *)fieldv[1], &isNew);
+            Tcl_SetHashValue(hPtr, INT2PTR(i));
+        }
+    }
+    contentPtr = Tcl_NewListObj(0, NULL);
+    Tcl_IncrRefCount(contentPtr);
+    resultPtr = Tcl_NewListObj(0, NULL);
+    for (i = 0; i < recordc; i++) {
+        Tcl_ListObjGetElements(NULL, recordv[i], &fieldc, &fieldv);
+        hPtr = Tcl_FindHashEntry(&lastDefs, (char *)fieldv[1]);
+        if ((hPtr == NULL) || (i < PTR2INT(Tcl_GetHashValue(hPtr)))
+                || (Tcl_FindHashEntry(&infoPtr->nameClasses,
+                (char *)fieldv[1]) == NULL)) {
+            continue;
+        }
+        Tcl_ListObjAppendElement(NULL, contentPtr, recordv[i]);
+        if (*Tcl_GetString(fieldv[2]) != 'c') {
+            Tcl_ListObjAppendElement(NULL, resultPtr, fieldv[1]);
+        }
+    }
+    Tcl_DeleteHashTable(&lastDefs);
+    Tcl_DecrRefCount(recordsPtr);
+
+    chan = Tcl_FSOpenFileChannel(interp, objv[1], "w", 0666);
+    if (chan == NULL) {
+        Tcl_DecrRefCount(contentPtr);
+        Tcl_DecrRefCount(resultPtr);
+        return TCL_ERROR;
+    }
+    Tcl_SetChannelOption(NULL, chan, "-encoding", "utf-8");
+    Tcl_SetChannelOption(NULL, chan, "-translation", "lf");
+    Tcl_WriteChars(chan, ITCL_SNAPSHOT_MAGIC " " ITCL_SNAPSHOT_FORMAT " "
+            ITCL_PATCH_LEVEL " ", -1);
+    SnapshotTclVersion(versionStr);
+    Tcl_WriteChars(chan, versionStr, -1);
+    Tcl_WriteChars(chan, " ", 1);
+    Tcl_WriteChars(chan, hashStr, -1);
+    Tcl_WriteChars(chan, "\n", 1);
+    if ((Tcl_WriteObj(chan, contentPtr) < 0)
+            || (Tcl_WriteChars(chan, "\n", 1) < 0)) {
+        Tcl_AppendResult(interp, "error writing \"",
+                Tcl_GetString(objv[1]), "\": ", Tcl_PosixError(interp),
+                NULL);
+        Tcl_Close(NULL, chan);
+        Tcl_DecrRefCount(contentPtr);
+        Tcl_DecrRefCount(resultPtr);
+        return TCL_ERROR;
+    }
+    Tcl_DecrRefCount(contentPtr);
+    if (Tcl_Close(interp, chan) != TCL_OK) {
+        Tcl_DecrRefCount(resultPtr);
+        return TCL_ERROR;
+    }
+    Tcl_SetObjResult(interp, resultPtr);
+    return TCL_OK;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ShareCommandNames()
+ *
+ *  Lets all commands in the split class bodies of a snapshot that
+ *  have the same name use the same word object, so the command is
+ *  looked up once and then found through the cache in the object,
+ *  the way it happens for the literals of a compiled class body.
+ * ------------------------------------------------------------------------
+ */
+static void
+ShareCommandNames(
+    int recordc,
+    Tcl_Obj *const *recordv)
+{
+    Tcl_HashTable names;
+    Tcl_HashEntry *hPtr;
+    Tcl_Obj **fieldv;
+    Tcl_Obj **entryv;
+    Tcl_Obj **wordv;
+    Tcl_Obj *namePtr;
+    int fieldc;
+    int entryc;
+    int wordc;
+    int isNew;
+    int i;
+    int j;
+
+    Tcl_InitObjHashTable(&names);
+    for (i = 0; i < recordc; i++) {
+        if ((Tcl_ListObjGetElements(NULL, recordv[i], &fieldc, &fieldv)
+                != TCL_OK) || (fieldc != 4)
+                || (*Tcl_GetString(fieldv[2]) != 'w')
+                || (Tcl_ListObjGetElements(NULL, fieldv[3], &entryc, &entryv)
+                != TCL_OK)) {
+            continue;
+        }
+        for (j = 0; j < entryc; j++) {
+            if ((Tcl_ListObjGetElements(NULL, entryv[j], &wordc, &wordv)
+                    != TCL_OK) || (wordc < 2)
+                    || (*Tcl_GetString(wordv[0]) != 'w')) {
+                continue;
+            }
+            hPtr = Tcl_CreateHashEntry(&names, (char *)wordv[1], &isNew);
+            if (isNew) {
+                Tcl_SetHashValue(hPtr, wordv[1]);
+            } else if (!Tcl_IsShared(entryv[j])) {
+                namePtr = (Tcl_Obj *)Tcl_GetHashValue(hPtr);
+                Tcl_ListObjReplace(NULL, entryv[j], 1, 1, 1, &namePtr);
+            }
+        }
+    }
+    Tcl_DeleteHashTable(&names);
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  Itcl_SnapshotLoadCmd()
+ *
+ *  Invoked by Tcl whenever the user issues a "snapshot load" command.
+ *  Handles the following syntax:
+ *
+ *      ::itcl::internal::commands::snapshot load <fileName> <sourceFiles>
+ *
+ *  Defines the classes stored in the snapshot file and returns 1.
+ *  Returns 0 without defining anything if the file does not exist,
+ *  was written by another version or the source files have changed
+ *  since.
+ * ------------------------------------------------------------------------
+ */
+int
+Itcl_SnapshotLoadCmd(
+    ClientData clientData,   /* infoPtr */
+    Tcl_Interp *interp,      /* current interpreter */
+    int objc,                /* number of arguments */
+    Tcl_Obj *const objv[])   /* argument objects */
+{
+    ItclObjectInfo *infoPtr = (ItclObjectInfo *)clientData;
+    Tcl_Obj *contentPtr;
+    Tcl_Obj *headerPtr = NULL;
+    Tcl_Obj *recordsPtr;
+    Tcl_Obj *savedPtr;
+    Tcl_Obj **headerv;
+    Tcl_Obj **recordv;
+    Tcl_Obj **fieldv;
+    Tcl_Obj *cmdv[3];
+    Tcl_Channel chan;
+    const char *content;
+    const char *eol;
+    char hashStr[TCL_INTEGER_SPACE*2];
+    char versionStr[TCL_INTEGER_SPACE*3];
+    int headerc;
+    int recordc;
+    int fieldc;
+    int length;
+    int result;
+    int i;
+
+    ItclShowArgs(1, "Itcl_SnapshotLoadCmd", objc, objv);
+    if (objc != 3) {
+        Tcl_WrongNumArgs(interp, 1, objv, "fileName sourceFiles");
+        return TCL_ERROR;
+    }
+    chan = Tcl_FSOpenFileChannel(NULL, objv[1], "r", 0);
+    if (chan == NULL) {
+        Tcl_SetObjResult(interp, Tcl_NewBooleanObj(0));
+        return TCL_OK;
+    }
+    Tcl_SetChannelOption(NULL, chan, "-encoding", "utf-8");
+    contentPtr = Tcl_NewObj();
+    Tcl_IncrRefCount(contentPtr);
+    if (Tcl_ReadChars(chan, contentPtr, -1, 0) < 0) {
+        Tcl_AppendResult(interp, "error reading \"", Tcl_GetString(objv[1]),
+                "\": ", Tcl_PosixError(interp), NULL);
+        Tcl_Close(NULL, chan);
+        Tcl_DecrRefCount(contentPtr);
+        return TCL_ERROR;
+    }
+    Tcl_Close(NULL, chan);
+
+    /*
+     *  Check the header line: magic, format, itcl and Tcl versions and
+     *  hash.
+     */
+    content = Tcl_GetStringFromObj(contentPtr, &length);
+    eol = memchr(content, '\n', length);
+    headerc = 0;
+    headerv = NULL;
+    if (eol != NULL) {
+        headerPtr = Tcl_NewStringObj(content, (int)(eol - content));
+        Tcl_IncrRefCount(headerPtr);
+        if (Tcl_ListObjGetElements(NULL, headerPtr, &headerc, &headerv)
+                != TCL_OK) {
+            headerc = 0;
+        }
+    }
+    SnapshotTclVersion(versionStr);
+    if ((headerc != 5)
+            || (strcmp(Tcl_GetString(headerv[0]), ITCL_SNAPSHOT_MAGIC) != 0)
+            || (strcmp(Tcl_GetString(headerv[1]), ITCL_SNAPSHOT_FORMAT) != 0)
+            || (strcmp(Tcl_GetString(headerv[2]), ITCL_PATCH_LEVEL) != 0)
+            || (strcmp(Tcl_GetString(headerv[3]), versionStr) != 0)) {
+        if (eol != NULL) {
+            Tcl_DecrRefCount(headerPtr);
+        }
+        Tcl_DecrRefCount(contentPtr);
+        Tcl_SetObjResult(interp, Tcl_NewBooleanObj(0));
+        return TCL_OK;
+    }
+    if (HashSnapshotSources(interp, objv[2], hashStr) != TCL_OK) {
+        Tcl_DecrRefCount(headerPtr);
+        Tcl_DecrRefCount(contentPtr);
+        return TCL_ERROR;
+    }
+    if (strcmp(Tcl_GetString(headerv[4]), hashStr) != 0) {
+        Tcl_DecrRefCount(headerPtr);
+        Tcl_DecrRefCount(contentPtr);
+        Tcl_SetObjResult(interp, Tcl_NewBooleanObj(0));
+        return TCL_OK;
+    }
+    Tcl_DecrRefCount(headerPtr);
+
+    recordsPtr = Tcl_NewStringObj(eol + 1, length - (int)(eol + 1 - content));
+    Tcl_IncrRefCount(recordsPtr);
+    Tcl_DecrRefCount(contentPtr);
+    result = Tcl_ListObjGetElements(interp, recordsPtr, &recordc, &recordv);
+    if (result == TCL_OK) {
+        ShareCommandNames(recordc, recordv);
+    }
+
+    /*
+     *  Define the classes.  ItclClassBaseCmd recognizes the body by
+     *  its identity and evaluates it with ItclEvalSnapshotBody.
+     */
+    savedPtr = infoPtr->snapshotBodyPtr;
+    for (i = 0; (result == TCL_OK) && (i < recordc); i++) {
+        result = Tcl_ListObjGetElements(interp, recordv[i], &fieldc, &fieldv);
+        if ((result == TCL_OK) && (fieldc != 4)) {
+            Tcl_AppendResult(interp, "malformed snapshot record in \"",
+                    Tcl_GetString(objv[1]), "\"", NULL);
+            result = TCL_ERROR;
+        }
+        if (result == TCL_OK) {
+            infoPtr->snapshotBodyPtr = NULL;
+            if (*Tcl_GetString(fieldv[2]) == 'c') {
+                /* "itcl::body" or "itcl::configbody" */
+                result = Tcl_EvalObjEx(interp, fieldv[3], TCL_EVAL_GLOBAL);
+                continue;
+            }
+            cmdv[0] = fieldv[0];
+            cmdv[1] = fieldv[1];
+            cmdv[2] = fieldv[3];
+            if (*Tcl_GetString(fieldv[2]) == 'w') {
+                infoPtr->snapshotBodyPtr = fieldv[3];
+            }
+            result = Tcl_EvalObjv(interp, 3, cmdv, TCL_EVAL_GLOBAL);
+        }
+    }
+    infoPtr->snapshotBodyPtr = savedPtr;
+    Tcl_DecrRefCount(recordsPtr);
+    if (result != TCL_OK) {
+        return result;
+    }
+    Tcl_SetObjResult(interp, Tcl_NewBooleanObj(1));
+    return TCL_OK;
+}
@@ -19,7 +19,7 @@ ITCLAPI const char *Itcl_InitStubs(
 /* !BEGIN!: Do not edit below this line. */
 
 #define ITCL_STUBS_EPOCH 0
-#define ITCL_STUBS_REVISION 152
+#define ITCL_STUBS_REVISION 153
 
 #ifdef __cplusplus
 extern "C" {
@@ -96,6 +96,9 @@ ITCLAPI void		Itcl_DiscardInterpState(Itcl_InterpState state);
 ITCLAPI void *		Itcl_Alloc(size_t size);
 /* 27 */
 ITCLAPI void		Itcl_Free(void *ptr);
+/* 28 */
+ITCLAPI Tcl_Var		Itcl_GetScopedVar(Tcl_Interp *interp,
+				Tcl_Obj *objPtr, const char **indexPtr);
 
 typedef struct {
     const struct ItclIntStubs *itclIntStubs;
@@ -135,6 +138,7 @@ typedef struct ItclStubs {
     void (*itcl_DiscardInterpState) (Itcl_InterpState state); /* 25 */
     void * (*itcl_Alloc) (size_t size); /* 26 */
     void (*itcl_Free) (void *ptr); /* 27 */
+    Tcl_Var (*itcl_GetScopedVar) (Tcl_Interp *interp, Tcl_Obj *objPtr, const char **indexPtr); /* 28 */
 } ItclStubs;
 
 extern const ItclStubs *itclStubsPtr;
@@ -203,6 +207,8 @@ extern const ItclStubs *itclStubsPtr;
 	(itclStubsPtr->itcl_Alloc) /* 26 */
 #define Itcl_Free \
 	(itclStubsPtr->itcl_Free) /* 27 */
+#define Itcl_GetScopedVar \
+	(itclStubsPtr->itcl_GetScopedVar) /* 28 */
 
 #endif /* defined(USE_ITCL_STUBS) */
 
@@ -617,151 +617,108 @@ ItclDeleteClassesDictInfo(
 
 /*
  * ------------------------------------------------------------------------
- *  ItclAddObjectsDictInfo()
+ *  AddObjectDictInfo()
+ *
+ *  Adds the entry describing one object to the "instances" dict of
+ *  the ::itcl::internal::dicts::objects mirror.
  * ------------------------------------------------------------------------
  */
-int
-ItclAddObjectsDictInfo(
+static int
+AddObjectDictInfo(
     Tcl_Interp *interp,
+    Tcl_Obj *instancesPtr,
     ItclObject *ioPtr)
 {
-    Tcl_Obj *dictPtr;
-    Tcl_Obj *keyPtr;
-    Tcl_Obj *keyPtr1;
-    Tcl_Obj *valuePtr1;
-    Tcl_Obj *valuePtr2;
+    Tcl_Obj *valuePtr;
     Tcl_Obj *objPtr;
-    int newValue1;
 
-    dictPtr = Tcl_GetVar2Ex(interp,
-             ITCL_NAMESPACE"::internal::dicts::objects", NULL, 0);
-    if (dictPtr == NULL) {
-        Tcl_AppendResult(interp, "cannot get dict ", ITCL_NAMESPACE,
-	        "::internal::dicts::objects", NULL);
-	return TCL_ERROR;
-    }
-    keyPtr1 = Tcl_NewStringObj("instances", -1);
-    if (Tcl_DictObjGet(interp, dictPtr, keyPtr1, &valuePtr1) != TCL_OK) {
-        return TCL_ERROR;
-    }
-    newValue1 = 0;
-    if (valuePtr1 == NULL) {
-        newValue1 = 1;
-        valuePtr1 = Tcl_NewDictObj();
-    }
-    keyPtr = ioPtr->namePtr;
-    if (Tcl_DictObjGet(interp, valuePtr1, keyPtr, &valuePtr2) != TCL_OK) {
-        return TCL_ERROR;
-    }
-    if (valuePtr2 == NULL) {
-        if (Tcl_DictObjRemove(interp, valuePtr1, keyPtr) != TCL_OK) {
-            return TCL_ERROR;
-        }
+    valuePtr = Tcl_NewDictObj();
+    if (AddDictEntry(interp, valuePtr, "-name", ioPtr->namePtr) != TCL_OK) {
+        goto errorReturn;
     }
-    valuePtr2 = Tcl_NewDictObj();
-    if (AddDictEntry(interp, valuePtr2, "-name", ioPtr->namePtr) != TCL_OK) {
-        return TCL_ERROR;
-    }
-    if (AddDictEntry(interp, valuePtr2, "-origname", ioPtr->namePtr)
+    if (AddDictEntry(interp, valuePtr, "-origname", ioPtr->namePtr)
             != TCL_OK) {
-        return TCL_ERROR;
+        goto errorReturn;
     }
-    if (AddDictEntry(interp, valuePtr2, "-class", ioPtr->iclsPtr->fullNamePtr)
+    if (AddDictEntry(interp, valuePtr, "-class", ioPtr->iclsPtr->fullNamePtr)
             != TCL_OK) {
-        return TCL_ERROR;
+        goto errorReturn;
     }
     if (ioPtr->hullWindowNamePtr != NULL) {
-        if (AddDictEntry(interp, valuePtr2, "-hullwindow",
+        if (AddDictEntry(interp, valuePtr, "-hullwindow",
 	        ioPtr->hullWindowNamePtr) != TCL_OK) {
-            return TCL_ERROR;
+            goto errorReturn;
         }
     }
-    if (AddDictEntry(interp, valuePtr2, "-varns", ioPtr->varNsNamePtr)
+    if (AddDictEntry(interp, valuePtr, "-varns", ioPtr->varNsNamePtr)
             != TCL_OK) {
-        return TCL_ERROR;
+        goto errorReturn;
     }
     objPtr = Tcl_NewObj();
     Tcl_GetCommandFullName(interp, ioPtr->accessCmd, objPtr);
-    if (AddDictEntry(interp, valuePtr2, "-command", objPtr) != TCL_OK) {
+    if (AddDictEntry(interp, valuePtr, "-command", objPtr) != TCL_OK) {
 	Tcl_DecrRefCount(objPtr);
-        return TCL_ERROR;
+        goto errorReturn;
     }
-    keyPtr = ioPtr->namePtr;
-    if (Tcl_DictObjPut(interp, valuePtr1, keyPtr, valuePtr2) != TCL_OK) {
-        return TCL_ERROR;
-    }
-    if (newValue1) {
-	/* Cannot fail. Screened non-dicts earlier. */
-        Tcl_DictObjPut(interp, dictPtr, keyPtr1, valuePtr1);
-    } else {
-	/* Don't leak the key val... */
-	Tcl_DecrRefCount(keyPtr1);
+    if (Tcl_DictObjPut(interp, instancesPtr, ioPtr->namePtr, valuePtr)
+            != TCL_OK) {
+        goto errorReturn;
     }
-    Tcl_SetVar2Ex(interp, ITCL_NAMESPACE"::internal::dicts::objects",
-            NULL, dictPtr, 0);
     return TCL_OK;
+errorReturn:
+    Tcl_DecrRefCount(valuePtr);
+    return TCL_ERROR;
 }
-
+
 /*
  * ------------------------------------------------------------------------
- *  ItclDeleteObjectsDictInfo()
+ *  ItclObjectsDictTrace()
+ *
+ *  Read trace on ::itcl::internal::dicts::objects.  Object creation
+ *  and destruction only mark the mirror as stale; it is rebuilt from
+ *  the table of known objects the next time somebody reads it.
  * ------------------------------------------------------------------------
  */
-int
-ItclDeleteObjectsDictInfo(
-    Tcl_Interp *interp,
-    ItclObject *ioPtr)
+char *
+ItclObjectsDictTrace(
+    ClientData clientData,      /* ItclObjectInfo Ptr */
+    Tcl_Interp *interp,         /* current interpreter */
+    TCL_UNUSED(const char *),   /* name of the variable */
+    TCL_UNUSED(const char *),   /* unused */
+    TCL_UNUSED(int))            /* flags */
 {
+    FOREACH_HASH_DECLS;
+    ItclObjectInfo *infoPtr = (ItclObjectInfo *)clientData;
+    ItclObject *ioPtr;
     Tcl_Obj *dictPtr;
-    Tcl_Obj *keyPtr;
-    Tcl_Obj *keyPtr1;
-    Tcl_Obj *valuePtr;
-    Tcl_Obj *valuePtr1;
+    Tcl_Obj *instancesPtr;
+    int numInstances;
 
-    dictPtr = Tcl_GetVar2Ex(interp,
-             ITCL_NAMESPACE"::internal::dicts::objects", NULL, 0);
-    if (dictPtr == NULL) {
-        Tcl_AppendResult(interp, "cannot get dict ", ITCL_NAMESPACE,
-	        "::internal::dicts::objects", NULL);
-	return TCL_ERROR;
-    }
-    keyPtr1 = Tcl_NewStringObj("instances", -1);
-    if (Tcl_DictObjGet(interp, dictPtr, keyPtr1, &valuePtr) != TCL_OK) {
-	Tcl_DecrRefCount(keyPtr1);
-        return TCL_ERROR;
-    }
-    if (valuePtr == NULL) {
-	/* looks like no object has been registered yet
-	 * so ignore and return OK */
-	Tcl_DecrRefCount(keyPtr1);
-        return TCL_OK;
-    }
-    keyPtr = ioPtr->namePtr;
-    if (Tcl_DictObjGet(interp, valuePtr, keyPtr, &valuePtr1) != TCL_OK) {
-	Tcl_DecrRefCount(keyPtr1);
-        return TCL_ERROR;
-    }
-    if (valuePtr1 == NULL) {
-	/* looks like the object has not been constructed successfully
-	 * so ignore and return OK */
-	Tcl_DecrRefCount(keyPtr1);
-        return TCL_OK;
-    }
-    if (Tcl_DictObjRemove(interp, valuePtr, keyPtr) != TCL_OK) {
-	Tcl_DecrRefCount(keyPtr1);
-        return TCL_ERROR;
+    if (!infoPtr->objectsDictStale) {
+        return NULL;
+    }
+    infoPtr->objectsDictStale = 0;
+    dictPtr = Tcl_NewDictObj();
+    instancesPtr = Tcl_NewDictObj();
+    FOREACH_HASH_VALUE(ioPtr, &infoPtr->objects) {
+        if ((ioPtr->accessCmd == NULL) || (ioPtr->constructed != NULL)) {
+            /* deleted or still under construction */
+            continue;
+        }
+        AddObjectDictInfo(interp, instancesPtr, ioPtr);
     }
-    if (Tcl_DictObjPut(interp, dictPtr, keyPtr1, valuePtr) != TCL_OK) {
-	/* This is very likely impossible. non-dict already screened. */
-	Tcl_DecrRefCount(keyPtr1);
-        return TCL_ERROR;
+    Tcl_DictObjSize(NULL, instancesPtr, &numInstances);
+    if (numInstances > 0) {
+	Tcl_DictObjPut(NULL, dictPtr, Tcl_NewStringObj("instances", -1),
+	        instancesPtr);
+    } else {
+        Tcl_DecrRefCount(instancesPtr);
     }
-    Tcl_DecrRefCount(keyPtr1);
     Tcl_SetVar2Ex(interp, ITCL_NAMESPACE"::internal::dicts::objects",
             NULL, dictPtr, 0);
-    return TCL_OK;
+    return NULL;
 }
-
+
 /*
  * ------------------------------------------------------------------------
  *  ItclAddOptionDictInfo()
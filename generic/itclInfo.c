@@ -316,29 +316,10 @@ InfoGutsFinish(
     TCL_UNUSED(Tcl_Interp *),
     int result)
 {
-    Tcl_CallFrame *framePtr = (Tcl_CallFrame *) data[0];
-    ItclObjectInfo *infoPtr = (ItclObjectInfo *) data[1];
-    ItclCallContext *cPtr = (ItclCallContext *) data[2];
-    ItclCallContext *popped;
-
-    Tcl_HashEntry *hPtr = Tcl_FindHashEntry(&infoPtr->frameContext,
-	    (char *) framePtr);
-
-    Itcl_Stack *stackPtr = (Itcl_Stack *) Tcl_GetHashValue(hPtr);
-
-    popped = (ItclCallContext *)Itcl_PopStack(stackPtr);
-
-    if (Itcl_GetStackSize(stackPtr) == 0) {
-	Itcl_DeleteStack(stackPtr);
-	ckfree((char *)stackPtr);
-	Tcl_DeleteHashEntry(hPtr);
-    }
-
-    if (cPtr != popped) {
-	Tcl_Panic("Context stack mismatch!");
-    }
-    ckfree((char *) cPtr);
+    ItclObjectInfo *infoPtr = (ItclObjectInfo *) data[0];
+    ItclFrameContext *fcPtr = (ItclFrameContext *) data[1];
 
+    ItclPopFrameContext(infoPtr, fcPtr);
     return result;
 }
 
@@ -351,11 +332,7 @@ ItclInfoGuts(
 {
     ItclObjectInfo *infoPtr = ioPtr->infoPtr;
     Tcl_CmdInfo info;
-    ItclCallContext *cPtr;
-    Tcl_CallFrame *framePtr;
-    Tcl_HashEntry *hPtr;
-    Itcl_Stack *stackPtr;
-    int isNew;
+    ItclFrameContext *fcPtr;
 
     if (objc == 2) {
 	/*
@@ -370,27 +347,14 @@ ItclInfoGuts(
 	return TCL_ERROR;
     }
 
-    framePtr = Itcl_GetUplevelCallFrame(interp, 0);
+    fcPtr = ItclPushFrameContext(infoPtr, Itcl_GetUplevelCallFrame(interp, 0),
+	    NULL);
+    fcPtr->context.objectFlags = ITCL_OBJECT_ROOT_METHOD;
+    fcPtr->context.ioPtr = ioPtr;
+    fcPtr->context.refCount = 1;
+    fcPtr->callContextPtr = &fcPtr->context;
 
-    hPtr = Tcl_CreateHashEntry(&infoPtr->frameContext, (char *)framePtr, &isNew);
-    if (isNew) {
-	stackPtr = (Itcl_Stack *) ckalloc(sizeof(Itcl_Stack));
-	Itcl_InitStack(stackPtr);
-	Tcl_SetHashValue(hPtr, stackPtr);
-    } else {
-	stackPtr = (Itcl_Stack *) Tcl_GetHashValue(hPtr);
-    }
-
-    cPtr = (ItclCallContext *) ckalloc(sizeof(ItclCallContext));
-    cPtr->objectFlags = ITCL_OBJECT_ROOT_METHOD;
-    cPtr->nsPtr = NULL;
-    cPtr->ioPtr = ioPtr;
-    cPtr->imPtr = NULL;
-    cPtr->refCount = 1;
-
-    Itcl_PushStack(cPtr, stackPtr);
-
-    Tcl_NRAddCallback(interp, InfoGutsFinish, framePtr, infoPtr, cPtr, NULL);
+    Tcl_NRAddCallback(interp, InfoGutsFinish, infoPtr, fcPtr, NULL, NULL);
     Tcl_GetCommandInfoFromToken(infoPtr->infoCmd, &info);
     return Tcl_NRCallObjProc(interp, info.objProc, info.objClientData,
 	    objc-1, objv+1);
@@ -2143,7 +2107,7 @@ Itcl_BiInfoOptionCmd(
 	    return TCL_ERROR;
 	}
 	optionNamePtr = Tcl_NewStringObj(optionName, -1);
-        hPtr = Tcl_FindHashEntry(&contextIoPtr->objectOptions,
+        hPtr = Tcl_FindHashEntry(contextIoPtr->objectOptions,
 	        (char *)optionNamePtr);
         Tcl_DecrRefCount(optionNamePtr);
         if (hPtr == NULL) {
@@ -2285,14 +2249,12 @@ Itcl_BiInfoOptionCmd(
                                 NULL);
                         return TCL_ERROR;
                     } else {
-                        val = ItclGetInstanceVar(interp, "itcl_options",
-		                Tcl_GetString(ioptPtr->namePtr),
-                                    contextIoPtr, ioptPtr->iclsPtr);
+                        objPtr = ItclGetOptionValue(interp, contextIoPtr,
+			        ioptPtr);
                     }
-                    if (val == NULL) {
-                        val = "<undefined>";
+                    if (objPtr == NULL) {
+                        objPtr = Tcl_NewStringObj("<undefined>", -1);
                     }
-                    objPtr = Tcl_NewStringObj((const char *)val, -1);
                     break;
             }
 
@@ -3448,7 +3410,7 @@ Itcl_BiInfoOptionsCmd(
     if (ioPtr == NULL) {
         tablePtr = &iclsPtr->options;
     } else {
-        tablePtr = &ioPtr->objectOptions;
+        tablePtr = ioPtr->objectOptions;
     }
     FOREACH_HASH_VALUE(ioptPtr, tablePtr) {
 	name = Tcl_GetString(ioptPtr->namePtr);
@@ -3461,7 +3423,7 @@ Itcl_BiInfoOptionsCmd(
     if (ioPtr == NULL) {
         tablePtr = &iclsPtr->delegatedOptions;
     } else {
-        tablePtr = &ioPtr->objectDelegatedOptions;
+        tablePtr = ioPtr->objectDelegatedOptions;
     }
     FOREACH_HASH_VALUE(idoPtr, tablePtr) {
         name = Tcl_GetString(idoPtr->namePtr);
@@ -4399,15 +4361,13 @@ Itcl_BiInfoWidgetadaptorCmd(
 /* ARGSUSED */
 static int
 Itcl_BiInfoInstancesCmd(
-    ClientData clientData, /* ItclObjectInfo Ptr */
+    TCL_UNUSED(ClientData), /* ItclObjectInfo Ptr */
     Tcl_Interp *interp,    /* current interpreter */
     int objc,              /* number of arguments */
     Tcl_Obj *const objv[]) /* argument objects */
 {
-    FOREACH_HASH_DECLS;
     Tcl_Obj *listPtr;
     Tcl_Obj *objPtr;
-    ItclObjectInfo *infoPtr;
     ItclObject *ioPtr;
     ItclClass *iclsPtr;
     const char *pattern;
@@ -4430,25 +4390,26 @@ Itcl_BiInfoInstancesCmd(
     if (objc == 2) {
         pattern = Tcl_GetString(objv[1]);
     }
-    infoPtr = (ItclObjectInfo *)clientData;
     listPtr = Tcl_NewListObj(0, NULL);
-    FOREACH_HASH_VALUE(ioPtr, &infoPtr->objects) {
-	/* FIXME need to scan the inheritance too */
-        if (ioPtr->iclsPtr == iclsPtr) {
-	    if (ioPtr->iclsPtr->flags & ITCL_WIDGETADAPTOR) {
-	        objPtr = Tcl_NewStringObj(Tcl_GetCommandName(interp,
-		        ioPtr->accessCmd), -1);
-	    } else {
-	        objPtr = Tcl_NewObj();
-	        Tcl_GetCommandFullName(interp, ioPtr->accessCmd, objPtr);
-            }
-	    if ((pattern == NULL) ||
-                     Tcl_StringCaseMatch(Tcl_GetString(objPtr), pattern, 0)) {
-	        Tcl_ListObjAppendElement(interp, listPtr, objPtr);
-	    } else {
-	        Tcl_DecrRefCount(objPtr);
-	    }
+    /* FIXME need to scan the inheritance too */
+    for (ioPtr = (iclsPtr != NULL) ? iclsPtr->instancesPtr : NULL;
+            ioPtr != NULL; ioPtr = ioPtr->nextInstancePtr) {
+        if (!ItclIsLiveObject(ioPtr)) {
+            continue;
+        }
+	if (ioPtr->iclsPtr->flags & ITCL_WIDGETADAPTOR) {
+	    objPtr = Tcl_NewStringObj(Tcl_GetCommandName(interp,
+		    ioPtr->accessCmd), -1);
+	} else {
+	    objPtr = Tcl_NewObj();
+	    Tcl_GetCommandFullName(interp, ioPtr->accessCmd, objPtr);
         }
+	if ((pattern == NULL) ||
+                 Tcl_StringCaseMatch(Tcl_GetString(objPtr), pattern, 0)) {
+	    Tcl_ListObjAppendElement(interp, listPtr, objPtr);
+	} else {
+	    Tcl_DecrRefCount(objPtr);
+	}
     }
     Tcl_SetObjResult(interp, listPtr);
     return TCL_OK;
@@ -4808,7 +4769,7 @@ Itcl_BiInfoDelegatedOptionCmd(
 	    return TCL_ERROR;
 	}
 	optionNamePtr = Tcl_NewStringObj(optionName, -1);
-        hPtr = Tcl_FindHashEntry(&contextIoPtr->objectDelegatedOptions,
+        hPtr = Tcl_FindHashEntry(contextIoPtr->objectDelegatedOptions,
 	        (char *)optionNamePtr);
         Tcl_DecrRefCount(optionNamePtr);
         if (hPtr == NULL) {
@@ -5028,7 +4989,7 @@ Itcl_BiInfoDelegatedMethodCmd(
     if (cmdName) {
 	cmdNamePtr = Tcl_NewStringObj(cmdName, -1);
 	if (contextIoPtr != NULL) {
-            hPtr = Tcl_FindHashEntry(&contextIoPtr->objectDelegatedFunctions,
+            hPtr = Tcl_FindHashEntry(contextIoPtr->objectDelegatedFunctions,
 	            (char *)cmdNamePtr);
 	} else {
             hPtr = Tcl_FindHashEntry(&contextIclsPtr->delegatedFunctions,
@@ -5253,7 +5214,7 @@ Itcl_BiInfoDelegatedTypeMethodCmd(
     if (cmdName) {
 	cmdNamePtr = Tcl_NewStringObj(cmdName, -1);
 	if (contextIoPtr != NULL) {
-            hPtr = Tcl_FindHashEntry(&contextIoPtr->objectDelegatedFunctions,
+            hPtr = Tcl_FindHashEntry(contextIoPtr->objectDelegatedFunctions,
 	            (char *)cmdNamePtr);
 	} else {
             hPtr = Tcl_FindHashEntry(&contextIclsPtr->delegatedFunctions,
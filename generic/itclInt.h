@@ -141,6 +141,29 @@ struct EnsembleInfo;
 struct ItclDelegatedOption;
 struct ItclDelegatedFunction;
 
+/*
+ *  Per-interpreter pools for the small records that come and go with
+ *  objects and classes.  Requests are rounded up to a multiple of
+ *  ITCL_POOL_GRANULE and served from the pool of that size, see
+ *  ItclPoolAlloc().  Larger requests go straight to ckalloc.
+ */
+#define ITCL_POOL_GRANULE 16
+#define ITCL_POOL_MAX_SIZE 1024
+#define ITCL_POOL_NUM_SIZES (ITCL_POOL_MAX_SIZE / ITCL_POOL_GRANULE)
+#define ITCL_POOL_CHUNK_SIZE 8192
+
+typedef struct ItclPool {
+    void *freePtr;                /* list of unused records */
+    struct ItclPoolChunk *chunksPtr;
+                                  /* memory blocks backing the pool */
+    int numChunks;                /* number of blocks in chunksPtr */
+    int numRecords;               /* records carved from the blocks */
+    int numInUse;                 /* records handed out right now */
+    int trimLimit;                /* free records that trigger a trim,
+                                   * see ItclPoolFree() */
+    Tcl_WideInt numAllocs;        /* total number of ItclPoolAlloc calls */
+} ItclPool;
+
 typedef struct ItclObjectInfo {
     Tcl_Interp *interp;             /* interpreter that manages this info */
     Tcl_HashTable objects;          /* list of all known objects key is
@@ -154,7 +177,7 @@ typedef struct ItclObjectInfo {
     Tcl_HashTable procMethods;      /* maps from procPtr to mFunc */
     Tcl_HashTable instances;        /* maps from instanceNumber to ioPtr */
     Tcl_HashTable unused8;          /* maps from ioPtr to instanceNumber */
-    Tcl_HashTable frameContext;     /* maps frame to context stack */
+    Tcl_HashTable unused10;         /* Removed */
     Tcl_HashTable classTypes;       /* maps from class type i.e. "widget"
                                      * to define value i.e. ITCL_WIDGET */
     int protection;                 /* protection level currently in effect */
@@ -209,6 +232,54 @@ typedef struct ItclObjectInfo {
     Tcl_Obj *typeDestructorArgumentPtr;
     struct ItclObject *lastIoPtr;   /* last object constructed */
     Tcl_Command infoCmd;
+    struct ItclFrameContext *frameContextTop;
+                                    /* innermost entry of the call context
+                                     * stack, see ItclPushFrameContext */
+    struct ItclFrameContext *frameContextFree;
+                                    /* pool of unused stack entries */
+    struct ItclFrameContextChunk *frameContextChunks;
+                                    /* memory blocks backing the pool */
+    int objectsDictStale;           /* set when objects come or go, the
+                                     * ::itcl::internal::dicts::objects
+                                     * mirror is rebuilt on its next read */
+    int numClassIds;                /* class ids handed out so far */
+    Itcl_Stack freeClassIds;        /* ids of freed classes, for reuse */
+    ItclPool pools[ITCL_POOL_NUM_SIZES];
+                                    /* record pools, by size, see
+                                     * ItclPoolAlloc */
+    Tcl_HashTable emptyObjectTable; /* always empty, stands in for the
+                                     * per-object tables not used yet */
+    Tcl_Obj *optionsVarNamePtr;     /* "itcl_options", name the option
+                                     * array is accessed by */
+    int classEpoch;                 /* incremented whenever a class is
+                                     * created, deleted or has its virtual
+                                     * tables rebuilt, see ItclMethodMap */
+    Tcl_Obj *snapshotPtr;           /* class definitions collected by
+                                     * "snapshot record", or NULL */
+    Tcl_Obj *snapshotBodyPtr;       /* split class body being defined by
+                                     * "snapshot load", or NULL */
+    struct ItclAutoIndex *autoIndexes;
+                                    /* index files read by
+                                     * "itcl::autoindex add" */
+    Tcl_HashTable *autoIndexEntriesPtr;
+                                    /* definitions in those index files,
+                                     * by full name, or NULL */
+    Tcl_HashTable *autoIndexMembersPtr;
+                                    /* bodies and configbodies in those
+                                     * index files, by full class name,
+                                     * or NULL */
+    Tcl_Obj *namespaceWordPtr;      /* "namespace", first word of all
+                                     * itcl::code results, see
+                                     * Itcl_CodeCmd */
+    Tcl_Obj *inscopeWordPtr;        /* "inscope", their second word */
+    int profiling;                  /* set while "itcl::profile start" is
+                                     * in effect */
+    struct ItclProfile *profilePtr; /* counters of the profiler, or NULL,
+                                     * see itclProfile.c */
+    unsigned int interpEpoch;       /* number of this interpreter, unique
+                                     * in the process, so that data kept
+                                     * in Tcl_Objs can tell it from a later
+                                     * one at the same address */
 } ItclObjectInfo;
 
 typedef struct EnsembleInfo {
@@ -241,6 +312,8 @@ typedef struct EnsembleInfo {
 #define ITCL_CLASS_NS_TEARDOWN            0x40000
 #define ITCL_CLASS_NO_VARNS_DELETE        0x80000
 #define ITCL_CLASS_SHOULD_VARNS_DELETE   0x100000
+#define ITCL_CLASS_VTABLES_BUILT         0x200000 /* resolveCmds is complete,
+                                                   * see Itcl_BuildVirtualTables */
 #define ITCL_CLASS_DESTRUCTOR_CALLED     0x400000
 
 
@@ -294,6 +367,8 @@ typedef struct ItclClass {
                                    * this class (e.g., x, foo::x, etc.) */
     Tcl_HashTable resolveCmds;    /* all possible names for functions in
                                    * this class (e.g., x, foo::x, etc.) */
+    Tcl_HashTable resolveCmdNames; /* same as resolveCmds, but with string
+                                   * keys for the command resolver */
     Tcl_HashTable contextCache;   /* cache for function contexts */
     struct ItclMemberFunc *unused2;
                                   /* the class constructor or NULL */
@@ -316,13 +391,121 @@ typedef struct ItclClass {
     Tcl_Obj *typeConstructorPtr;  /* initialization for types */
     int destructorHasBeenCalled;  /* prevent multiple invocations of destrcutor */
     int refCount;
+    struct ItclInstanceLayout *layoutPtr;
+                                  /* cached layout for new instances or NULL,
+                                   * built on first object creation */
+    int numVarSlots;              /* slots handed out to variables of this
+                                   * class, see ItclVariable.slot */
+    struct ItclConfigTable *configTablePtr;
+                                  /* public variables as seen by configure
+                                   * and cget or NULL, built on first use */
+    struct ItclObject *instancesPtr;
+                                  /* list of objects whose most specific
+                                   * class is this one, linked through
+                                   * ItclObject.nextInstancePtr */
+    struct ItclClass **hierarchy; /* this class followed by all base classes
+                                   * from most to least specific, or NULL
+                                   * until first needed */
+    int hierarchySize;            /* number of entries in hierarchy */
+    int classId;                  /* small integer identifying the class,
+                                   * unique among the live classes */
+    unsigned int *ancestorBits;   /* bitset of the ids of all classes in
+                                   * the hierarchy, or NULL until needed */
+    int ancestorWords;            /* number of words in ancestorBits */
+    Tcl_HashTable *methodMapPtr;  /* method names seen by
+                                   * ItclMapMethodNameProc, value is
+                                   * ItclMethodMap*, or NULL until used */
 } ItclClass;
 
 typedef struct ItclHierIter {
     ItclClass *current;           /* current position in hierarchy */
-    Itcl_Stack stack;             /* stack used for traversal */
+    Itcl_Stack stack;             /* classes still to visit, topmost next */
 } ItclHierIter;
 
+/*
+ *  Flattened description of the instance variables of a class and all
+ *  of its base classes.  It is built by ItclInitObjectVariables the first
+ *  time an object of the class is created and replayed for every further
+ *  object, so the hierarchy walk and the variable lookups are done once.
+ */
+typedef struct ItclVarLayout {
+    struct ItclVariable *ivPtr;   /* variable definition */
+    struct ItclComponent *icPtr;  /* component for component vars or NULL */
+    Tcl_VarTraceProc *traceProc;  /* read/write trace for built-in vars */
+    Tcl_Var commonVarPtr;         /* variable for commons */
+    Tcl_Obj *commonTracePtr;      /* full name of a traced common component */
+    Tcl_VarTraceProc *commonTraceProc;
+                                  /* write trace for commonTracePtr */
+    Tcl_Obj *arrayInitPtr;        /* list with array initializers or NULL */
+    int flags;                    /* ITCL_LAYOUT_* flags */
+} ItclVarLayout;
+
+#define ITCL_LAYOUT_RESOLVED      0x01
+#define ITCL_LAYOUT_OPTIONS       0x02
+#define ITCL_LAYOUT_BUILTIN       0x04  /* "this", "type", "self", "selfns"
+                                         * or "win", holds its value and
+                                         * only traces writes */
+#define ITCL_LAYOUT_LIVE          0x08  /* built-in that is computed on
+                                         * each read ("self" in widgets) */
+
+typedef struct ItclClassLayout {
+    ItclClass *iclsPtr;           /* class in the hierarchy */
+    int firstVar;                 /* index of first var in vars array */
+    int numVars;                  /* number of vars of this class */
+    int firstSlot;                /* index of the class's first variable
+                                   * in ItclObject.varSlots */
+    int numSlots;                 /* iclsPtr->numVarSlots at build time */
+    int firstOptSlot;             /* index of the class's first option
+                                   * in ItclObject.optionSlots */
+    int numOptSlots;              /* iclsPtr->numOptions at build time */
+} ItclClassLayout;
+
+typedef struct ItclInstanceLayout {
+    int refCount;                 /* the class and each object built from
+                                   * the layout hold a reference */
+    int numSlots;                 /* size of ItclObject.varSlots */
+    int numOptSlots;              /* size of ItclObject.optionSlots */
+    int numClasses;               /* number of classes in hierarchy */
+    ItclClassLayout *classes;     /* classes, most specific first */
+    int numVars;                  /* number of vars for all classes */
+    ItclVarLayout *vars;          /* vars in creation order */
+} ItclInstanceLayout;
+
+/*
+ *  Public variables of a class hierarchy as configuration options, see
+ *  ItclResolveConfigVar().  Discarded together with the instance layout.
+ */
+typedef struct ItclConfigVar {
+    struct ItclVariable *ivPtr;   /* public variable */
+    Tcl_Obj *optNamePtr;          /* "-" and least qualified name, the
+                                   * name configure reports */
+} ItclConfigVar;
+
+typedef struct ItclConfigTable {
+    int numVars;                  /* number of public variables */
+    ItclConfigVar *vars;          /* in hierarchy order, most specific
+                                   * class first */
+    Tcl_HashTable names;          /* option names resolved so far, value
+                                   * is ItclConfigVar* */
+} ItclConfigTable;
+
+/*
+ *  What ItclMapMethodNameProc() found for one method name in one class.
+ *  Only valid while classEpoch matches the one in ItclObjectInfo.
+ */
+typedef struct ItclMethodMap {
+    struct ItclClass *startIclsPtr;
+                                  /* class named by a "Class::" prefix, or
+                                   * NULL to start from the object's class */
+    Tcl_Obj *tailPtr;             /* name without the prefix, set together
+                                   * with startIclsPtr */
+    struct ItclMemberFunc *imPtr; /* member the name resolves to */
+    Tcl_Namespace *accessNsPtr;   /* namespace last granted access to
+                                   * imPtr, or NULL */
+    int classEpoch;               /* ItclObjectInfo.classEpoch when the
+                                   * name was resolved */
+} ItclMethodMap;
+
 #define ITCL_OBJECT_IS_DELETED           0x01
 #define ITCL_OBJECT_IS_DESTRUCTED        0x02
 #define ITCL_OBJECT_IS_DESTROYED         0x04
@@ -342,27 +525,43 @@ typedef struct ItclObject {
 
     Tcl_HashTable* constructed;  /* temp storage used during construction */
     Tcl_HashTable* destructed;   /* temp storage used during destruction */
-    Tcl_HashTable objectVariables;
-                                 /* used for storing Tcl_Var entries for
-				  * variable resolving, key is ivPtr of
-				  * variable, value is varPtr */
-    Tcl_HashTable objectOptions; /* definitions for all option members
+    struct ItclInstanceLayout *layoutPtr;
+                                 /* layout the variable slots were built
+				  * from or NULL */
+    Tcl_Var *varSlots;           /* Tcl_Var of each instance variable, see
+				  * ItclGetObjectVar() */
+    Tcl_HashTable *extraVariables;
+                                 /* Tcl_Var entries for variables added
+				  * after the object was created, key is
+				  * ivPtr of variable, or NULL */
+    Tcl_Var optionsVar;          /* the "itcl_options" array or NULL */
+    Tcl_Var *optionSlots;        /* element of optionsVar for each class
+				  * option, allocated on first use, see
+				  * ItclGetOptionValue() */
+
+    /*
+     *  The tables below are only filled for types, widgets and
+     *  extendedclasses.  Until then they all point to the shared empty
+     *  ItclObjectInfo.emptyObjectTable, ItclObjectTable() gives an
+     *  object its own table before an entry is created.
+     */
+    Tcl_HashTable *objectOptions;/* definitions for all option members
                                      in this object. Look up option namePtr
                                      names and get back ItclOption* ptrs */
-    Tcl_HashTable objectComponents; /* definitions for all component members
+    Tcl_HashTable *objectComponents; /* definitions for all component members
                                      in this object. Look up component namePtr
                                      names and get back ItclComponent* ptrs */
-    Tcl_HashTable objectMethodVariables;
+    Tcl_HashTable *objectMethodVariables;
                                  /* definitions for all methodvariable members
                                      in this object. Look up methodvariable
 				     namePtr names and get back
 				     ItclMethodVariable* ptrs */
-    Tcl_HashTable objectDelegatedOptions;
+    Tcl_HashTable *objectDelegatedOptions;
                                   /* definitions for all delegated option
 				     members in this object. Look up option
 				     namePtr names and get back
 				     ItclOption* ptrs */
-    Tcl_HashTable objectDelegatedFunctions;
+    Tcl_HashTable *objectDelegatedFunctions;
                                   /* definitions for all delegated function
 				     members in this object. Look up function
 				     namePtr names and get back
@@ -388,6 +587,13 @@ typedef struct ItclObject {
     int noComponentTrace;         /* don't call component traces if
                                    * setting components in DelegationInstall */
     int hadConstructorError;      /* needed for multiple calls of CallItclObjectCmd */
+    struct ItclObject *nextInstancePtr;
+    struct ItclObject *prevInstancePtr;
+                                  /* links in iclsPtr->instancesPtr, valid
+                                   * until the object is freed */
+    Tcl_Obj *callbackNamePtr;     /* instance name used in the callbacks
+                                   * made by mymethod, or NULL, see
+				   * ItclCallbackInstanceObj() */
 } ItclObject;
 
 #define ITCL_IGNORE_ERRS  0x002  /* useful for construction/destruction */
@@ -448,6 +654,8 @@ typedef struct ItclMemberCode {
 #define ITCL_COMPONENT         0x800  /* non-zero => component */
 #define ITCL_TYPE_METHOD       0x1000 /* non-zero => typemethod */
 #define ITCL_METHOD            0x2000 /* non-zero => method */
+#define ITCL_TYPE_RESOLVABLE   0x4000 /* non-zero => may be resolved
+                                       * directly within types and widgets */
 
 /*
  *  Flag bits for ItclMember: variables
@@ -518,6 +726,8 @@ typedef struct ItclMemberFunc {
     ClientData tmPtr;           /* TclOO methodPtr */
     ItclDelegatedFunction *idmPtr;
                                 /* if the function is delegated != NULL */
+    struct ItclProfileEntry *profilePtr;
+                                /* profiler counters, or NULL */
 } ItclMemberFunc;
 
 /*
@@ -536,6 +746,8 @@ typedef struct ItclVariable {
     int initted;                /* is set when first time initted, to check
                                  * for example itcl_hull var, which can be only
 				 * initialized once */
+    int slot;                   /* index among the variables of iclsPtr,
+                                 * locates it in ItclObject.varSlots */
 } ItclVariable;
 
 
@@ -575,6 +787,8 @@ typedef struct ItclOption {
     Tcl_Obj *validateMethodVarPtr;
     ItclDelegatedOption *idoPtr;
                                 /* if the option is delegated != NULL */
+    int slot;                   /* index among the options of iclsPtr,
+                                 * -1 for options added to an object */
 } ItclOption;
 
 /*
@@ -638,6 +852,29 @@ typedef struct ItclCallContext {
     int refCount;
 } ItclCallContext;
 
+/*
+ *  Entry of the per-interp call context stack.  Every method call and
+ *  every "info" invocation on an object pushes one of these, tagged with
+ *  the call frame and the TclOO call context it belongs to.  Entries are
+ *  taken from a pool so that a method call does not allocate memory.
+ */
+typedef struct ItclFrameContext {
+    struct ItclFrameContext *prevPtr;   /* next outer entry on the stack
+                                         * or next free entry in the pool */
+    Tcl_CallFrame *framePtr;            /* frame the context belongs to */
+    Tcl_ObjectContext contextPtr;       /* TclOO call context or NULL */
+    ItclCallContext *callContextPtr;    /* context in effect for the frame */
+    ItclCallContext context;            /* storage for a context that is
+                                         * not shared via contextCache */
+} ItclFrameContext;
+
+#define ITCL_FRAME_CONTEXT_CHUNK 32
+
+typedef struct ItclFrameContextChunk {
+    struct ItclFrameContextChunk *nextPtr;
+    ItclFrameContext entries[ITCL_FRAME_CONTEXT_CHUNK];
+} ItclFrameContextChunk;
+
 /*
  * The macro below is used to modify a "char" value (e.g. by casting
  * it to an unsigned character) so that it can be used safely with
@@ -701,6 +938,7 @@ MODULE_SCOPE int ItclObjectCmd(ClientData clientData, Tcl_Interp *interp,
         Tcl_Object oPtr, Tcl_Class clsPtr, int objc, Tcl_Obj *const *objv);
 MODULE_SCOPE int ItclCreateObject (Tcl_Interp *interp, const char* name,
         ItclClass *iclsPtr, int objc, Tcl_Obj *const objv[]);
+MODULE_SCOPE int ItclIsLiveObject(ItclObject *ioPtr);
 MODULE_SCOPE void ItclDeleteObjectVariablesNamespace(Tcl_Interp *interp,
         ItclObject *ioPtr);
 MODULE_SCOPE void ItclDeleteClassVariablesNamespace(Tcl_Interp *interp,
@@ -709,6 +947,13 @@ MODULE_SCOPE int ItclInfoInit(Tcl_Interp *interp, ItclObjectInfo *infoPtr);
 
 MODULE_SCOPE Tcl_HashEntry *ItclResolveVarEntry(
 	ItclClass* iclsPtr, const char *varName);
+MODULE_SCOPE ItclConfigTable *ItclGetConfigTable(ItclClass *iclsPtr);
+MODULE_SCOPE ItclConfigVar *ItclResolveConfigVar(ItclClass *iclsPtr,
+	const char *optName);
+MODULE_SCOPE void ItclDeleteConfigTable(ItclClass *iclsPtr);
+MODULE_SCOPE void ItclDeleteMethodMap(ItclClass *iclsPtr);
+MODULE_SCOPE void ItclFinishVirtualTables(ItclClass *iclsPtr);
+MODULE_SCOPE void ItclAddMemberFuncNames(ItclMemberFunc *imPtr);
 
 struct Tcl_ResolvedVarInfo;
 MODULE_SCOPE int Itcl_ClassCmdResolver(Tcl_Interp *interp, const char* name,
@@ -726,6 +971,50 @@ MODULE_SCOPE int Itcl_ClassCompiledVarResolver2(Tcl_Interp *interp,
         const char* name, int length, Tcl_Namespace *nsPtr,
         struct Tcl_ResolvedVarInfo **rPtr);
 MODULE_SCOPE int ItclSetParserResolver(Tcl_Namespace *nsPtr);
+MODULE_SCOPE ItclFrameContext *ItclPushFrameContext(ItclObjectInfo *infoPtr,
+        Tcl_CallFrame *framePtr, Tcl_ObjectContext contextPtr);
+MODULE_SCOPE ItclFrameContext *ItclFindFrameContext(ItclObjectInfo *infoPtr,
+        Tcl_CallFrame *framePtr, Tcl_ObjectContext contextPtr);
+MODULE_SCOPE void ItclPopFrameContext(ItclObjectInfo *infoPtr,
+        ItclFrameContext *fcPtr);
+MODULE_SCOPE void ItclDeleteFrameContexts(ItclObjectInfo *infoPtr);
+MODULE_SCOPE void *ItclPoolAlloc(ItclObjectInfo *infoPtr, size_t size);
+MODULE_SCOPE void ItclPoolFree(ItclObjectInfo *infoPtr, void *ptr,
+        size_t size);
+MODULE_SCOPE void *ItclPoolAllocPreservable(ItclObjectInfo *infoPtr,
+        size_t size);
+MODULE_SCOPE void ItclPoolFreePreservable(ItclObjectInfo *infoPtr, void *ptr,
+        size_t size);
+MODULE_SCOPE void ItclDeletePools(ItclObjectInfo *infoPtr);
+MODULE_SCOPE Tcl_ObjCmdProc ItclPoolsCmd;
+MODULE_SCOPE Tcl_ObjCmdProc ItclScopedVarCmd;
+MODULE_SCOPE Tcl_ObjCmdProc Itcl_LocalCmd;
+MODULE_SCOPE Tcl_Obj *ItclCallbackInstanceObj(ItclObject *ioPtr);
+MODULE_SCOPE Tcl_Obj *ItclGetCallbackCommand(Tcl_Interp *interp,
+        ItclObjectInfo *infoPtr, Tcl_Obj *instNamePtr);
+MODULE_SCOPE Tcl_ObjCmdProc Itcl_SnapshotRecordCmd;
+MODULE_SCOPE Tcl_ObjCmdProc Itcl_SnapshotLoadCmd;
+MODULE_SCOPE Tcl_ObjCmdProc Itcl_AutoIndexCreateCmd;
+MODULE_SCOPE Tcl_ObjCmdProc Itcl_AutoIndexAddCmd;
+MODULE_SCOPE Tcl_ObjCmdProc Itcl_AutoIndexLoadCmd;
+MODULE_SCOPE int ItclAutoload(Tcl_Interp *interp, const char *name);
+MODULE_SCOPE void ItclDeleteAutoIndexes(ItclObjectInfo *infoPtr);
+MODULE_SCOPE Tcl_ObjCmdProc Itcl_ProfileStartCmd;
+MODULE_SCOPE Tcl_ObjCmdProc Itcl_ProfileStopCmd;
+MODULE_SCOPE Tcl_ObjCmdProc Itcl_ProfileResetCmd;
+MODULE_SCOPE Tcl_ObjCmdProc Itcl_ProfileReportCmd;
+MODULE_SCOPE void ItclProfileEnter(ItclObjectInfo *infoPtr,
+        ItclMemberFunc *imPtr);
+MODULE_SCOPE void ItclProfileLeave(ItclObjectInfo *infoPtr,
+        ItclMemberFunc *imPtr);
+MODULE_SCOPE void ItclProfileForget(ItclMemberFunc *imPtr);
+MODULE_SCOPE void ItclDeleteProfile(ItclObjectInfo *infoPtr);
+MODULE_SCOPE void ItclSnapshotAddClass(ItclObjectInfo *infoPtr,
+        ItclClass *iclsPtr, Tcl_Obj *bodyPtr, int isSplit);
+MODULE_SCOPE void ItclSnapshotAddBody(ItclObjectInfo *infoPtr,
+        ItclClass *iclsPtr, const char *cmdName, const char *member,
+        int objc, Tcl_Obj *const objv[]);
+MODULE_SCOPE int ItclEvalSnapshotBody(Tcl_Interp *interp, Tcl_Obj *bodyPtr);
 MODULE_SCOPE void ItclProcErrorProc(Tcl_Interp *interp, Tcl_Obj *procNameObj);
 MODULE_SCOPE int Itcl_CreateOption (Tcl_Interp *interp, ItclClass *iclsPtr,
 	ItclOption *ioptPtr);
@@ -735,6 +1024,22 @@ MODULE_SCOPE int ItclCreateMethodVariable(Tcl_Interp *interp,
 MODULE_SCOPE int DelegationInstall(Tcl_Interp *interp, ItclObject *ioPtr,
         ItclClass *iclsPtr);
 MODULE_SCOPE ItclClass *ItclNamespace2Class(Tcl_Namespace *nsPtr);
+MODULE_SCOPE ItclClass *ItclNamespaceClass(ItclObjectInfo *infoPtr,
+        Tcl_Namespace *nsPtr);
+MODULE_SCOPE void ItclForgetNamespaceClass(ItclObjectInfo *infoPtr,
+        Tcl_Namespace *nsPtr);
+MODULE_SCOPE void ItclInvalidateInstanceLayout(ItclClass *iclsPtr);
+MODULE_SCOPE Tcl_Var ItclGetObjectVar(ItclObject *ioPtr, ItclVariable *ivPtr);
+MODULE_SCOPE Tcl_Obj *ItclGetOptionValue(Tcl_Interp *interp,
+        ItclObject *ioPtr, ItclOption *ioptPtr);
+MODULE_SCOPE Tcl_Obj *ItclSetOptionValue(Tcl_Interp *interp,
+        ItclObject *ioPtr, ItclOption *ioptPtr, Tcl_Obj *valuePtr);
+MODULE_SCOPE int ItclSetObjectVar(ItclObject *ioPtr, ItclVariable *ivPtr,
+        Tcl_Var varPtr);
+MODULE_SCOPE Tcl_HashTable *ItclObjectTable(ItclObject *ioPtr,
+        Tcl_HashTable **tablePtrPtr);
+MODULE_SCOPE void ItclInvalidateHierarchy(ItclClass *iclsPtr);
+MODULE_SCOPE int ItclClassIsa(ItclClass *iclsPtr, ItclClass *basePtr);
 MODULE_SCOPE const char* ItclGetCommonInstanceVar(Tcl_Interp *interp,
         const char *name, const char *name2, ItclObject *contextIoPtr,
 	ItclClass *contextIclsPtr);
@@ -787,9 +1092,7 @@ MODULE_SCOPE int Itcl_EnsembleDeleteCmd(ClientData clientData,
 MODULE_SCOPE int ItclAddClassesDictInfo(Tcl_Interp *interp, ItclClass *iclsPtr);
 MODULE_SCOPE int ItclDeleteClassesDictInfo(Tcl_Interp *interp,
         ItclClass *iclsPtr);
-MODULE_SCOPE int ItclAddObjectsDictInfo(Tcl_Interp *interp, ItclObject *ioPtr);
-MODULE_SCOPE int ItclDeleteObjectsDictInfo(Tcl_Interp *interp,
-        ItclObject *ioPtr);
+MODULE_SCOPE Tcl_VarTraceProc ItclObjectsDictTrace;
 MODULE_SCOPE int ItclAddOptionDictInfo(Tcl_Interp *interp, ItclClass *iclsPtr,
 	ItclOption *ioptPtr);
 MODULE_SCOPE int ItclAddDelegatedOptionDictInfo(Tcl_Interp *interp,
@@ -149,6 +149,10 @@ NRBodyCmd(
         status = TCL_ERROR;
         goto bodyCmdDone;
     }
+    if (iclsPtr->infoPtr->snapshotPtr != NULL) {
+        ItclSnapshotAddBody(iclsPtr->infoPtr, iclsPtr, "::itcl::body", tail,
+                objc - 2, objv + 2);
+    }
 
 bodyCmdDone:
     Tcl_DStringFree(&buffer);
@@ -282,6 +286,10 @@ NRConfigBodyCmd(
         Itcl_ReleaseData(ivPtr->codePtr);
     }
     ivPtr->codePtr = mcode;
+    if (iclsPtr->infoPtr->snapshotPtr != NULL) {
+        ItclSnapshotAddBody(iclsPtr->infoPtr, iclsPtr, "::itcl::configbody",
+                tail, objc - 2, objv + 2);
+    }
 
 configBodyCmdDone:
     Tcl_DStringFree(&buffer);
@@ -425,6 +433,35 @@ Itcl_CreateProc(
 }
 
 
+/*
+ * ------------------------------------------------------------------------
+ *  ItclIsTypeResolvableName()
+ *
+ *  Returns non-zero if a member function with the given name may be
+ *  invoked directly by its simple name from within a type or widget.
+ *  Used to precompute the ITCL_TYPE_RESOLVABLE flag checked by
+ *  Itcl_ClassCmdResolver.
+ * ------------------------------------------------------------------------
+ */
+static int
+ItclIsTypeResolvableName(
+    const char *name)
+{
+    static const char *typeResolvableNames[] = {
+	"info", "mytypemethod", "myproc", "mymethod", "mytypevar",
+	"myvar", "itcl_hull", "callinstance", "getinstancevar",
+	"installcomponent", NULL
+    };
+    const char **namePtr;
+
+    for (namePtr = typeResolvableNames; *namePtr != NULL; namePtr++) {
+	if (strcmp(name, *namePtr) == 0) {
+	    return 1;
+	}
+    }
+    return 0;
+}
+
 /*
  * ------------------------------------------------------------------------
  *  ItclCreateMemberFunc()
@@ -519,6 +556,9 @@ ItclCreateMemberFunc(
     }
 
     name = Tcl_GetString(namePtr);
+    if (ItclIsTypeResolvableName(name)) {
+        imPtr->flags |= ITCL_TYPE_RESOLVABLE;
+    }
     if ((body != NULL) && (body[0] == '@')) {
         /* check for builtin cget isa and configure and mark them for
 	 * use of a different arglist "args" for TclOO !! */
@@ -644,6 +684,7 @@ ItclCreateMemberFunc(
 
     Tcl_SetHashValue(hPtr, imPtr);
     Itcl_PreserveData(imPtr);
+    ItclAddMemberFuncNames(imPtr);
 
     *imPtrPtr = imPtr;
     return TCL_OK;
@@ -1142,13 +1183,7 @@ Itcl_GetMemberCode(
      */
 
     if (!Itcl_IsMemberCodeImplemented(mcode)) {
-        Tcl_DString buf;
-
-        Tcl_DStringInit(&buf);
-        Tcl_DStringAppend(&buf, "::auto_load ", -1);
-        Tcl_DStringAppend(&buf, Tcl_GetString(imPtr->fullNamePtr), -1);
-        result = Tcl_EvalEx(interp, Tcl_DStringValue(&buf), -1, 0);
-        Tcl_DStringFree(&buf);
+        result = ItclAutoload(interp, Tcl_GetString(imPtr->fullNamePtr));
         if (result != TCL_OK) {
             Tcl_AppendObjToErrorInfo(interp, Tcl_ObjPrintf(
                     "\n    (while autoloading code for \"%s\")",
@@ -1380,6 +1415,140 @@ EquivArgLists(
     return 1;
 }
 
+/*
+ * ------------------------------------------------------------------------
+ *  ItclPushFrameContext()
+ *
+ *  Pushes a new entry onto the call context stack of the interpreter.
+ *  The entry belongs to the given call frame and, for method calls,
+ *  to the TclOO call context.  Entries come from a pool which grows
+ *  in chunks and is only released when the interpreter goes away.
+ *
+ *  Returns the new entry.  Its callContextPtr must be set by the caller.
+ * ------------------------------------------------------------------------
+ */
+ItclFrameContext *
+ItclPushFrameContext(
+    ItclObjectInfo *infoPtr,
+    Tcl_CallFrame *framePtr,
+    Tcl_ObjectContext contextPtr)
+{
+    ItclFrameContext *fcPtr;
+    ItclFrameContextChunk *chunkPtr;
+    int i;
+
+    if (infoPtr->frameContextFree == NULL) {
+        chunkPtr = (ItclFrameContextChunk *)ckalloc(
+	        sizeof(ItclFrameContextChunk));
+        chunkPtr->nextPtr = infoPtr->frameContextChunks;
+        infoPtr->frameContextChunks = chunkPtr;
+        for (i = ITCL_FRAME_CONTEXT_CHUNK-1; i >= 0; i--) {
+            chunkPtr->entries[i].prevPtr = infoPtr->frameContextFree;
+            infoPtr->frameContextFree = &chunkPtr->entries[i];
+        }
+    }
+    fcPtr = infoPtr->frameContextFree;
+    infoPtr->frameContextFree = fcPtr->prevPtr;
+
+    fcPtr->framePtr = framePtr;
+    fcPtr->contextPtr = contextPtr;
+    fcPtr->callContextPtr = NULL;
+    memset(&fcPtr->context, 0, sizeof(ItclCallContext));
+    fcPtr->prevPtr = infoPtr->frameContextTop;
+    infoPtr->frameContextTop = fcPtr;
+    return fcPtr;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclFindFrameContext()
+ *
+ *  Looks for the innermost entry of the call context stack which
+ *  belongs to the given TclOO call context or, if contextPtr is NULL,
+ *  to the given call frame.  The entry searched for is almost always
+ *  the top of the stack; entries further down are only visited when
+ *  coroutines suspend method calls or a frame has no context at all.
+ *
+ *  Returns the entry, or NULL if there is none.
+ * ------------------------------------------------------------------------
+ */
+ItclFrameContext *
+ItclFindFrameContext(
+    ItclObjectInfo *infoPtr,
+    Tcl_CallFrame *framePtr,
+    Tcl_ObjectContext contextPtr)
+{
+    ItclFrameContext *fcPtr;
+
+    if (contextPtr != NULL) {
+        for (fcPtr = infoPtr->frameContextTop; fcPtr != NULL;
+	        fcPtr = fcPtr->prevPtr) {
+            if (fcPtr->contextPtr == contextPtr) {
+                return fcPtr;
+            }
+        }
+        return NULL;
+    }
+    for (fcPtr = infoPtr->frameContextTop; fcPtr != NULL;
+            fcPtr = fcPtr->prevPtr) {
+        if (fcPtr->framePtr == framePtr) {
+            return fcPtr;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclPopFrameContext()
+ *
+ *  Removes an entry from the call context stack and returns it to
+ *  the pool.  Any context stored in the entry itself becomes invalid.
+ * ------------------------------------------------------------------------
+ */
+void
+ItclPopFrameContext(
+    ItclObjectInfo *infoPtr,
+    ItclFrameContext *fcPtr)
+{
+    ItclFrameContext **linkPtrPtr;
+
+    linkPtrPtr = &infoPtr->frameContextTop;
+    while (*linkPtrPtr != fcPtr) {
+        if (*linkPtrPtr == NULL) {
+	    Tcl_Panic("frame context not on the context stack!");
+	}
+        linkPtrPtr = &(*linkPtrPtr)->prevPtr;
+    }
+    *linkPtrPtr = fcPtr->prevPtr;
+
+    fcPtr->prevPtr = infoPtr->frameContextFree;
+    infoPtr->frameContextFree = fcPtr;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclDeleteFrameContexts()
+ *
+ *  Releases the memory of the call context stack when the interpreter
+ *  is deleted.
+ * ------------------------------------------------------------------------
+ */
+void
+ItclDeleteFrameContexts(
+    ItclObjectInfo *infoPtr)
+{
+    ItclFrameContextChunk *chunkPtr;
+
+    while (infoPtr->frameContextChunks != NULL) {
+        chunkPtr = infoPtr->frameContextChunks;
+        infoPtr->frameContextChunks = chunkPtr->nextPtr;
+        ckfree((char *)chunkPtr);
+    }
+    infoPtr->frameContextTop = NULL;
+    infoPtr->frameContextFree = NULL;
+}
+
 /*
  * ------------------------------------------------------------------------
  *  Itcl_GetContext()
@@ -1401,29 +1570,19 @@ Itcl_SetContext(
     Tcl_Interp *interp,
     ItclObject *ioPtr)
 {
-    int isNew;
-    Itcl_Stack *stackPtr;
     Tcl_CallFrame *framePtr = Itcl_GetUplevelCallFrame(interp, 0);
     ItclObjectInfo *infoPtr = (ItclObjectInfo *)Tcl_GetAssocData(interp,
             ITCL_INTERP_DATA, NULL);
-    Tcl_HashEntry *hPtr = Tcl_CreateHashEntry(&infoPtr->frameContext,
-	    (char *)framePtr, &isNew);
-    ItclCallContext *contextPtr
-	    = (ItclCallContext *) ckalloc(sizeof(ItclCallContext));
+    ItclFrameContext *fcPtr;
 
-    memset(contextPtr, 0, sizeof(ItclCallContext));
-    contextPtr->ioPtr = ioPtr;
-    contextPtr->refCount = 1;
-
-    if (!isNew) {
+    if (ItclFindFrameContext(infoPtr, framePtr, NULL) != NULL) {
 	Tcl_Panic("frame already has context?!");
     }
 
-    stackPtr = (Itcl_Stack *) ckalloc(sizeof(Itcl_Stack));
-    Itcl_InitStack(stackPtr);
-    Tcl_SetHashValue(hPtr, stackPtr);
-
-    Itcl_PushStack(contextPtr, stackPtr);
+    fcPtr = ItclPushFrameContext(infoPtr, framePtr, NULL);
+    fcPtr->context.ioPtr = ioPtr;
+    fcPtr->context.refCount = 1;
+    fcPtr->callContextPtr = &fcPtr->context;
 }
 
 void
@@ -1433,21 +1592,15 @@ Itcl_UnsetContext(
     Tcl_CallFrame *framePtr = Itcl_GetUplevelCallFrame(interp, 0);
     ItclObjectInfo *infoPtr = (ItclObjectInfo *)Tcl_GetAssocData(interp,
             ITCL_INTERP_DATA, NULL);
-    Tcl_HashEntry *hPtr = Tcl_FindHashEntry(&infoPtr->frameContext,
-	    (char *)framePtr);
-    Itcl_Stack *stackPtr = (Itcl_Stack *) Tcl_GetHashValue(hPtr);
-    ItclCallContext *contextPtr = (ItclCallContext *)Itcl_PopStack(stackPtr);
+    ItclFrameContext *fcPtr = ItclFindFrameContext(infoPtr, framePtr, NULL);
 
-    if (Itcl_GetStackSize(stackPtr) > 0) {
-	Tcl_Panic("frame context stack not empty!");
-    }
-    Itcl_DeleteStack(stackPtr);
-    ckfree((char *) stackPtr);
-    Tcl_DeleteHashEntry(hPtr);
-    if (contextPtr->refCount-- > 1) {
+    if (fcPtr->callContextPtr->refCount-- > 1) {
 	Tcl_Panic("frame context ref count not zero!");
     }
-    ckfree((char *)contextPtr);
+    ItclPopFrameContext(infoPtr, fcPtr);
+    if (ItclFindFrameContext(infoPtr, framePtr, NULL) != NULL) {
+	Tcl_Panic("frame context stack not empty!");
+    }
 }
 
 int
@@ -1457,19 +1610,22 @@ Itcl_GetContext(
     ItclObject **ioPtrPtr)        /* returns:  object data or NULL */
 {
     Tcl_Namespace *nsPtr;
+    ItclClass *iclsPtr;
 
     /* Fetch the current call frame.  That determines context. */
     Tcl_CallFrame *framePtr = Itcl_GetUplevelCallFrame(interp, 0);
 
-    /* Try to map it to a context stack. */
+    /* Try to map it to a context stack entry. */
     ItclObjectInfo *infoPtr = (ItclObjectInfo *)Tcl_GetAssocData(interp,
             ITCL_INTERP_DATA, NULL);
-    Tcl_HashEntry *hPtr = Tcl_FindHashEntry(&infoPtr->frameContext,
-	    (char *)framePtr);
-    if (hPtr) {
-	/* Frame maps to a context stack. */
-	Itcl_Stack *stackPtr = (Itcl_Stack *)Tcl_GetHashValue(hPtr);
-	ItclCallContext *contextPtr = (ItclCallContext *)Itcl_PeekStack(stackPtr);
+    ItclFrameContext *fcPtr = infoPtr->frameContextTop;
+
+    if ((fcPtr != NULL) && (fcPtr->framePtr != framePtr)) {
+	fcPtr = ItclFindFrameContext(infoPtr, framePtr, NULL);
+    }
+    if (fcPtr) {
+	/* Frame maps to a context stack entry. */
+	ItclCallContext *contextPtr = fcPtr->callContextPtr;
 
 	assert(contextPtr);
 
@@ -1492,9 +1648,9 @@ Itcl_GetContext(
 
     /* Fall back to namespace for possible class context info. */
     nsPtr = Tcl_GetCurrentNamespace(interp);
-    hPtr = Tcl_FindHashEntry(&infoPtr->namespaceClasses, (char *)nsPtr);
-    if (hPtr) {
-	*iclsPtrPtr = (ItclClass *)Tcl_GetHashValue(hPtr);
+    iclsPtr = ItclNamespaceClass(infoPtr, nsPtr);
+    if (iclsPtr != NULL) {
+	*iclsPtrPtr = iclsPtr;
 
 	/*
 	 * DANGER! Following stanza of code was added to address a
@@ -2097,11 +2253,10 @@ Itcl_CmdAliasProc(
         iclsPtr = resolveInfoPtr->iclsPtr;
     }
     infoPtr = iclsPtr->infoPtr;
-    hPtr = Tcl_FindHashEntry(&infoPtr->namespaceClasses, (char *)nsPtr);
-    if (hPtr == NULL) {
+    iclsPtr = ItclNamespaceClass(infoPtr, nsPtr);
+    if (iclsPtr == NULL) {
 	return NULL;
     }
-    iclsPtr = (ItclClass *)Tcl_GetHashValue(hPtr);
     objPtr = Tcl_NewStringObj(cmdName, -1);
     hPtr = Tcl_FindHashEntry(&iclsPtr->resolveCmds, (char *)objPtr);
     Tcl_DecrRefCount(objPtr);
@@ -2198,6 +2353,7 @@ Itcl_VarAliasProc(
     Tcl_HashEntry *hPtr;
     ItclObjectInfo *infoPtr;
     ItclClass *iclsPtr;
+    ItclClass *iclsPtr2;
     ItclObject *ioPtr;
     ItclVarLookup *ivlPtr;
     ItclResolveInfo *resolveInfoPtr;
@@ -2216,9 +2372,9 @@ Itcl_VarAliasProc(
         iclsPtr = resolveInfoPtr->iclsPtr;
     }
     infoPtr = iclsPtr->infoPtr;
-    hPtr = Tcl_FindHashEntry(&infoPtr->namespaceClasses, (char *)nsPtr);
-    if (hPtr != NULL) {
-        iclsPtr = (ItclClass *)Tcl_GetHashValue(hPtr);
+    iclsPtr2 = ItclNamespaceClass(infoPtr, nsPtr);
+    if (iclsPtr2 != NULL) {
+        iclsPtr = iclsPtr2;
     }
     hPtr = ItclResolveVarEntry(iclsPtr, varName);
     if (hPtr == NULL) {
@@ -2234,24 +2390,21 @@ Itcl_VarAliasProc(
     }
 
     if (ioPtr != NULL) {
-        hPtr = Tcl_FindHashEntry(&ioPtr->objectVariables,
-	        (char *)ivlPtr->ivPtr);
+        varPtr = ItclGetObjectVar(ioPtr, ivlPtr->ivPtr);
     } else {
         hPtr = Tcl_FindHashEntry(&iclsPtr->classCommons,
 	        (char *)ivlPtr->ivPtr);
-        if (hPtr == NULL) {
+        if (hPtr != NULL) {
+            varPtr = (Tcl_Var)Tcl_GetHashValue(hPtr);
+        } else {
 	    if (callContextPtr != NULL) {
 	        ioPtr = callContextPtr->ioPtr;
 	    }
 	    if (ioPtr != NULL) {
-                hPtr = Tcl_FindHashEntry(&ioPtr->objectVariables,
-	                (char *)ivlPtr->ivPtr);
+                varPtr = ItclGetObjectVar(ioPtr, ivlPtr->ivPtr);
 	    }
 	}
     }
-    if (hPtr != NULL) {
-        varPtr = (Tcl_Var)Tcl_GetHashValue(hPtr);
-    }
     return varPtr;
 }
 
@@ -2300,7 +2453,7 @@ ItclCheckCallMethod(
     Tcl_CallFrame *framePtr,
     int *isFinished)
 {
-    Itcl_Stack *stackPtr;
+    ItclFrameContext *fcPtr;
 
     Tcl_Object oPtr;
     ItclObject *ioPtr;
@@ -2334,6 +2487,9 @@ ItclCheckCallMethod(
                 if (isFinished != NULL) {
                     *isFinished = 0;
                 }
+                if (imPtr->iclsPtr->infoPtr->profiling) {
+                    ItclProfileEnter(imPtr->iclsPtr->infoPtr, imPtr);
+                }
 		return TCL_OK;
             }
 	    Tcl_AppendResult(interp,
@@ -2382,6 +2538,12 @@ ItclCheckCallMethod(
 	goto finishReturn;
     }
   }
+    if (framePtr == NULL) {
+	framePtr = Itcl_GetUplevelCallFrame(interp, 0);
+    }
+    infoPtr = imPtr->iclsPtr->infoPtr;
+    fcPtr = ItclPushFrameContext(infoPtr, framePtr, contextPtr);
+
     isNew = 0;
     callContextPtr = NULL;
     currNsPtr = Tcl_GetCurrentNamespace(interp);
@@ -2392,7 +2554,7 @@ ItclCheckCallMethod(
 	    if (callContextPtr2->refCount == 0) {
 	        callContextPtr = callContextPtr2;
                 callContextPtr->objectFlags = ioPtr->flags;
-                callContextPtr->nsPtr = Tcl_GetCurrentNamespace(interp);
+                callContextPtr->nsPtr = currNsPtr;
                 callContextPtr->ioPtr = ioPtr;
                 callContextPtr->imPtr = imPtr;
                 callContextPtr->refCount = 1;
@@ -2403,57 +2565,29 @@ ItclCheckCallMethod(
                 callContextPtr->refCount++;
               }
             }
+        } else {
+            callContextPtr = (ItclCallContext *)ItclPoolAlloc(
+                    ioPtr->infoPtr, sizeof(ItclCallContext));
+            callContextPtr->objectFlags = ioPtr->flags;
+            callContextPtr->nsPtr = currNsPtr;
+            callContextPtr->ioPtr = ioPtr;
+            callContextPtr->imPtr = imPtr;
+            callContextPtr->refCount = 1;
+            Tcl_SetHashValue(hPtr, callContextPtr);
         }
     }
     if (callContextPtr == NULL) {
-        callContextPtr = (ItclCallContext *)ckalloc(
-                sizeof(ItclCallContext));
-	if (ioPtr == NULL) {
-            callContextPtr->objectFlags = 0;
-            callContextPtr->ioPtr = NULL;
-	} else {
+        /* context not shareable, keep it in the stack entry */
+        callContextPtr = &fcPtr->context;
+	if (ioPtr != NULL) {
             callContextPtr->objectFlags = ioPtr->flags;
             callContextPtr->ioPtr = ioPtr;
 	}
-        callContextPtr->nsPtr = Tcl_GetCurrentNamespace(interp);
+        callContextPtr->nsPtr = currNsPtr;
         callContextPtr->imPtr = imPtr;
         callContextPtr->refCount = 1;
     }
-    if (isNew) {
-        Tcl_SetHashValue(hPtr, callContextPtr);
-    }
-
-    if (framePtr == NULL) {
-	framePtr = Itcl_GetUplevelCallFrame(interp, 0);
-    }
-
-    isNew = 0;
-    infoPtr = imPtr->iclsPtr->infoPtr;
-    hPtr = Tcl_CreateHashEntry(&infoPtr->frameContext,
-	    (char *)framePtr, &isNew);
-    if (isNew) {
-	stackPtr = (Itcl_Stack *)ckalloc(sizeof(Itcl_Stack));
-	Itcl_InitStack(stackPtr);
-        Tcl_SetHashValue(hPtr, stackPtr);
-    } else {
-	stackPtr = (Itcl_Stack *)Tcl_GetHashValue(hPtr);
-    }
-
-    assert (callContextPtr) ;
-    Itcl_PushStack(callContextPtr, stackPtr);
-
-    /* Ugly abuse alert.  Two maps in one table */
-    hPtr = Tcl_CreateHashEntry(&infoPtr->frameContext,
-	    (char *)contextPtr, &isNew);
-    if (isNew) {
-	stackPtr = (Itcl_Stack *)ckalloc(sizeof(Itcl_Stack));
-	Itcl_InitStack(stackPtr);
-        Tcl_SetHashValue(hPtr, stackPtr);
-    } else {
-	stackPtr = (Itcl_Stack *)Tcl_GetHashValue(hPtr);
-    }
-
-    Itcl_PushStack(framePtr, stackPtr);
+    fcPtr->callContextPtr = callContextPtr;
 
     if (ioPtr != NULL) {
 	ioPtr->callRefCount++;
@@ -2468,6 +2602,9 @@ ItclCheckCallMethod(
     if (isFinished != NULL) {
         *isFinished = 0;
     }
+    if (infoPtr->profiling) {
+        ItclProfileEnter(infoPtr, imPtr);
+    }
     return result;
 finishReturn:
     Itcl_ReleaseData(imPtr);
@@ -2489,7 +2626,6 @@ ItclAfterCallMethod(
     TCL_UNUSED(Tcl_Namespace*),
     int call_result)
 {
-    Tcl_HashEntry *hPtr;
     ItclObject *ioPtr;
     ItclMemberFunc *imPtr;
     ItclCallContext *callContextPtr;
@@ -2497,31 +2633,24 @@ ItclAfterCallMethod(
     int result;
 
     imPtr = (ItclMemberFunc *)clientData;
+    if (imPtr->infoPtr->profiling) {
+        ItclProfileLeave(imPtr->infoPtr, imPtr);
+    }
     callContextPtr = NULL;
+    ioPtr = NULL;
     if (contextPtr != NULL) {
-    ItclObjectInfo *infoPtr = imPtr->infoPtr;
-    Tcl_CallFrame *framePtr;
-    Itcl_Stack *stackPtr;
-
-    hPtr = Tcl_FindHashEntry(&infoPtr->frameContext, (char *)contextPtr);
-    assert(hPtr);
-    stackPtr = (Itcl_Stack *)Tcl_GetHashValue(hPtr);
-    framePtr = (Tcl_CallFrame *)Itcl_PopStack(stackPtr);
-    if (Itcl_GetStackSize(stackPtr) == 0) {
-	Itcl_DeleteStack(stackPtr);
-	ckfree((char *) stackPtr);
-	Tcl_DeleteHashEntry(hPtr);
-    }
-
-    hPtr = Tcl_FindHashEntry(&infoPtr->frameContext, (char *)framePtr);
-    assert(hPtr);
-    stackPtr = (Itcl_Stack *)Tcl_GetHashValue(hPtr);
-    callContextPtr = (ItclCallContext *)Itcl_PopStack(stackPtr);
-    if (Itcl_GetStackSize(stackPtr) == 0) {
-	Itcl_DeleteStack(stackPtr);
-	ckfree((char *) stackPtr);
-	Tcl_DeleteHashEntry(hPtr);
-    }
+	ItclObjectInfo *infoPtr = imPtr->infoPtr;
+	ItclFrameContext *fcPtr;
+
+	fcPtr = ItclFindFrameContext(infoPtr, NULL, contextPtr);
+	assert(fcPtr);
+	callContextPtr = fcPtr->callContextPtr;
+	ioPtr = callContextPtr->ioPtr;
+	if (callContextPtr != &fcPtr->context) {
+	    /* shared context stays in the object's contextCache */
+	    callContextPtr->refCount--;
+	}
+	ItclPopFrameContext(infoPtr, fcPtr);
     }
     if (callContextPtr == NULL) {
         if ((imPtr->flags & ITCL_COMMON) ||
@@ -2541,7 +2670,6 @@ ItclAfterCallMethod(
      *  have been called.  This information is used to implicitly
      *  invoke constructors/destructors as needed.
      */
-    ioPtr = callContextPtr->ioPtr;
     if (ioPtr != NULL) {
       if (imPtr->iclsPtr) {
         imPtr->iclsPtr->callRefCount--;
@@ -2564,18 +2692,6 @@ ItclAfterCallMethod(
         }
     }
 
-    if (callContextPtr->refCount-- <= 1) {
-        if (callContextPtr->ioPtr != NULL) {
-	    hPtr = Tcl_FindHashEntry(&callContextPtr->ioPtr->contextCache,
-	            (char *)callContextPtr->imPtr);
-            if (hPtr == NULL) {
-                ckfree((char *)callContextPtr);
-	    }
-        } else {
-            ckfree((char *)callContextPtr);
-        }
-    }
-
     if (ioPtr != NULL) {
 	Itcl_ReleaseData(ioPtr); /* -- paired release for preserve in ItclCheckCallMethod */
     }
@@ -2598,23 +2714,22 @@ ItclProcErrorProc(
     ItclObject *contextIoPtr;
     ItclClass *currIclsPtr;
     char num[20];
-    Itcl_Stack *stackPtr;
+    ItclFrameContext *fcPtr;
 
     /* Fetch the current call frame.  That determines context. */
     Tcl_CallFrame *framePtr = Itcl_GetUplevelCallFrame(interp, 0);
 
-    /* Try to map it to a context stack. */
+    /* Try to map it to a context stack entry. */
     infoPtr = (ItclObjectInfo *)Tcl_GetAssocData(interp,
             ITCL_INTERP_DATA, NULL);
-    hPtr = Tcl_FindHashEntry(&infoPtr->frameContext, (char *)framePtr);
-    if (hPtr == NULL) {
+    fcPtr = ItclFindFrameContext(infoPtr, framePtr, NULL);
+    if (fcPtr == NULL) {
 	/* Can this happen? */
 	return;
     }
 
-    /* Frame maps to a context stack. */
-    stackPtr = (Itcl_Stack *)Tcl_GetHashValue(hPtr);
-    callContextPtr = (ItclCallContext *)Itcl_PeekStack(stackPtr);
+    /* Frame maps to a context stack entry. */
+    callContextPtr = fcPtr->callContextPtr;
 
     if (callContextPtr == NULL) {
 	return;
@@ -90,6 +90,155 @@ Itcl_ReleaseVar(
     TclCleanupVar(varPtr, NULL);
 }
 
+/*
+ * Stores valuePtr in a scalar variable without going through traces.
+ * Returns TCL_ERROR if the variable is gone or is an array or link.
+ */
+int
+Itcl_SetScalarVar(
+    Tcl_Var var,
+    Tcl_Obj *valuePtr)
+{
+    Var *varPtr = (Var *)var;
+    Tcl_Obj *oldValuePtr;
+
+    if (TclIsVarDeadHash(varPtr) || !TclIsVarScalar(varPtr)) {
+        return TCL_ERROR;
+    }
+    oldValuePtr = varPtr->value.objPtr;
+    Tcl_IncrRefCount(valuePtr);
+    varPtr->value.objPtr = valuePtr;
+    if (oldValuePtr != NULL) {
+        Tcl_DecrRefCount(oldValuePtr);
+    }
+    return TCL_OK;
+}
+
+/*
+ * Returns 1 for a live scalar variable without traces, which can be read
+ * and written with Itcl_GetScalarVar() and Itcl_SetScalarVar() instead
+ * of going through the Tcl variable API.
+ */
+int
+Itcl_IsPlainScalarVar(
+    Tcl_Var var)
+{
+    Var *varPtr = (Var *)var;
+
+    return !TclIsVarDeadHash(varPtr) && TclIsVarScalar(varPtr)
+	    && !TclIsVarTraced(varPtr);
+}
+
+/*
+ * Returns the value of a scalar variable or NULL if it is undefined.
+ */
+Tcl_Obj *
+Itcl_GetScalarVar(
+    Tcl_Var var)
+{
+    return ((Var *)var)->value.objPtr;
+}
+
+/*
+ * Returns 1 if the variable was removed from its table while it was
+ * still preserved, e.g. because its array or namespace went away.
+ */
+int
+Itcl_IsVarDead(
+    Tcl_Var var)
+{
+    return TclIsVarDeadHash((Var *)var) != 0;
+}
+
+/*
+ * Looks up element keyPtr of the array named by the fully qualified
+ * arrayNamePtr, creating the array and the element if create is set.
+ * Returns NULL if there is no such element or it cannot be created,
+ * otherwise the element and, in arrayVarPtr, the array.
+ */
+Tcl_Var
+Itcl_LookupArrayElement(
+    Tcl_Interp *interp,
+    Tcl_Obj *arrayNamePtr,
+    Tcl_Obj *keyPtr,
+    int create,
+    Tcl_Var *arrayVarPtr)
+{
+    Var *varPtr;
+    Var *arrayPtr = NULL;
+
+    varPtr = TclObjLookupVar(interp, arrayNamePtr, TclGetString(keyPtr),
+	    TCL_GLOBAL_ONLY, "access", create, create, &arrayPtr);
+    if ((varPtr == NULL) || (arrayPtr == NULL)) {
+	return NULL;
+    }
+    *arrayVarPtr = (Tcl_Var)arrayPtr;
+    return (Tcl_Var)varPtr;
+}
+
+/*
+ * Same for an array variable found before, without any name lookup.
+ * Returns NULL if arrayVar is no longer an array or has no element
+ * keyPtr, or if the element should be created while an array search is
+ * active; Itcl_LookupArrayElement() handles those cases.
+ */
+Tcl_Var
+Itcl_FindArrayElement(
+    Tcl_Var arrayVar,
+    Tcl_Obj *keyPtr,
+    int create)
+{
+    Var *arrayPtr = (Var *)arrayVar;
+    Var *varPtr;
+    int isNew;
+
+    if (TclIsVarDeadHash(arrayPtr) || !TclIsVarArray(arrayPtr)) {
+	return NULL;
+    }
+    if (!create) {
+	return (Tcl_Var)TclVarHashFindVar(arrayPtr->value.tablePtr,
+		TclGetString(keyPtr));
+    }
+    if (arrayPtr->flags & VAR_SEARCH_ACTIVE) {
+	return NULL;
+    }
+    varPtr = TclVarHashCreateVar(arrayPtr->value.tablePtr,
+	    TclGetString(keyPtr), &isNew);
+    if (isNew) {
+	TclSetVarArrayElement(varPtr);
+    }
+    return (Tcl_Var)varPtr;
+}
+
+/*
+ * Reads and writes an array element found by Itcl_FindArrayElement().
+ * Traces fire and errors are reported as for arrayNamePtr(keyPtr).
+ */
+Tcl_Obj *
+Itcl_GetElementValue(
+    Tcl_Interp *interp,
+    Tcl_Var var,
+    Tcl_Var arrayVar,
+    Tcl_Obj *arrayNamePtr,
+    Tcl_Obj *keyPtr)
+{
+    return TclPtrGetVar(interp, var, arrayVar, arrayNamePtr, keyPtr,
+	    TCL_LEAVE_ERR_MSG);
+}
+
+Tcl_Obj *
+Itcl_SetElementValue(
+    Tcl_Interp *interp,
+    Tcl_Var var,
+    Tcl_Var arrayVar,
+    Tcl_Obj *arrayNamePtr,
+    Tcl_Obj *keyPtr,
+    Tcl_Obj *valuePtr)
+{
+    return TclPtrSetVar(interp, var, arrayVar, arrayNamePtr, keyPtr,
+	    valuePtr, TCL_LEAVE_ERR_MSG);
+}
+
 Tcl_CallFrame *
 Itcl_GetUplevelCallFrame(
     Tcl_Interp *interp,
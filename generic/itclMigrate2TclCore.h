@@ -75,6 +75,20 @@ MODULE_SCOPE Tcl_Var Tcl_NewNamespaceVar(Tcl_Interp *interp, Tcl_Namespace *nsPt
 	const char *varName);
 MODULE_SCOPE void Itcl_PreserveVar(Tcl_Var var);
 MODULE_SCOPE void Itcl_ReleaseVar(Tcl_Var var);
+MODULE_SCOPE int Itcl_SetScalarVar(Tcl_Var var, Tcl_Obj *valuePtr);
+MODULE_SCOPE int Itcl_IsVarDead(Tcl_Var var);
+MODULE_SCOPE Tcl_Var Itcl_LookupArrayElement(Tcl_Interp *interp,
+        Tcl_Obj *arrayNamePtr, Tcl_Obj *keyPtr, int create,
+        Tcl_Var *arrayVarPtr);
+MODULE_SCOPE Tcl_Var Itcl_FindArrayElement(Tcl_Var arrayVar, Tcl_Obj *keyPtr,
+        int create);
+MODULE_SCOPE Tcl_Obj *Itcl_GetElementValue(Tcl_Interp *interp, Tcl_Var var,
+        Tcl_Var arrayVar, Tcl_Obj *arrayNamePtr, Tcl_Obj *keyPtr);
+MODULE_SCOPE int Itcl_IsPlainScalarVar(Tcl_Var var);
+MODULE_SCOPE Tcl_Obj *Itcl_GetScalarVar(Tcl_Var var);
+MODULE_SCOPE Tcl_Obj *Itcl_SetElementValue(Tcl_Interp *interp, Tcl_Var var,
+        Tcl_Var arrayVar, Tcl_Obj *arrayNamePtr, Tcl_Obj *keyPtr,
+        Tcl_Obj *valuePtr);
 MODULE_SCOPE int Itcl_IsCallFrameArgument(Tcl_Interp *interp, const char *name);
 MODULE_SCOPE int Itcl_GetCallVarFrameObjc(Tcl_Interp *interp);
 MODULE_SCOPE Tcl_Obj * const * Itcl_GetCallVarFrameObjv(Tcl_Interp *interp);
@@ -35,6 +35,10 @@
 /*
  *  FORWARD DECLARATIONS
  */
+static Tcl_Obj *BuiltinVarValue(ItclObject *ioPtr, int varFlags,
+	Tcl_Namespace *nsPtr);
+static void RefreshBuiltinVars(Tcl_Interp *interp, ItclObject *ioPtr,
+	int varFlags);
 static char* ItclTraceThisVar(ClientData cdata, Tcl_Interp *interp,
 	const char *name1, const char *name2, int flags);
 static char* ItclTraceTypeVar(ClientData cdata, Tcl_Interp *interp,
@@ -45,8 +49,6 @@ static char* ItclTraceSelfnsVar(ClientData cdata, Tcl_Interp *interp,
 	const char *name1, const char *name2, int flags);
 static char* ItclTraceWinVar(ClientData cdata, Tcl_Interp *interp,
 	const char *name1, const char *name2, int flags);
-static char* ItclTraceOptionVar(ClientData cdata, Tcl_Interp *interp,
-	const char *name1, const char *name2, int flags);
 static char* ItclTraceComponentVar(ClientData cdata, Tcl_Interp *interp,
 	const char *name1, const char *name2, int flags);
 static char* ItclTraceItclHullVar(ClientData cdata, Tcl_Interp *interp,
@@ -60,6 +62,9 @@ static int ItclDestructBase(Tcl_Interp *interp, ItclObject *contextObj,
 
 static int ItclInitObjectVariables(Tcl_Interp *interp, ItclObject *ioPtr,
         ItclClass *iclsPtr);
+static ItclInstanceLayout *ItclBuildInstanceLayout(Tcl_Interp *interp,
+        ItclClass *iclsPtr);
+static void ItclReleaseInstanceLayout(ItclInstanceLayout *layoutPtr);
 static int ItclInitObjectCommands(Tcl_Interp *interp, ItclObject *ioPtr,
         ItclClass *iclsPtr, const char *name);
 static int ItclInitExtendedClassOptions(Tcl_Interp *interp, ItclObject *ioPtr);
@@ -122,6 +127,11 @@ ObjectRenamedTrace(
 
     if (newName != NULL) {
 	/* FIXME should enter the new name in the hashtables for objects etc. */
+	if (!(ioPtr->flags & (ITCL_OBJECT_IS_DESTRUCTED|
+	        ITCL_OBJECT_CLASS_DESTRUCTED))) {
+	    RefreshBuiltinVars(ioPtr->interp, ioPtr,
+		    ITCL_THIS_VAR|ITCL_SELF_VAR);
+	}
         return;
     }
     if (ioPtr->flags & ITCL_OBJECT_CLASS_DESTRUCTED) {
@@ -250,23 +260,39 @@ ItclCreateObject(
     /*
      *  Create a new object and initialize it.
      */
-    ioPtr = (ItclObject*)Itcl_Alloc(sizeof(ItclObject));
+    ioPtr = (ItclObject*)ItclPoolAllocPreservable(infoPtr, sizeof(ItclObject));
     Itcl_EventuallyFree(ioPtr, (Tcl_FreeProc *)FreeObject);
     ioPtr->iclsPtr = iclsPtr;
     ioPtr->interp = interp;
     ioPtr->infoPtr = infoPtr;
     ItclPreserveClass(iclsPtr);
 
-    ioPtr->constructed = (Tcl_HashTable*)ckalloc(sizeof(Tcl_HashTable));
+    ioPtr->constructed = (Tcl_HashTable*)ItclPoolAlloc(infoPtr,
+            sizeof(Tcl_HashTable));
     Tcl_InitObjHashTable(ioPtr->constructed);
 
     ioPtr->oPtr = Tcl_NewObjectInstance(interp, iclsPtr->clsPtr, NULL,
             /* nsName */ NULL, /* objc */ -1, /* objv */ NULL, /* skip */ 0);
     if (ioPtr->oPtr == NULL) {
-	Itcl_Free(ioPtr);
+        Tcl_DeleteHashTable(ioPtr->constructed);
+        ItclPoolFree(infoPtr, ioPtr->constructed, sizeof(Tcl_HashTable));
+        ItclReleaseClass(iclsPtr);
+        Itcl_EventuallyFree(ioPtr, NULL);
+        ItclPoolFreePreservable(infoPtr, ioPtr, sizeof(ItclObject));
         return TCL_ERROR;
     }
 
+    /*
+     *  Link the object into the instance list of its class.  It stays
+     *  there until FreeObject, so users of the list must skip objects
+     *  that are already deleted, see ItclIsLiveObject().
+     */
+    ioPtr->nextInstancePtr = iclsPtr->instancesPtr;
+    if (iclsPtr->instancesPtr != NULL) {
+        iclsPtr->instancesPtr->prevInstancePtr = ioPtr;
+    }
+    iclsPtr->instancesPtr = ioPtr;
+
     /*
      *  Add a command to the current namespace with the object name.
      *  This is done before invoking the constructors so that the
@@ -294,12 +320,11 @@ ItclCreateObject(
     Tcl_IncrRefCount(ioPtr->varNsNamePtr);
     Tcl_DStringFree(&buffer);
 
-    Tcl_InitHashTable(&ioPtr->objectVariables, TCL_ONE_WORD_KEYS);
-    Tcl_InitObjHashTable(&ioPtr->objectOptions);
-    Tcl_InitObjHashTable(&ioPtr->objectComponents);
-    Tcl_InitObjHashTable(&ioPtr->objectDelegatedOptions);
-    Tcl_InitObjHashTable(&ioPtr->objectDelegatedFunctions);
-    Tcl_InitObjHashTable(&ioPtr->objectMethodVariables);
+    ioPtr->objectOptions = &infoPtr->emptyObjectTable;
+    ioPtr->objectComponents = &infoPtr->emptyObjectTable;
+    ioPtr->objectDelegatedOptions = &infoPtr->emptyObjectTable;
+    ioPtr->objectDelegatedFunctions = &infoPtr->emptyObjectTable;
+    ioPtr->objectMethodVariables = &infoPtr->emptyObjectTable;
     Tcl_InitHashTable(&ioPtr->contextCache, TCL_ONE_WORD_KEYS);
 
     Itcl_PreserveData(ioPtr);
@@ -442,11 +467,14 @@ ItclCreateObject(
     cmdInfo.deleteProc = ItclDestroyObject;
     cmdInfo.deleteData = ioPtr;
     Tcl_SetCommandInfoFromToken(ioPtr->accessCmd, &cmdInfo);
-    ioPtr->resolvePtr = (Tcl_Resolve *)ckalloc(sizeof(Tcl_Resolve));
+    RefreshBuiltinVars(interp, ioPtr,
+            ITCL_THIS_VAR|ITCL_SELF_VAR);
+    ioPtr->resolvePtr = (Tcl_Resolve *)ItclPoolAlloc(infoPtr,
+            sizeof(Tcl_Resolve));
     ioPtr->resolvePtr->cmdProcPtr = Itcl_CmdAliasProc;
     ioPtr->resolvePtr->varProcPtr = Itcl_VarAliasProc;
-    resolveInfoPtr = (ItclResolveInfo *)ckalloc(sizeof(ItclResolveInfo));
-    memset (resolveInfoPtr, 0, sizeof(ItclResolveInfo));
+    resolveInfoPtr = (ItclResolveInfo *)ItclPoolAlloc(infoPtr,
+            sizeof(ItclResolveInfo));
     resolveInfoPtr->flags = ITCL_RESOLVE_OBJECT;
     resolveInfoPtr->ioPtr = ioPtr;
     ioPtr->resolvePtr->clientData = resolveInfoPtr;
@@ -687,9 +715,9 @@ ItclCreateObject(
     }
     infoPtr->lastIoPtr = ioPtr;
     Tcl_DeleteHashTable(ioPtr->constructed);
-    ckfree((char*)ioPtr->constructed);
+    ItclPoolFree(infoPtr, ioPtr->constructed, sizeof(Tcl_HashTable));
     ioPtr->constructed = NULL;
-    ItclAddObjectsDictInfo(interp, ioPtr);
+    infoPtr->objectsDictStale = 1;
     Itcl_ReleaseData(ioPtr);
     return result;
 
@@ -711,7 +739,7 @@ errorReturn:
     }
     if (ioPtr->constructed != NULL) {
         Tcl_DeleteHashTable(ioPtr->constructed);
-        ckfree((char*)ioPtr->constructed);
+        ItclPoolFree(infoPtr, ioPtr->constructed, sizeof(Tcl_HashTable));
         ioPtr->constructed = NULL;
     }
     ItclDeleteObjectVariablesNamespace(interp, ioPtr);
@@ -744,13 +772,553 @@ ItclInitObjectCommands(
     return TCL_OK;
 }
 
+/*
+ * ------------------------------------------------------------------------
+ *  ItclBuildInstanceLayout()
+ *
+ *  Walks the class hierarchy once and collects everything needed to
+ *  initialize the instance variables of a new object:  the classes in
+ *  hierarchy order, the variables of each class, their components,
+ *  traces, common variables and array initializers.  The result is
+ *  cached in the class by ItclInitObjectVariables() and replayed for
+ *  each new object.
+ *
+ *  Returns NULL along with an error message in the interpreter if
+ *  the class definition is inconsistent.
+ * ------------------------------------------------------------------------
+ */
+static ItclInstanceLayout *
+ItclBuildInstanceLayout(
+   Tcl_Interp *interp,
+   ItclClass *iclsPtr)
+{
+    Tcl_HashEntry *hPtr;
+    Tcl_HashSearch place;
+    Tcl_Obj **objv;
+    ItclInstanceLayout *layoutPtr;
+    ItclClassLayout *iclPtr;
+    ItclVarLayout *ivlPtr;
+    ItclClass *iclsPtr2;
+    ItclHierIter hier;
+    ItclVariable *ivPtr;
+    const char *varName;
+    int numClasses;
+    int numVars;
+    int itclOptionsIsSet;
+    int objc;
+
+    numClasses = 0;
+    numVars = 0;
+    Itcl_InitHierIter(&hier, iclsPtr);
+    while ((iclsPtr2 = Itcl_AdvanceHierIter(&hier)) != NULL) {
+        numClasses++;
+	numVars += iclsPtr2->variables.numEntries;
+    }
+    Itcl_DeleteHierIter(&hier);
+
+    layoutPtr = (ItclInstanceLayout *)ckalloc(sizeof(ItclInstanceLayout));
+    layoutPtr->refCount = 1;
+    layoutPtr->numSlots = 0;
+    layoutPtr->numOptSlots = 0;
+    layoutPtr->numClasses = 0;
+    layoutPtr->classes = (ItclClassLayout *)ckalloc(
+            numClasses * sizeof(ItclClassLayout));
+    layoutPtr->numVars = 0;
+    layoutPtr->vars = (ItclVarLayout *)ckalloc(
+            (numVars + 1) * sizeof(ItclVarLayout));
+    memset(layoutPtr->vars, 0, (numVars + 1) * sizeof(ItclVarLayout));
+
+    itclOptionsIsSet = 0;
+    Itcl_InitHierIter(&hier, iclsPtr);
+    while ((iclsPtr2 = Itcl_AdvanceHierIter(&hier)) != NULL) {
+	iclPtr = &layoutPtr->classes[layoutPtr->numClasses++];
+	iclPtr->iclsPtr = iclsPtr2;
+	iclPtr->firstVar = layoutPtr->numVars;
+	iclPtr->numVars = 0;
+	iclPtr->firstSlot = layoutPtr->numSlots;
+	iclPtr->numSlots = iclsPtr2->numVarSlots;
+	layoutPtr->numSlots += iclPtr->numSlots;
+	iclPtr->firstOptSlot = layoutPtr->numOptSlots;
+	iclPtr->numOptSlots = iclsPtr2->numOptions;
+	layoutPtr->numOptSlots += iclPtr->numOptSlots;
+        hPtr = Tcl_FirstHashEntry(&iclsPtr2->variables, &place);
+        for ( ; hPtr != NULL; hPtr = Tcl_NextHashEntry(&place)) {
+            ivPtr = (ItclVariable*)Tcl_GetHashValue(hPtr);
+	    varName = Tcl_GetString(ivPtr->namePtr);
+	    ivlPtr = &layoutPtr->vars[layoutPtr->numVars++];
+	    iclPtr->numVars++;
+	    ivlPtr->ivPtr = ivPtr;
+            if ((ivPtr->flags & ITCL_OPTIONS_VAR) && !itclOptionsIsSet) {
+                /* this is the special code for the "itcl_options" variable */
+		itclOptionsIsSet = 1;
+		ivlPtr->flags |= ITCL_LAYOUT_OPTIONS;
+	        continue;
+            }
+            if (ivPtr->flags & ITCL_COMPONENT_VAR) {
+		Tcl_HashEntry *hPtr2;
+
+		hPtr2 = Tcl_FindHashEntry(&ivPtr->iclsPtr->components,
+		        (char *)ivPtr->namePtr);
+		if (hPtr2 == NULL) {
+		    Tcl_AppendResult(interp, "cannot find component \"",
+		            Tcl_GetString(ivPtr->namePtr), "\" in class \"",
+			    Tcl_GetString(ivPtr->iclsPtr->namePtr), NULL);
+		    goto errorCleanup;
+		}
+		ivlPtr->icPtr = (ItclComponent *)Tcl_GetHashValue(hPtr2);
+	    }
+            if (ItclResolveVarEntry(ivPtr->iclsPtr, varName) == NULL) {
+	        continue;
+            }
+	    ivlPtr->flags |= ITCL_LAYOUT_RESOLVED;
+	    if ((ivPtr->flags & ITCL_COMMON) == 0) {
+	        if (ivPtr->flags & (ITCL_THIS_VAR|ITCL_TYPE_VAR|
+		        ITCL_SELF_VAR|ITCL_SELFNS_VAR|ITCL_WIN_VAR)) {
+		    ivlPtr->flags |= ITCL_LAYOUT_BUILTIN;
+		    if ((ivPtr->flags & ITCL_SELF_VAR) && (iclsPtr->flags
+		            & (ITCL_WIDGET|ITCL_WIDGETADAPTOR))) {
+			ivlPtr->flags |= ITCL_LAYOUT_LIVE;
+		    }
+		}
+	        if (ivPtr->flags & ITCL_THIS_VAR) {
+		    ivlPtr->traceProc = ItclTraceThisVar;
+		} else if (ivPtr->flags & ITCL_TYPE_VAR) {
+		    ivlPtr->traceProc = ItclTraceTypeVar;
+		} else if (ivPtr->flags & ITCL_SELF_VAR) {
+		    ivlPtr->traceProc = ItclTraceSelfVar;
+		} else if (ivPtr->flags & ITCL_SELFNS_VAR) {
+		    ivlPtr->traceProc = ItclTraceSelfnsVar;
+		} else if (ivPtr->flags & ITCL_WIN_VAR) {
+		    ivlPtr->traceProc = ItclTraceWinVar;
+		} else if (ivPtr->flags & ITCL_HULL_VAR) {
+		    ivlPtr->traceProc = ItclTraceItclHullVar;
+		} else if (ivPtr->arrayInitPtr != NULL) {
+		    if (Tcl_ListObjGetElements(interp, ivPtr->arrayInitPtr,
+		            &objc, &objv) != TCL_OK) {
+			goto errorCleanup;
+		    }
+		    ivlPtr->arrayInitPtr = Tcl_NewListObj(objc, objv);
+		    Tcl_IncrRefCount(ivlPtr->arrayInitPtr);
+		}
+	    } else {
+		Tcl_HashEntry *hPtr2;
+
+	        if (ivPtr->flags & ITCL_HULL_VAR) {
+		    ivlPtr->traceProc = ItclTraceItclHullVar;
+		}
+	        hPtr2 = Tcl_FindHashEntry(&iclsPtr2->classCommons,
+		        (char *)ivPtr);
+		if (hPtr2 == NULL) {
+		    goto errorCleanup;
+		}
+		ivlPtr->commonVarPtr = (Tcl_Var)Tcl_GetHashValue(hPtr2);
+	        if (ivPtr->flags & ITCL_COMPONENT_VAR) {
+		    ivlPtr->commonTracePtr = Tcl_NewStringObj(
+		            ITCL_VARIABLES_NAMESPACE, -1);
+		    Tcl_AppendToObj(ivlPtr->commonTracePtr,
+		            (Tcl_GetObjectNamespace(
+			    ivPtr->iclsPtr->oPtr))->fullName, -1);
+                    Tcl_AppendToObj(ivlPtr->commonTracePtr, "::", -1);
+                    Tcl_AppendToObj(ivlPtr->commonTracePtr, varName, -1);
+		    Tcl_IncrRefCount(ivlPtr->commonTracePtr);
+		    /* itcl_hull is traced in itclParse.c */
+		    if (strcmp(varName, "itcl_hull") == 0) {
+		        ivlPtr->commonTraceProc = ItclTraceItclHullVar;
+		    } else {
+		        ivlPtr->commonTraceProc = ItclTraceComponentVar;
+		    }
+		}
+	    }
+        }
+    }
+    Itcl_DeleteHierIter(&hier);
+    return layoutPtr;
+errorCleanup:
+    Itcl_DeleteHierIter(&hier);
+    ItclReleaseInstanceLayout(layoutPtr);
+    return NULL;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclReleaseInstanceLayout()
+ *
+ *  Drops a reference to a layout built by ItclBuildInstanceLayout()
+ *  and frees it once neither the class nor any object uses it.
+ * ------------------------------------------------------------------------
+ */
+static void
+ItclReleaseInstanceLayout(
+    ItclInstanceLayout *layoutPtr)
+{
+    ItclVarLayout *ivlPtr;
+    int i;
+
+    if (--layoutPtr->refCount > 0) {
+        return;
+    }
+
+    for (i = 0; i < layoutPtr->numVars; i++) {
+        ivlPtr = &layoutPtr->vars[i];
+	if (ivlPtr->commonTracePtr != NULL) {
+	    Tcl_DecrRefCount(ivlPtr->commonTracePtr);
+	}
+	if (ivlPtr->arrayInitPtr != NULL) {
+	    Tcl_DecrRefCount(ivlPtr->arrayInitPtr);
+	}
+    }
+    ckfree((char *)layoutPtr->vars);
+    ckfree((char *)layoutPtr->classes);
+    ckfree((char *)layoutPtr);
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclInvalidateInstanceLayout()
+ *
+ *  Discards the cached instance layout and config table of a class and
+ *  of all classes derived from it.  Invoked whenever variables, components or the
+ *  inheritance of a class change.  The layout is rebuilt on the next
+ *  object creation.
+ * ------------------------------------------------------------------------
+ */
+void
+ItclInvalidateInstanceLayout(
+    ItclClass *iclsPtr)
+{
+    Itcl_ListElem *elem;
+
+    if (iclsPtr->layoutPtr != NULL) {
+	ItclReleaseInstanceLayout(iclsPtr->layoutPtr);
+	iclsPtr->layoutPtr = NULL;
+    }
+    ItclDeleteConfigTable(iclsPtr);
+    elem = Itcl_FirstListElem(&iclsPtr->derived);
+    while (elem) {
+	ItclInvalidateInstanceLayout((ItclClass *)Itcl_GetListValue(elem));
+        elem = Itcl_NextListElem(elem);
+    }
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclGetObjectVar()
+ *
+ *  Returns the Tcl_Var an object uses for the instance variable or
+ *  common ivPtr, or NULL if the object has none.  Variables known when
+ *  the object was created live in the varSlots array, at the position
+ *  the object's layout assigns to the class of ivPtr plus ivPtr->slot.
+ *  Those added later (e.g. by itcl::addcomponent) are kept in the
+ *  extraVariables table.
+ * ------------------------------------------------------------------------
+ */
+Tcl_Var
+ItclGetObjectVar(
+    ItclObject *ioPtr,          /* object being accessed */
+    ItclVariable *ivPtr)        /* variable definition */
+{
+    ItclInstanceLayout *layoutPtr;
+    ItclClassLayout *iclPtr;
+    Tcl_HashEntry *hPtr;
+    int i;
+
+    layoutPtr = ioPtr->layoutPtr;
+    if (layoutPtr != NULL) {
+	for (i = 0; i < layoutPtr->numClasses; i++) {
+	    iclPtr = &layoutPtr->classes[i];
+	    if (iclPtr->iclsPtr == ivPtr->iclsPtr) {
+		if (ivPtr->slot < iclPtr->numSlots) {
+		    return ioPtr->varSlots[iclPtr->firstSlot + ivPtr->slot];
+		}
+		break;
+	    }
+	}
+    }
+    if (ioPtr->extraVariables != NULL) {
+	hPtr = Tcl_FindHashEntry(ioPtr->extraVariables, (char *)ivPtr);
+	if (hPtr != NULL) {
+	    return (Tcl_Var)Tcl_GetHashValue(hPtr);
+	}
+    }
+    return NULL;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclSetObjectVar()
+ *
+ *  Records varPtr as the variable the object uses for ivPtr and puts a
+ *  hold on it, unless the object already has one.  Returns 1 if varPtr
+ *  was recorded and 0 otherwise.
+ * ------------------------------------------------------------------------
+ */
+int
+ItclSetObjectVar(
+    ItclObject *ioPtr,          /* object being initialized */
+    ItclVariable *ivPtr,        /* variable definition */
+    Tcl_Var varPtr)             /* variable for ivPtr */
+{
+    ItclInstanceLayout *layoutPtr;
+    ItclClassLayout *iclPtr;
+    Tcl_HashEntry *hPtr;
+    Tcl_Var *slotPtr;
+    int isNew;
+    int i;
+
+    layoutPtr = ioPtr->layoutPtr;
+    if (layoutPtr != NULL) {
+	for (i = 0; i < layoutPtr->numClasses; i++) {
+	    iclPtr = &layoutPtr->classes[i];
+	    if (iclPtr->iclsPtr == ivPtr->iclsPtr) {
+		if (ivPtr->slot < iclPtr->numSlots) {
+		    slotPtr = &ioPtr->varSlots[iclPtr->firstSlot + ivPtr->slot];
+		    if (*slotPtr != NULL) {
+			return 0;
+		    }
+		    Itcl_PreserveVar(varPtr);
+		    *slotPtr = varPtr;
+		    return 1;
+		}
+		break;
+	    }
+	}
+    }
+    if (ioPtr->extraVariables == NULL) {
+	ioPtr->extraVariables = (Tcl_HashTable *)ItclPoolAlloc(ioPtr->infoPtr,
+	        sizeof(Tcl_HashTable));
+	Tcl_InitHashTable(ioPtr->extraVariables, TCL_ONE_WORD_KEYS);
+    }
+    hPtr = Tcl_CreateHashEntry(ioPtr->extraVariables, (char *)ivPtr, &isNew);
+    if (isNew) {
+	Itcl_PreserveVar(varPtr);
+	Tcl_SetHashValue(hPtr, varPtr);
+    }
+    return isNew;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  GetOptionVar()
+ *
+ *  Returns the element of the object's "itcl_options" array that holds
+ *  the value of option ioptPtr, creating it if create is set.  The
+ *  element is kept in the object's optionSlots and looked up again only
+ *  if it went away, e.g. by an "unset".  Once the array is known, other
+ *  elements are found in it directly.  Sets *slotPtrPtr to NULL for
+ *  options without a slot (options added to a single object or options
+ *  of classes without an "itcl_options" array of the object).
+ * ------------------------------------------------------------------------
+ */
+static Tcl_Var
+GetOptionVar(
+    Tcl_Interp *interp,         /* interpreter managing the object */
+    ItclObject *ioPtr,          /* object being accessed */
+    ItclOption *ioptPtr,        /* option definition */
+    int create,                 /* create the element if missing */
+    Tcl_Var **slotPtrPtr)       /* returns the slot or NULL */
+{
+    ItclInstanceLayout *layoutPtr;
+    ItclClassLayout *iclPtr;
+    Tcl_Obj *arrayNamePtr;
+    Tcl_Var *slotPtr;
+    Tcl_Var varPtr;
+    Tcl_Var arrayVarPtr;
+    int i;
+
+    *slotPtrPtr = NULL;
+    layoutPtr = ioPtr->layoutPtr;
+    if ((layoutPtr == NULL) || (ioptPtr->slot < 0)
+            || !(ioptPtr->iclsPtr->flags &
+	    (ITCL_ECLASS|ITCL_TYPE|ITCL_WIDGET|ITCL_WIDGETADAPTOR))) {
+        return NULL;
+    }
+    slotPtr = NULL;
+    for (i = 0; i < layoutPtr->numClasses; i++) {
+	iclPtr = &layoutPtr->classes[i];
+	if (iclPtr->iclsPtr == ioptPtr->iclsPtr) {
+	    if (ioptPtr->slot < iclPtr->numOptSlots) {
+		if (ioPtr->optionSlots == NULL) {
+		    ioPtr->optionSlots = (Tcl_Var *)ItclPoolAlloc(
+			    ioPtr->infoPtr,
+			    layoutPtr->numOptSlots * sizeof(Tcl_Var));
+		}
+		slotPtr = &ioPtr->optionSlots[iclPtr->firstOptSlot
+			+ ioptPtr->slot];
+	    }
+	    break;
+	}
+    }
+    if (slotPtr == NULL) {
+        return NULL;
+    }
+    *slotPtrPtr = slotPtr;
+    if (*slotPtr != NULL) {
+        if (!Itcl_IsVarDead(*slotPtr)) {
+	    return *slotPtr;
+	}
+	Itcl_ReleaseVar(*slotPtr);
+	*slotPtr = NULL;
+    }
+
+    varPtr = NULL;
+    arrayVarPtr = ioPtr->optionsVar;
+    if (arrayVarPtr != NULL) {
+        varPtr = Itcl_FindArrayElement(arrayVarPtr, ioptPtr->namePtr, create);
+    }
+    if (varPtr == NULL) {
+	arrayNamePtr = Tcl_DuplicateObj(ioPtr->varNsNamePtr);
+	Tcl_AppendToObj(arrayNamePtr, "::itcl_options", -1);
+	Tcl_IncrRefCount(arrayNamePtr);
+	varPtr = Itcl_LookupArrayElement(interp, arrayNamePtr,
+		ioptPtr->namePtr, create, &arrayVarPtr);
+	Tcl_DecrRefCount(arrayNamePtr);
+	if (varPtr == NULL) {
+	    return NULL;
+	}
+    }
+    if (arrayVarPtr != ioPtr->optionsVar) {
+	Itcl_PreserveVar(arrayVarPtr);
+	if (ioPtr->optionsVar != NULL) {
+	    Itcl_ReleaseVar(ioPtr->optionsVar);
+	}
+	ioPtr->optionsVar = arrayVarPtr;
+    }
+    Itcl_PreserveVar(varPtr);
+    *slotPtr = varPtr;
+    return varPtr;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclGetOptionValue()
+ *
+ *  Returns the current value of option ioptPtr of an object, that is
+ *  its element of the "itcl_options" array, or NULL along with an
+ *  error message if it has none.  Read traces on the array fire as
+ *  usual.  The value is owned by the variable.
+ * ------------------------------------------------------------------------
+ */
+Tcl_Obj *
+ItclGetOptionValue(
+    Tcl_Interp *interp,         /* interpreter managing the object */
+    ItclObject *ioPtr,          /* object being accessed */
+    ItclOption *ioptPtr)        /* option definition */
+{
+    Tcl_Var *slotPtr;
+    Tcl_Var varPtr;
+    const char *val;
+
+    varPtr = GetOptionVar(interp, ioPtr, ioptPtr, 0, &slotPtr);
+    if (slotPtr == NULL) {
+	val = ItclGetInstanceVar(interp, "itcl_options",
+		Tcl_GetString(ioptPtr->namePtr), ioPtr, ioptPtr->iclsPtr);
+	if (val == NULL) {
+	    return NULL;
+	}
+	return Tcl_NewStringObj(val, -1);
+    }
+    if (varPtr == NULL) {
+	Tcl_ResetResult(interp);
+	Tcl_AppendResult(interp, "can't read \"itcl_options(",
+		Tcl_GetString(ioptPtr->namePtr), ")\": no such element in array",
+		NULL);
+        return NULL;
+    }
+    return Itcl_GetElementValue(interp, varPtr, ioPtr->optionsVar,
+	    ioPtr->infoPtr->optionsVarNamePtr, ioptPtr->namePtr);
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclSetOptionValue()
+ *
+ *  Stores valuePtr as the value of option ioptPtr of an object.  Write
+ *  traces on the "itcl_options" array fire as usual.  Returns the new
+ *  value, or NULL along with an error message.
+ * ------------------------------------------------------------------------
+ */
+Tcl_Obj *
+ItclSetOptionValue(
+    Tcl_Interp *interp,         /* interpreter managing the object */
+    ItclObject *ioPtr,          /* object being accessed */
+    ItclOption *ioptPtr,        /* option definition */
+    Tcl_Obj *valuePtr)          /* new value */
+{
+    Tcl_Var *slotPtr;
+    Tcl_Var varPtr;
+    const char *val;
+
+    varPtr = GetOptionVar(interp, ioPtr, ioptPtr, 1, &slotPtr);
+    if (slotPtr == NULL) {
+	val = ItclSetInstanceVar(interp, "itcl_options",
+		Tcl_GetString(ioptPtr->namePtr), Tcl_GetString(valuePtr),
+		ioPtr, ioptPtr->iclsPtr);
+	if (val == NULL) {
+	    return NULL;
+	}
+	return valuePtr;
+    }
+    if (varPtr == NULL) {
+	Tcl_ResetResult(interp);
+	Tcl_AppendResult(interp, "can't set \"itcl_options(",
+		Tcl_GetString(ioptPtr->namePtr), ")\": variable isn't array",
+		NULL);
+        return NULL;
+    }
+    return Itcl_SetElementValue(interp, varPtr, ioPtr->optionsVar,
+	    ioPtr->infoPtr->optionsVarNamePtr, ioptPtr->namePtr, valuePtr);
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclObjectTable()
+ *
+ *  Returns one of the per-object tables (objectOptions,
+ *  objectComponents, ...) ready for new entries.  Objects start out
+ *  sharing the empty ItclObjectInfo.emptyObjectTable; the first caller
+ *  that wants to add an entry gets a table of the object's own.
+ *  Lookups can use the table pointer directly.
+ * ------------------------------------------------------------------------
+ */
+Tcl_HashTable *
+ItclObjectTable(
+    ItclObject *ioPtr,              /* object owning the table */
+    Tcl_HashTable **tablePtrPtr)    /* field of ioPtr for the table */
+{
+    if (*tablePtrPtr == &ioPtr->infoPtr->emptyObjectTable) {
+	*tablePtrPtr = (Tcl_HashTable *)ItclPoolAlloc(ioPtr->infoPtr,
+	        sizeof(Tcl_HashTable));
+	Tcl_InitObjHashTable(*tablePtrPtr);
+    }
+    return *tablePtrPtr;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  FreeObjectTable()
+ *
+ *  Deletes a table obtained from ItclObjectTable(), if there is one.
+ * ------------------------------------------------------------------------
+ */
+static void
+FreeObjectTable(
+    ItclObject *ioPtr,              /* object owning the table */
+    Tcl_HashTable *tablePtr)        /* table to be deleted */
+{
+    if (tablePtr != &ioPtr->infoPtr->emptyObjectTable) {
+	Tcl_DeleteHashTable(tablePtr);
+	ItclPoolFree(ioPtr->infoPtr, tablePtr, sizeof(Tcl_HashTable));
+    }
+}
+
 /*
  * ------------------------------------------------------------------------
  *  ItclInitObjectVariables()
  *
  *  Init all instance variables and create the necessary variable namespaces
  *  for the given object instance.  This is usually invoked automatically
- *  by Itcl_CreateObject(), when an object is created.
+ *  by Itcl_CreateObject(), when an object is created.  The work is driven
+ *  by the instance layout of the class, which is built on first use.
  * ------------------------------------------------------------------------
  */
 static int
@@ -760,40 +1328,51 @@ ItclInitObjectVariables(
    ItclClass *iclsPtr)
 {
     Tcl_DString buffer;
-    Tcl_DString buffer2;
-    Tcl_HashEntry *hPtr;
     Tcl_HashEntry *hPtr2;
-    Tcl_HashSearch place;
     Tcl_Namespace *varNsPtr;
-    Tcl_Namespace *varNsPtr2;
     Tcl_CallFrame frame;
     Tcl_Var varPtr;
-    ItclClass *iclsPtr2;
-    ItclHierIter hier;
+    ItclInstanceLayout *layoutPtr;
+    ItclClassLayout *iclPtr;
+    ItclVarLayout *ivlPtr;
     ItclVariable *ivPtr;
     ItclComponent *icPtr;
     const char *varName;
     const char *inheritComponentName;
-    int itclOptionsIsSet;
+    int prefixLen;
     int isNew;
+    int i;
+    int j;
+
+    Tcl_ResetResult(interp);
+    layoutPtr = iclsPtr->layoutPtr;
+    if (layoutPtr == NULL) {
+        layoutPtr = ItclBuildInstanceLayout(interp, iclsPtr);
+	if (layoutPtr == NULL) {
+	    goto errorCleanup2;
+	}
+	iclsPtr->layoutPtr = layoutPtr;
+    }
+    layoutPtr->refCount++;
+    ioPtr->layoutPtr = layoutPtr;
+    if (layoutPtr->numSlots > 0) {
+        ioPtr->varSlots = (Tcl_Var *)ItclPoolAlloc(ioPtr->infoPtr,
+	        layoutPtr->numSlots * sizeof(Tcl_Var));
+    }
 
-    ivPtr = NULL;
     /*
      * create all the variables for each class in the
      * ::itcl::variables::<object namespace>::<class> namespace as an
      * undefined variable using the Tcl "variable xx" command
      */
-    itclOptionsIsSet = 0;
     inheritComponentName = NULL;
-    Itcl_InitHierIter(&hier, iclsPtr);
-    iclsPtr2 = Itcl_AdvanceHierIter(&hier);
-    Tcl_ResetResult(interp);
-    while (iclsPtr2 != NULL) {
-	Tcl_DStringInit(&buffer);
-	Tcl_DStringAppend(&buffer, ITCL_VARIABLES_NAMESPACE, -1);
-	Tcl_DStringAppend(&buffer,
-		(Tcl_GetObjectNamespace(ioPtr->oPtr))->fullName, -1);
-	Tcl_DStringAppend(&buffer, iclsPtr2->nsPtr->fullName, -1);
+    Tcl_DStringInit(&buffer);
+    Tcl_DStringAppend(&buffer, Tcl_GetString(ioPtr->varNsNamePtr), -1);
+    prefixLen = Tcl_DStringLength(&buffer);
+    for (i = 0; i < layoutPtr->numClasses; i++) {
+	iclPtr = &layoutPtr->classes[i];
+	Tcl_DStringSetLength(&buffer, prefixLen);
+	Tcl_DStringAppend(&buffer, iclPtr->iclsPtr->nsPtr->fullName, -1);
 	varNsPtr = Tcl_FindNamespace(interp, Tcl_DStringValue(&buffer),
 	        NULL, 0);
 	if (varNsPtr == NULL) {
@@ -803,54 +1382,19 @@ ItclInitObjectVariables(
 	/* now initialize the variables which have an init value */
         if (Itcl_PushCallFrame(interp, &frame, varNsPtr,
                 /*isProcCallFrame*/0) != TCL_OK) {
+	    Tcl_DStringFree(&buffer);
 	    goto errorCleanup2;
         }
-        hPtr = Tcl_FirstHashEntry(&iclsPtr2->variables, &place);
-        while (hPtr) {
-            ivPtr = (ItclVariable*)Tcl_GetHashValue(hPtr);
+	for (j = 0; j < iclPtr->numVars; j++) {
+	    ivlPtr = &layoutPtr->vars[iclPtr->firstVar + j];
+            ivPtr = ivlPtr->ivPtr;
 	    varName = Tcl_GetString(ivPtr->namePtr);
-            if ((ivPtr->flags & ITCL_OPTIONS_VAR) && !itclOptionsIsSet) {
-                /* this is the special code for the "itcl_options" variable */
-		itclOptionsIsSet = 1;
-                Tcl_DStringInit(&buffer2);
-	        Tcl_DStringAppend(&buffer2, ITCL_VARIABLES_NAMESPACE, -1);
-		Tcl_DStringAppend(&buffer,
-			(Tcl_GetObjectNamespace(ioPtr->oPtr))->fullName, -1);
-	        varNsPtr2 = Tcl_FindNamespace(interp,
-		        Tcl_DStringValue(&buffer2), NULL, 0);
-	        if (varNsPtr2 == NULL) {
-	            varNsPtr2 = Tcl_CreateNamespace(interp,
-		            Tcl_DStringValue(&buffer2), NULL, 0);
-	        }
-                Tcl_DStringFree(&buffer2);
-	        Itcl_PopCallFrame(interp);
-	        /* now initialize the variables which have an init value */
-                if (Itcl_PushCallFrame(interp, &frame, varNsPtr2,
-                        /*isProcCallFrame*/0) != TCL_OK) {
-		    goto errorCleanup2;
-                }
-                Tcl_TraceVar2(interp, "itcl_options",
-                        NULL,
-                        TCL_TRACE_READS|TCL_TRACE_WRITES,
-                        ItclTraceOptionVar, ioPtr);
-	        Itcl_PopCallFrame(interp);
-                if (Itcl_PushCallFrame(interp, &frame, varNsPtr,
-                        /*isProcCallFrame*/0) != TCL_OK) {
-		    goto errorCleanup2;
-                }
-                hPtr = Tcl_NextHashEntry(&place);
+            if (ivlPtr->flags & ITCL_LAYOUT_OPTIONS) {
+	        /* the array is filled by ItclInitObjectOptions() */
 	        continue;
             }
-            if (ivPtr->flags & ITCL_COMPONENT_VAR) {
-		hPtr2 = Tcl_FindHashEntry(&ivPtr->iclsPtr->components,
-		        (char *)ivPtr->namePtr);
-		if (hPtr2 == NULL) {
-		    Tcl_AppendResult(interp, "cannot find component \"",
-		            Tcl_GetString(ivPtr->namePtr), "\" in class \"",
-			    Tcl_GetString(ivPtr->iclsPtr->namePtr), NULL);
-		    goto errorCleanup;
-		}
-		icPtr = (ItclComponent *)Tcl_GetHashValue(hPtr2);
+            if (ivlPtr->icPtr != NULL) {
+		icPtr = ivlPtr->icPtr;
 		if (icPtr->flags & ITCL_COMPONENT_INHERIT) {
 		    if (inheritComponentName != NULL) {
 		        Tcl_AppendResult(interp, "object \"",
@@ -866,7 +1410,8 @@ ItclInitObjectVariables(
 		        inheritComponentName = Tcl_GetString(icPtr->namePtr);
 		    }
 		}
-                hPtr2 = Tcl_CreateHashEntry(&ioPtr->objectComponents,
+                hPtr2 = Tcl_CreateHashEntry(
+		        ItclObjectTable(ioPtr, &ioPtr->objectComponents),
                         (char *)ivPtr->namePtr, &isNew);
 		if (isNew) {
 		    Tcl_SetHashValue(hPtr2, icPtr);
@@ -881,167 +1426,82 @@ ItclInitObjectVariables(
 		    goto errorCleanup;
                 }
 	    }
-            hPtr2 = ItclResolveVarEntry(ivPtr->iclsPtr, varName);
-            if (hPtr2 == NULL) {
-                hPtr = Tcl_NextHashEntry(&place);
+            if (!(ivlPtr->flags & ITCL_LAYOUT_RESOLVED)) {
 	        continue;
             }
 	    if ((ivPtr->flags & ITCL_COMMON) == 0) {
-                varPtr = Tcl_NewNamespaceVar(interp, varNsPtr,
-                        Tcl_GetString(ivPtr->namePtr));
-	        hPtr2 = Tcl_CreateHashEntry(&ioPtr->objectVariables,
-		        (char *)ivPtr, &isNew);
-	        if (isNew) {
-		    Itcl_PreserveVar(varPtr);
-		    Tcl_SetHashValue(hPtr2, varPtr);
-		}
-	        if (ivPtr->flags & (ITCL_THIS_VAR|ITCL_TYPE_VAR|
-		        ITCL_SELF_VAR|ITCL_SELFNS_VAR|ITCL_WIN_VAR)) {
-                    int isDone = 0;
-		    if (Tcl_SetVar2(interp, varName, NULL,
-		        "", TCL_NAMESPACE_ONLY) == NULL) {
+                varPtr = Tcl_NewNamespaceVar(interp, varNsPtr, varName);
+	        ItclSetObjectVar(ioPtr, ivPtr, varPtr);
+	        if (ivlPtr->flags & ITCL_LAYOUT_BUILTIN) {
+		    Tcl_Obj *valuePtr;
+
+		    valuePtr = BuiltinVarValue(ioPtr, ivPtr->flags,
+		            ivPtr->iclsPtr->nsPtr);
+		    if ((valuePtr == NULL) || (Tcl_SetVar2Ex(interp, varName,
+		            NULL, valuePtr, TCL_NAMESPACE_ONLY) == NULL)) {
                         Tcl_AppendResult(interp, "INTERNAL ERROR cannot set",
 			        " variable \"", varNsPtr->fullName, "::",
 				varName, "\"\n", NULL);
 		        goto errorCleanup;
 	            }
-	        if (ivPtr->flags & ITCL_THIS_VAR) {
 	            Tcl_TraceVar2(interp, varName, NULL,
-		        TCL_TRACE_READS|TCL_TRACE_WRITES, ItclTraceThisVar,
-		        ioPtr);
-                    isDone = 1;
+		            (ivlPtr->flags & ITCL_LAYOUT_LIVE) ?
+			    TCL_TRACE_READS|TCL_TRACE_WRITES : TCL_TRACE_WRITES,
+			    ivlPtr->traceProc, ioPtr);
+		    continue;
 		}
-	        if (!isDone && ivPtr->flags & ITCL_TYPE_VAR) {
+		if (ivlPtr->traceProc != NULL) {
 	            Tcl_TraceVar2(interp, varName, NULL,
-		        TCL_TRACE_READS|TCL_TRACE_WRITES, ItclTraceTypeVar,
-		        ioPtr);
-                    isDone = 1;
+		            TCL_TRACE_READS|TCL_TRACE_WRITES, ivlPtr->traceProc,
+		            ioPtr);
+		    continue;
 		}
-	        if (!isDone && ivPtr->flags & ITCL_SELF_VAR) {
-	            Tcl_TraceVar2(interp, varName, NULL,
-		        TCL_TRACE_READS|TCL_TRACE_WRITES, ItclTraceSelfVar,
-		        ioPtr);
-                    isDone = 1;
+	        if (ivPtr->init != NULL) {
+		    if (Tcl_SetVar2(interp, varName, NULL,
+		            Tcl_GetString(ivPtr->init),
+			    TCL_NAMESPACE_ONLY) == NULL) {
+		        goto errorCleanup;
+	            }
+	        }
+	        if (ivlPtr->arrayInitPtr != NULL) {
+		    Tcl_Obj **objv;
+		    int objc;
+		    int k;
+
+		    Tcl_ListObjGetElements(NULL, ivlPtr->arrayInitPtr,
+		            &objc, &objv);
+		    for (k = 0; k + 1 < objc; k += 2) {
+                        if (Tcl_ObjSetVar2(interp, ivPtr->namePtr, objv[k],
+			        objv[k + 1], TCL_NAMESPACE_ONLY) == NULL) {
+                            Tcl_AppendStringsToObj(Tcl_GetObjResult(interp),
+                                "cannot initialize variable \"",
+                                varName, "\"", NULL);
+                            goto errorCleanup;
+                        }
+                    }
 		}
-	        if (!isDone && ivPtr->flags & ITCL_SELFNS_VAR) {
+	    } else {
+		if (ivlPtr->traceProc != NULL) {
 	            Tcl_TraceVar2(interp, varName, NULL,
-		        TCL_TRACE_READS|TCL_TRACE_WRITES, ItclTraceSelfnsVar,
-		        ioPtr);
-                    isDone = 1;
+		            TCL_TRACE_READS|TCL_TRACE_WRITES, ivlPtr->traceProc,
+		            ioPtr);
 		}
-	        if (!isDone && ivPtr->flags & ITCL_WIN_VAR) {
-	            Tcl_TraceVar2(interp, varName, NULL,
-		        TCL_TRACE_READS|TCL_TRACE_WRITES, ItclTraceWinVar,
-		        ioPtr);
-                    isDone = 1;
+	        ItclSetObjectVar(ioPtr, ivPtr, ivlPtr->commonVarPtr);
+		if (ivlPtr->commonTracePtr != NULL) {
+                    Tcl_TraceVar2(interp,
+                            Tcl_GetString(ivlPtr->commonTracePtr), NULL,
+	                    TCL_TRACE_WRITES, ivlPtr->commonTraceProc,
+	                    ioPtr);
 		}
-		} else {
-	            if (ivPtr->flags & ITCL_HULL_VAR) {
-	                Tcl_TraceVar2(interp, varName, NULL,
-		            TCL_TRACE_READS|TCL_TRACE_WRITES,
-			    ItclTraceItclHullVar,
-		            ioPtr);
-		    } else {
-	              if (ivPtr->init != NULL) {
-			if (Tcl_SetVar2(interp,
-			        Tcl_GetString(ivPtr->namePtr), NULL,
-			        Tcl_GetString(ivPtr->init),
-				TCL_NAMESPACE_ONLY) == NULL) {
-			    goto errorCleanup;
-	                }
-	              }
-	              if (ivPtr->arrayInitPtr != NULL) {
-			Tcl_DString buffer3;
-	                int i;
-	                int argc;
-	                const char **argv;
-	                const char *val;
-
-			Tcl_DStringInit(&buffer3);
-                        Tcl_DStringAppend(&buffer3, varNsPtr->fullName, -1);
-                        Tcl_DStringAppend(&buffer3, "::", -1);
-                        Tcl_DStringAppend(&buffer3,
-			        Tcl_GetString(ivPtr->namePtr), -1);
-	                Tcl_SplitList(interp,
-			        Tcl_GetString(ivPtr->arrayInitPtr),
-	                        &argc, &argv);
-	                for (i = 0; i < argc; i++) {
-                            val = Tcl_SetVar2(interp,
-			            Tcl_DStringValue(&buffer3), argv[i],
-                                    argv[i + 1], TCL_NAMESPACE_ONLY);
-                            if (!val) {
-                                Tcl_AppendStringsToObj(Tcl_GetObjResult(interp),
-                                    "cannot initialize variable \"",
-                                    Tcl_GetString(ivPtr->namePtr), "\"",
-                                    NULL);
-                                return TCL_ERROR;
-                            }
-	                    i++;
-                        }
-			Tcl_DStringFree(&buffer3);
-		        ckfree((char *)argv);
-		        }
-		      }
-		    }
-	        } else {
-	            if (ivPtr->flags & ITCL_HULL_VAR) {
-	                Tcl_TraceVar2(interp, varName, NULL,
-		            TCL_TRACE_READS|TCL_TRACE_WRITES,
-			    ItclTraceItclHullVar,
-		            ioPtr);
-		    }
-	            hPtr2 = Tcl_FindHashEntry(&iclsPtr2->classCommons,
-		            (char *)ivPtr);
-		    if (hPtr2 == NULL) {
-		        goto errorCleanup;
-		    }
-		    varPtr = (Tcl_Var)Tcl_GetHashValue(hPtr2);
-	            hPtr2 = Tcl_CreateHashEntry(&ioPtr->objectVariables,
-		            (char *)ivPtr, &isNew);
-	            if (isNew) {
-			Itcl_PreserveVar(varPtr);
-		        Tcl_SetHashValue(hPtr2, varPtr);
-	        }
-	        if (ivPtr->flags & ITCL_COMPONENT_VAR) {
-	            if (ivPtr->flags & ITCL_COMMON) {
-                        Tcl_Obj *objPtr2;
-		        objPtr2 = Tcl_NewStringObj(ITCL_VARIABLES_NAMESPACE,
-			        -1);
-			Tcl_AppendToObj(objPtr2, (Tcl_GetObjectNamespace(
-				ivPtr->iclsPtr->oPtr))->fullName, -1);
-                        Tcl_AppendToObj(objPtr2, "::", -1);
-                        Tcl_AppendToObj(objPtr2, varName, -1);
-			/* itcl_hull is traced in itclParse.c */
-			if (strcmp(varName, "itcl_hull") == 0) {
-                            Tcl_TraceVar2(interp,
-                                    Tcl_GetString(objPtr2), NULL,
-	                            TCL_TRACE_WRITES, ItclTraceItclHullVar,
-	                            ioPtr);
-			} else {
-                            Tcl_TraceVar2(interp,
-                                    Tcl_GetString(objPtr2), NULL,
-	                            TCL_TRACE_WRITES, ItclTraceComponentVar,
-	                            ioPtr);
-		        }
-		        Tcl_DecrRefCount(objPtr2);
-		    } else {
-                        Tcl_TraceVar2(interp,
-		                varName, NULL,
-	                        TCL_TRACE_WRITES, ItclTraceComponentVar,
-	                        ioPtr);
-	            }
-	        }
 	    }
-            hPtr = Tcl_NextHashEntry(&place);
         }
 	Itcl_PopCallFrame(interp);
-        iclsPtr2 = Itcl_AdvanceHierIter(&hier);
     }
     Tcl_DStringFree(&buffer);
-    Itcl_DeleteHierIter(&hier);
     return TCL_OK;
 errorCleanup:
     Itcl_PopCallFrame(interp);
+    Tcl_DStringFree(&buffer);
 errorCleanup2:
     varNsPtr = Tcl_FindNamespace(interp, Tcl_GetString(ioPtr->varNsNamePtr),
             NULL, 0);
@@ -1050,7 +1510,7 @@ errorCleanup2:
     }
     return TCL_ERROR;
 }
-
+
 /*
  * ------------------------------------------------------------------------
  *  ItclInitObjectOptions()
@@ -1071,11 +1531,9 @@ ItclInitObjectOptions(
    ItclObject *ioPtr,
    ItclClass *iclsPtr)
 {
-    Tcl_DString buffer;
     Tcl_HashEntry *hPtr;
     Tcl_HashEntry *hPtr2;
     Tcl_HashSearch place;
-    Tcl_CallFrame frame;
     Tcl_Namespace *varNsPtr;
     ItclClass *iclsPtr2;
     ItclHierIter hier;
@@ -1083,7 +1541,7 @@ ItclInitObjectOptions(
     ItclDelegatedOption *idoPtr;
     int isNew;
 
-    ioptPtr = NULL;
+    varNsPtr = NULL;
     Itcl_InitHierIter(&hier, iclsPtr);
     iclsPtr2 = Itcl_AdvanceHierIter(&hier);
     while (iclsPtr2 != NULL) {
@@ -1091,41 +1549,28 @@ ItclInitObjectOptions(
         hPtr = Tcl_FirstHashEntry(&iclsPtr2->options, &place);
         while (hPtr) {
             ioptPtr = (ItclOption*)Tcl_GetHashValue(hPtr);
-	    hPtr2 = Tcl_CreateHashEntry(&ioPtr->objectOptions,
+	    hPtr2 = Tcl_CreateHashEntry(
+		    ItclObjectTable(ioPtr, &ioPtr->objectOptions),
 	            (char *)ioptPtr->namePtr, &isNew);
 	    if (isNew) {
 		Tcl_SetHashValue(hPtr2, ioptPtr);
-                Tcl_DStringInit(&buffer);
-	        Tcl_DStringAppend(&buffer, ITCL_VARIABLES_NAMESPACE, -1);
-		Tcl_DStringAppend(&buffer,
-			(Tcl_GetObjectNamespace(ioPtr->oPtr)->fullName), -1);
-	        varNsPtr = Tcl_FindNamespace(interp,
-		        Tcl_DStringValue(&buffer), NULL, 0);
-	        if (varNsPtr == NULL) {
-	            varNsPtr = Tcl_CreateNamespace(interp,
-		            Tcl_DStringValue(&buffer), NULL, 0);
+		if (varNsPtr == NULL) {
+		    varNsPtr = Tcl_FindNamespace(interp,
+			    Tcl_GetString(ioPtr->varNsNamePtr), NULL, 0);
+		    if (varNsPtr == NULL) {
+			varNsPtr = Tcl_CreateNamespace(interp,
+				Tcl_GetString(ioPtr->varNsNamePtr), NULL, 0);
+		    }
 		}
-                Tcl_DStringFree(&buffer);
 	        /* now initialize the options which have an init value */
-                if (Itcl_PushCallFrame(interp, &frame, varNsPtr,
-                        /*isProcCallFrame*/0) != TCL_OK) {
-                    return TCL_ERROR;
-                }
-		if ((ioptPtr != NULL) && (ioptPtr->namePtr != NULL) &&
+		if ((ioptPtr->namePtr != NULL) &&
 		        (ioptPtr->defaultValuePtr != NULL)) {
-                    if (Tcl_SetVar2(interp, "itcl_options",
-		            Tcl_GetString(ioptPtr->namePtr),
-	                    Tcl_GetString(ioptPtr->defaultValuePtr),
-			    TCL_NAMESPACE_ONLY) == NULL) {
-	                Itcl_PopCallFrame(interp);
+		    if (ItclSetOptionValue(interp, ioPtr, ioptPtr,
+			    ioptPtr->defaultValuePtr) == NULL) {
+			Itcl_DeleteHierIter(&hier);
 		        return TCL_ERROR;
                     }
-                    Tcl_TraceVar2(interp, "itcl_options",
-                            NULL,
-                            TCL_TRACE_READS|TCL_TRACE_WRITES,
-                            ItclTraceOptionVar, ioPtr);
 		}
-	        Itcl_PopCallFrame(interp);
             }
             hPtr = Tcl_NextHashEntry(&place);
         }
@@ -1133,7 +1578,8 @@ ItclInitObjectOptions(
         hPtr = Tcl_FirstHashEntry(&iclsPtr2->delegatedOptions, &place);
         while (hPtr) {
             idoPtr = (ItclDelegatedOption*)Tcl_GetHashValue(hPtr);
-	    hPtr2 = Tcl_CreateHashEntry(&ioPtr->objectDelegatedOptions,
+	    hPtr2 = Tcl_CreateHashEntry(
+		    ItclObjectTable(ioPtr, &ioPtr->objectDelegatedOptions),
 	            (char *)idoPtr->namePtr, &isNew);
 	    if (isNew) {
 		Tcl_SetHashValue(hPtr2, idoPtr);
@@ -1180,7 +1626,8 @@ ItclInitObjectMethodVariables(
         hPtr = Tcl_FirstHashEntry(&iclsPtr2->methodVariables, &place);
         while (hPtr) {
             imvPtr = (ItclMethodVariable*)Tcl_GetHashValue(hPtr);
-	    hPtr2 = Tcl_CreateHashEntry(&ioPtr->objectMethodVariables,
+	    hPtr2 = Tcl_CreateHashEntry(
+		    ItclObjectTable(ioPtr, &ioPtr->objectMethodVariables),
 	            (char *)imvPtr->namePtr, &isNew);
 	    if (isNew) {
 		Tcl_SetHashValue(hPtr2, imvPtr);
@@ -1255,12 +1702,32 @@ Itcl_DeleteObject(
     }
     contextIoPtr->oPtr = NULL;
     contextIoPtr->accessCmd = NULL;
+    RefreshBuiltinVars(interp, contextIoPtr,
+            ITCL_THIS_VAR|ITCL_SELF_VAR);
 
     Itcl_ReleaseData(contextIoPtr);
 
     return TCL_OK;
 }
 
+/*
+ * ------------------------------------------------------------------------
+ *  ItclIsLiveObject()
+ *
+ *  Objects stay on the instance list of their class until they are
+ *  freed, which may be well after they were deleted.  Returns 1 if
+ *  the object is still registered as a known object, and 0 if it is
+ *  already deleted.
+ * ------------------------------------------------------------------------
+ */
+int
+ItclIsLiveObject(
+    ItclObject *ioPtr)
+{
+    return (Tcl_FindHashEntry(&ioPtr->infoPtr->objects, (char *)ioPtr)
+            != NULL);
+}
+
 /*
  * ------------------------------------------------------------------------
  *  ItclDeleteObjectVariablesNamespace()
@@ -1300,7 +1767,8 @@ FinalizeDeleteObject(
     }
 
     Tcl_DeleteHashTable(contextIoPtr->destructed);
-    ckfree((char*)contextIoPtr->destructed);
+    ItclPoolFree(contextIoPtr->infoPtr, contextIoPtr->destructed,
+            sizeof(Tcl_HashTable));
     contextIoPtr->destructed = NULL;
     return result;
 }
@@ -1382,7 +1850,8 @@ Itcl_DestructObject(
          *  sure that all base class destructors have been called,
          *  explicitly or implicitly.
          */
-        contextIoPtr->destructed = (Tcl_HashTable*)ckalloc(sizeof(Tcl_HashTable));
+        contextIoPtr->destructed = (Tcl_HashTable*)ItclPoolAlloc(
+                contextIoPtr->infoPtr, sizeof(Tcl_HashTable));
         Tcl_InitObjHashTable(contextIoPtr->destructed);
 
         /*
@@ -1575,13 +2044,10 @@ Itcl_ObjectIsa(
     ItclObject *contextIoPtr, /* object being tested */
     ItclClass *iclsPtr)       /* class to test for "is-a" relationship */
 {
-    Tcl_HashEntry *entry;
-
     if (contextIoPtr == NULL) {
         return 0;
     }
-    entry = Tcl_FindHashEntry(&contextIoPtr->iclsPtr->heritage, (char*)iclsPtr);
-    return (entry != NULL);
+    return ItclClassIsa(contextIoPtr->iclsPtr, iclsPtr);
 }
 
 /*
@@ -1613,6 +2079,7 @@ ItclGetInstanceVar(
     ItclClass *iclsPtr;
     ItclVariable *ivPtr;
     ItclVarLookup *vlookup;
+    Tcl_Var varPtr;
     const char *val;
     int isItclOptions;
     int doAppend;
@@ -1644,10 +2111,9 @@ ItclGetInstanceVar(
      *  Install the object context and access the data member
      *  like any other variable.
      */
-    hPtr = Tcl_FindHashEntry(&contextIoPtr->objectVariables, (char *)ivPtr);
-    if (hPtr) {
+    varPtr = ItclGetObjectVar(contextIoPtr, ivPtr);
+    if (varPtr) {
 	Tcl_Obj *varName = Tcl_NewObj();
-	Tcl_Var varPtr = (Tcl_Var)Tcl_GetHashValue(hPtr);
 	Tcl_GetVariableFullName(interp, varPtr, varName);
 
 	val = Tcl_GetVar2(interp, Tcl_GetString(varName), name2,
@@ -1829,6 +2295,7 @@ ItclSetInstanceVar(
     Tcl_DString buffer;
     ItclVariable *ivPtr;
     ItclVarLookup *vlookup;
+    Tcl_Var varPtr;
     ItclClass *iclsPtr;
     const char *val;
     int isItclOptions;
@@ -1864,10 +2331,9 @@ ItclSetInstanceVar(
      *  like any other variable.
      */
 
-    hPtr = Tcl_FindHashEntry(&contextIoPtr->objectVariables, (char *)ivPtr);
-    if (hPtr) {
+    varPtr = ItclGetObjectVar(contextIoPtr, ivPtr);
+    if (varPtr) {
 	Tcl_Obj *varName = Tcl_NewObj();
-	Tcl_Var varPtr = (Tcl_Var)Tcl_GetHashValue(hPtr);
 	Tcl_GetVariableFullName(interp, varPtr, varName);
 
 	val = Tcl_SetVar2(interp, Tcl_GetString(varName), name2, value,
@@ -2047,37 +2513,210 @@ ItclReportObjectUsage(
                 Itcl_AppendList(&cmdList, imPtr);
             }
         }
-        entry = Tcl_NextHashEntry(&place);
+        entry = Tcl_NextHashEntry(&place);
+    }
+
+    /*
+     *  Add a series of statements showing usage info.
+     */
+    resultPtr = Tcl_GetObjResult(interp);
+    elem = Itcl_FirstListElem(&cmdList);
+    while (elem) {
+        imPtr = (ItclMemberFunc*)Itcl_GetListValue(elem);
+        Tcl_AppendToObj(resultPtr, "\n  ", -1);
+        Itcl_GetMemberFuncUsage(imPtr, contextIoPtr, resultPtr);
+
+        elem = Itcl_NextListElem(elem);
+    }
+    Itcl_DeleteList(&cmdList);
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  BuiltinVarValue()
+ *
+ *  Computes the value of one of the built-in "this", "type", "self",
+ *  "selfns" and "win" variables of an object.  varFlags holds the
+ *  ITCL_*_VAR flag of the variable, nsPtr is the namespace reported by
+ *  "type".  Returns a new object with a zero reference count, or NULL
+ *  if the value cannot be determined.
+ * ------------------------------------------------------------------------
+ */
+static Tcl_Obj *
+BuiltinVarValue(
+    ItclObject *ioPtr,          /* object owning the variable */
+    int varFlags,               /* ITCL_THIS_VAR, ITCL_TYPE_VAR, ... */
+    Tcl_Namespace *nsPtr)       /* namespace for "type" */
+{
+    Tcl_DString buffer;
+    Tcl_Obj *objPtr;
+    const char *head;
+    const char *tail;
+
+    objPtr = Tcl_NewObj();
+    if (varFlags & ITCL_THIS_VAR) {
+        if (ioPtr->accessCmd) {
+            Tcl_GetCommandFullName(ioPtr->iclsPtr->interp,
+                ioPtr->accessCmd, objPtr);
+        }
+    } else if (varFlags & ITCL_TYPE_VAR) {
+        Tcl_SetStringObj(objPtr, nsPtr->fullName, -1);
+    } else if (varFlags & ITCL_SELF_VAR) {
+        if (ioPtr->iclsPtr->flags & (ITCL_WIDGET|ITCL_WIDGETADAPTOR)) {
+            const char *objectName;
+
+            objectName = ItclGetInstanceVar(ioPtr->iclsPtr->interp,
+                    "itcl_hull", NULL, ioPtr, ioPtr->iclsPtr);
+            if (objectName == NULL || strlen(objectName) == 0) {
+                Tcl_SetStringObj(objPtr, Tcl_GetString(ioPtr->namePtr), -1);
+            } else {
+                Tcl_SetStringObj(objPtr, objectName, -1);
+            }
+        } else if (ioPtr->accessCmd) {
+            Tcl_GetCommandFullName(ioPtr->iclsPtr->interp,
+                    ioPtr->accessCmd, objPtr);
+        }
+    } else if (varFlags & ITCL_SELFNS_VAR) {
+        Tcl_SetStringObj(objPtr, Tcl_GetString(ioPtr->varNsNamePtr), -1);
+        Tcl_AppendToObj(objPtr,
+                Tcl_GetString(ioPtr->iclsPtr->fullNamePtr), -1);
+    } else if (varFlags & ITCL_WIN_VAR) {
+        /* a window path name must not contain namespace parts !! */
+        Itcl_ParseNamespPath(Tcl_GetString(ioPtr->origNamePtr), &buffer,
+                &head, &tail);
+        if (tail == NULL) {
+            Tcl_DStringFree(&buffer);
+            Tcl_DecrRefCount(objPtr);
+            return NULL;
+        }
+        Tcl_SetStringObj(objPtr, tail, -1);
+        Tcl_DStringFree(&buffer);
+    }
+    return objPtr;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  TraceBuiltinVar()
+ *
+ *  Common part of the traces on the built-in variables.  The variables
+ *  hold their value, set when the object is created and refreshed by
+ *  ObjectRenamedTrace(), so they normally only carry a write trace.
+ *  The value of "self" in widgets follows "itcl_hull" and is still
+ *  computed on each read.
+ *
+ *  On read, this procedure stores the current value in the variable.
+ *
+ *  On write, this procedure puts the proper value back and returns
+ *  errMsg.  Every write is rejected, also one that does not change
+ *  the value.  "type" names the class that declares the variable,
+ *  which the trace cannot tell from the variable name, so it is put
+ *  back by RefreshBuiltinVars() like when the variables are set up.
+ * ------------------------------------------------------------------------
+ */
+static char *
+TraceBuiltinVar(
+    ItclObject *ioPtr,          /* object owning the variable */
+    Tcl_Interp *interp,         /* interpreter managing this variable */
+    const char *name1,          /* variable name */
+    int flags,                  /* flags indicating read/write */
+    int varFlags,               /* ITCL_THIS_VAR, ITCL_TYPE_VAR, ... */
+    const char *errMsg)         /* result for a rejected write */
+{
+    Tcl_Obj *valuePtr;
+
+    if ((flags & TCL_TRACE_WRITES) == 0) {
+        errMsg = NULL;
+    }
+    if (varFlags & ITCL_TYPE_VAR) {
+        RefreshBuiltinVars(interp, ioPtr, ITCL_TYPE_VAR);
+        return (char *)errMsg;
+    }
+    valuePtr = BuiltinVarValue(ioPtr, varFlags, NULL);
+    if (valuePtr == NULL) {
+        return (char *)" INTERNAL ERROR cannot compute built-in variable";
+    }
+    Tcl_IncrRefCount(valuePtr);
+    Tcl_SetVar2Ex(interp, name1, NULL, valuePtr, 0);
+    Tcl_DecrRefCount(valuePtr);
+    return (char *)errMsg;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  RefreshBuiltinVars()
+ *
+ *  Stores the current value in the stored built-in variables selected
+ *  by varFlags, in all class scopes of the object.  Invoked with
+ *  ITCL_THIS_VAR|ITCL_SELF_VAR once the access command of a new object
+ *  is in place, whenever it is renamed and when it goes away.
+ *
+ *  The variables are written directly: their own write traces would
+ *  only reject the update, and traces added by scripts do not fire
+ *  either, just as they did not when the values were computed on read.
+ * ------------------------------------------------------------------------
+ */
+static void
+RefreshBuiltinVars(
+    Tcl_Interp *interp,         /* interpreter managing the object */
+    ItclObject *ioPtr,          /* object that got a (new) name */
+    int varFlags)               /* ITCL_THIS_VAR, ITCL_TYPE_VAR, ... */
+{
+    ItclInstanceLayout *layoutPtr;
+    ItclVarLayout *ivlPtr;
+    ItclVariable *ivPtr;
+    Tcl_Obj *thisPtr;
+    Tcl_Obj *valuePtr;
+    Tcl_Var varPtr;
+    int i;
+    (void)interp;
+
+    layoutPtr = ioPtr->layoutPtr;
+    if (layoutPtr == NULL) {
+        return;
+    }
+    thisPtr = NULL;
+    for (i = 0; i < layoutPtr->numVars; i++) {
+        ivlPtr = &layoutPtr->vars[i];
+        ivPtr = ivlPtr->ivPtr;
+        if (!(ivlPtr->flags & ITCL_LAYOUT_BUILTIN)
+                || (ivlPtr->flags & ITCL_LAYOUT_LIVE)
+                || !(ivPtr->flags & varFlags)) {
+            continue;
+        }
+        varPtr = ItclGetObjectVar(ioPtr, ivPtr);
+        if (varPtr == NULL) {
+            continue;
+        }
+        if (ivPtr->flags & (ITCL_THIS_VAR|ITCL_SELF_VAR)) {
+            if (thisPtr == NULL) {
+                /* "this" and "self" outside of widgets share the value */
+                thisPtr = BuiltinVarValue(ioPtr, ITCL_THIS_VAR, NULL);
+                Tcl_IncrRefCount(thisPtr);
+            }
+            Itcl_SetScalarVar(varPtr, thisPtr);
+            continue;
+        }
+        valuePtr = BuiltinVarValue(ioPtr, ivPtr->flags,
+                ivPtr->iclsPtr->nsPtr);
+        if (valuePtr != NULL) {
+            Tcl_IncrRefCount(valuePtr);
+            Itcl_SetScalarVar(varPtr, valuePtr);
+            Tcl_DecrRefCount(valuePtr);
+        }
     }
-
-    /*
-     *  Add a series of statements showing usage info.
-     */
-    resultPtr = Tcl_GetObjResult(interp);
-    elem = Itcl_FirstListElem(&cmdList);
-    while (elem) {
-        imPtr = (ItclMemberFunc*)Itcl_GetListValue(elem);
-        Tcl_AppendToObj(resultPtr, "\n  ", -1);
-        Itcl_GetMemberFuncUsage(imPtr, contextIoPtr, resultPtr);
-
-        elem = Itcl_NextListElem(elem);
+    if (thisPtr != NULL) {
+        Tcl_DecrRefCount(thisPtr);
     }
-    Itcl_DeleteList(&cmdList);
 }
-
+
 /*
  * ------------------------------------------------------------------------
  *  ItclTraceThisVar()
  *
- *  Invoked to handle read/write traces on the "this" variable built
- *  into each object.
- *
- *  On read, this procedure updates the "this" variable to contain the
- *  current object name.  This is done dynamically, since an object's
- *  identity can change if its access command is renamed.
- *
- *  On write, this procedure returns an error string, warning that
- *  the "this" variable cannot be set.
+ *  Invoked to handle write traces on the "this" variable built
+ *  into each object.  Returns an error string, warning that the
+ *  "this" variable cannot be set.
  * ------------------------------------------------------------------------
  */
 /* ARGSUSED */
@@ -2089,53 +2728,22 @@ ItclTraceThisVar(
     const char *name2,    /* unused */
     int flags)		    /* flags indicating read/write */
 {
-    ItclObject *contextIoPtr = (ItclObject*)cdata;
-    Tcl_Obj *objPtr;
-    const char *objName;
     (void)name2;
 
     /* because of SF bug #187 use a different trace handler for "this", "win", "type"
      * *self" and "selfns"
      */
-
-    /*
-     *  Handle read traces on "this"
-     */
-    if ((flags & TCL_TRACE_READS) != 0) {
-        objPtr = Tcl_NewStringObj("", -1);
-        if (contextIoPtr->accessCmd) {
-            Tcl_GetCommandFullName(contextIoPtr->iclsPtr->interp,
-                contextIoPtr->accessCmd, objPtr);
-        }
-        objName = Tcl_GetString(objPtr);
-        Tcl_SetVar2(interp, name1, NULL, objName, 0);
-
-        Tcl_DecrRefCount(objPtr);
-        return NULL;
-    }
-
-    /*
-     *  Handle write traces on "this"
-     */
-    if ((flags & TCL_TRACE_WRITES) != 0) {
-        return (char *)"variable \"this\" cannot be modified";
-    }
-    return NULL;
+    return TraceBuiltinVar((ItclObject*)cdata, interp, name1, flags,
+            ITCL_THIS_VAR, "variable \"this\" cannot be modified");
 }
 
 /*
  * ------------------------------------------------------------------------
  *  ItclTraceWinVar()
  *
- *  Invoked to handle read/write traces on the "win" variable built
- *  into each object.
- *
- *  On read, this procedure updates the "win" variable to contain the
- *  current object name.  This is done dynamically, since an object's
- *  identity can change if its access command is renamed.
- *
- *  On write, this procedure returns an error string, warning that
- *  the "win" variable cannot be set.
+ *  Invoked to handle write traces on the "win" variable built
+ *  into each object.  Returns an error string, warning that the
+ *  "win" variable cannot be set, except for extendedclasses.
  * ------------------------------------------------------------------------
  */
 /* ARGSUSED */
@@ -2148,55 +2756,20 @@ ItclTraceWinVar(
     int flags)		    /* flags indicating read/write */
 {
     ItclObject *contextIoPtr = (ItclObject*)cdata;
-    Tcl_DString buffer;
-    Tcl_Obj *objPtr;
-    const char *objName;
-    const char *head;
-    const char *tail;
     (void)name2;
 
-    /*
-     *  Handle read traces on "win"
-     */
-    if ((flags & TCL_TRACE_READS) != 0) {
-        objPtr = Tcl_NewStringObj("", -1);
-        /* a window path name must not contain namespace parts !! */
-        Itcl_ParseNamespPath(Tcl_GetString(contextIoPtr->origNamePtr), &buffer, &head, &tail);
-	if (tail == NULL) {
-	    return (char *)" INTERNAL ERROR tail == NULL in ItclTraceThisVar for win";
-	}
-        Tcl_SetStringObj(objPtr, tail, -1);
-        objName = Tcl_GetString(objPtr);
-        Tcl_SetVar2(interp, name1, NULL, objName, 0);
-
-        Tcl_DecrRefCount(objPtr);
-        return NULL;
-    }
-
-    /*
-     *  Handle write traces on "win"
-     */
-    if ((flags & TCL_TRACE_WRITES) != 0) {
-        if (!(contextIoPtr->iclsPtr->flags & ITCL_ECLASS)) {
-            return (char *)"variable \"win\" cannot be modified";
-        }
-    }
-    return NULL;
+    return TraceBuiltinVar(contextIoPtr, interp, name1, flags,
+            ITCL_WIN_VAR, (contextIoPtr->iclsPtr->flags & ITCL_ECLASS) ?
+            NULL : "variable \"win\" cannot be modified");
 }
 
 /*
  * ------------------------------------------------------------------------
  *  ItclTraceTypeVar()
  *
- *  Invoked to handle read/write traces on the "type" variable built
- *  into each object.
- *
- *  On read, this procedure updates the "type" variable to contain the
- *  current object name.  This is done dynamically, since an object's
- *  identity can change if its access command is renamed.
- *
- *  On write, this procedure returns an error string, warning that
- *  the "type" variable cannot be set.
+ *  Invoked to handle write traces on the "type" variable built
+ *  into each object.  Returns an error string, warning that the
+ *  "type" variable cannot be set.
  * ------------------------------------------------------------------------
  */
 /* ARGSUSED */
@@ -2208,32 +2781,10 @@ ItclTraceTypeVar(
     const char *name2,    /* unused */
     int flags)		    /* flags indicating read/write */
 {
-    ItclObject *contextIoPtr = (ItclObject*)cdata;
-    Tcl_Obj *objPtr;
-    const char *objName;
     (void)name2;
 
-    /*
-     *  Handle read traces on "type"
-     */
-    if ((flags & TCL_TRACE_READS) != 0) {
-        objPtr = Tcl_NewStringObj("", -1);
-        Tcl_SetStringObj(objPtr,
-        Tcl_GetCurrentNamespace(contextIoPtr->iclsPtr->interp)->fullName, -1);
-        objName = Tcl_GetString(objPtr);
-        Tcl_SetVar2(interp, name1, NULL, objName, 0);
-
-        Tcl_DecrRefCount(objPtr);
-        return NULL;
-    }
-
-    /*
-     *  Handle write traces on "type"
-     */
-    if ((flags & TCL_TRACE_WRITES) != 0) {
-        return (char *)"variable \"type\" cannot be modified";
-    }
-    return NULL;
+    return TraceBuiltinVar((ItclObject*)cdata, interp, name1, flags,
+            ITCL_TYPE_VAR, "variable \"type\" cannot be modified");
 }
 
 /*
@@ -2241,11 +2792,7 @@ ItclTraceTypeVar(
  *  ItclTraceSelfVar()
  *
  *  Invoked to handle read/write traces on the "self" variable built
- *  into each object.
- *
- *  On read, this procedure updates the "self" variable to contain the
- *  current object name.  This is done dynamically, since an object's
- *  identity can change if its access command is renamed.
+ *  into each object.  Only widgets trace reads, see TraceBuiltinVar().
  *
  *  On write, this procedure returns an error string, warning that
  *  the "self" variable cannot be set.
@@ -2260,63 +2807,19 @@ ItclTraceSelfVar(
     const char *name2,    /* unused */
     int flags)		    /* flags indicating read/write */
 {
-    ItclObject *contextIoPtr = (ItclObject*)cdata;
-    Tcl_Obj *objPtr;
-    const char *objName;
     (void)name2;
 
-    /*
-     *  Handle read traces on "self"
-     */
-    if ((flags & TCL_TRACE_READS) != 0) {
-        objPtr = Tcl_NewStringObj("", -1);
-        if (contextIoPtr->iclsPtr->flags &
-                (ITCL_WIDGET|ITCL_WIDGETADAPTOR)) {
-            const char *objectName;
-
-            objectName = ItclGetInstanceVar(
-                    contextIoPtr->iclsPtr->interp,
-                    "itcl_hull", NULL, contextIoPtr,
-                    contextIoPtr->iclsPtr);
-            if (strlen(objectName) == 0) {
-	        objPtr = contextIoPtr->namePtr;
-	        Tcl_IncrRefCount(objPtr);
-            } else {
-                Tcl_SetStringObj(objPtr, objectName, -1);
-            }
-        } else {
-            Tcl_GetCommandFullName(contextIoPtr->iclsPtr->interp,
-                    contextIoPtr->accessCmd, objPtr);
-        }
-        objName = Tcl_GetString(objPtr);
-        Tcl_SetVar2(interp, name1, NULL, objName, 0);
-
-        Tcl_DecrRefCount(objPtr);
-        return NULL;
-    }
-
-    /*
-     *  Handle write traces on "self"
-     */
-    if ((flags & TCL_TRACE_WRITES) != 0) {
-        return (char *)"variable \"self\" cannot be modified";
-    }
-    return NULL;
+    return TraceBuiltinVar((ItclObject*)cdata, interp, name1, flags,
+            ITCL_SELF_VAR, "variable \"self\" cannot be modified");
 }
 
 /*
  * ------------------------------------------------------------------------
  *  ItclTraceSelfnsVar()
  *
- *  Invoked to handle read/write traces on the "selfns" variable built
- *  into each object.
- *
- *  On read, this procedure updates the "selfns" variable to contain the
- *  current object name.  This is done dynamically, since an object's
- *  identity can change if its access command is renamed.
- *
- *  On write, this procedure returns an error string, warning that
- *  the "selfns" variable cannot be set.
+ *  Invoked to handle write traces on the "selfns" variable built
+ *  into each object.  Returns an error string, warning that the
+ *  "selfns" variable cannot be set.
  * ------------------------------------------------------------------------
  */
 /* ARGSUSED */
@@ -2328,89 +2831,12 @@ ItclTraceSelfnsVar(
     const char *name2,    /* unused */
     int flags)	          /* flags indicating read/write */
 {
-    ItclObject *contextIoPtr = (ItclObject*)cdata;
-    Tcl_Obj *objPtr;
-    const char *objName;
     (void)name2;
 
-    /*
-     *  Handle read traces on "selfns"
-     */
-    if ((flags & TCL_TRACE_READS) != 0) {
-        objPtr = Tcl_NewStringObj("", -1);
-        Tcl_SetStringObj(objPtr, Tcl_GetString(contextIoPtr->varNsNamePtr), -1);
-        Tcl_AppendToObj(objPtr,
-                Tcl_GetString(contextIoPtr->iclsPtr->fullNamePtr), -1);
-        objName = Tcl_GetString(objPtr);
-        Tcl_SetVar2(interp, name1, NULL, objName, 0);
-
-        Tcl_DecrRefCount(objPtr);
-        return NULL;
-    }
-
-    /*
-     *  Handle write traces on "selfns"
-     */
-    if ((flags & TCL_TRACE_WRITES) != 0) {
-        return (char *)"variable \"selfns\" cannot be modified";
-    }
-    return NULL;
+    return TraceBuiltinVar((ItclObject*)cdata, interp, name1, flags,
+            ITCL_SELFNS_VAR, "variable \"selfns\" cannot be modified");
 }
-
-/*
- * ------------------------------------------------------------------------
- *  ItclTraceOptionVar()
- *
- *  Invoked to handle read/write traces on "option" variables
- *
- *  On read, this procedure checks if there is a cgetMethodPtr and calls it
- *  On write, this procedure checks if there is a configureMethodPtr
- *  or validateMethodPtr and calls it
- * ------------------------------------------------------------------------
- */
-/* ARGSUSED */
-static char*
-ItclTraceOptionVar(
-    ClientData cdata,	    /* object instance data */
-    Tcl_Interp *interp,	    /* interpreter managing this variable */
-    const char *name1,      /* variable name */
-    const char *name2,      /* unused */
-    int flags)		    /* flags indicating read/write */
-{
-    ItclObject *ioPtr;
-    ItclOption *ioptPtr;
-    (void)interp;
-    (void)name1;
-    (void)name2;
-
-/* FIXME !!! */
-/* don't know yet if ItclTraceOptionVar is really needed !! */
-/* FIXME should free memory on unset or rename!! */
-    if (cdata != NULL) {
-        ioPtr = (ItclObject*)cdata;
-	if (ioPtr == NULL) {
-	}
-    } else {
-        ioptPtr = (ItclOption*)cdata;
-	if (ioptPtr == NULL) {
-	}
-        /*
-         *  Handle read traces "itcl_options"
-         */
-        if ((flags & TCL_TRACE_READS) != 0) {
-            return NULL;
-        }
 
-        /*
-         *  Handle write traces "itcl_options"
-         */
-        if ((flags & TCL_TRACE_WRITES) != 0) {
-            return NULL;
-        }
-    }
-    return NULL;
-}
-
 /*
  * ------------------------------------------------------------------------
  *  ItclTraceComponentVar()
@@ -2451,7 +2877,7 @@ ItclTraceComponentVar(
 	    return NULL;
 	}
         objPtr = Tcl_NewStringObj(name1, -1);
-	hPtr = Tcl_FindHashEntry(&ioPtr->objectComponents, (char *)objPtr);
+	hPtr = Tcl_FindHashEntry(ioPtr->objectComponents, (char *)objPtr);
         Tcl_DecrRefCount(objPtr);
 
         /*
@@ -2639,6 +3065,8 @@ ItclDestroyObject(
             Tcl_DeleteHashEntry(hPtr);
         }
         contextIoPtr->accessCmd = NULL;
+        RefreshBuiltinVars(contextIoPtr->interp, contextIoPtr,
+                ITCL_THIS_VAR|ITCL_SELF_VAR);
     }
     Itcl_ReleaseData(contextIoPtr);
 }
@@ -2659,9 +3087,14 @@ FreeObject(
     Tcl_HashSearch place;
     ItclCallContext *callContextPtr;
     ItclObject *ioPtr;
+    ItclObjectInfo *infoPtr;
+    ItclClass *iclsPtr;
     Tcl_Var var;
+    int i;
 
     ioPtr = (ItclObject*)cdata;
+    infoPtr = ioPtr->infoPtr;
+    iclsPtr = ioPtr->iclsPtr;
 
     /*
      *  Install the class namespace and object context so that
@@ -2675,16 +3108,23 @@ FreeObject(
      *    from below.
      */
 
-    ItclReleaseClass(ioPtr->iclsPtr);
+    if (ioPtr->prevInstancePtr != NULL) {
+        ioPtr->prevInstancePtr->nextInstancePtr = ioPtr->nextInstancePtr;
+    } else {
+        ioPtr->iclsPtr->instancesPtr = ioPtr->nextInstancePtr;
+    }
+    if (ioPtr->nextInstancePtr != NULL) {
+        ioPtr->nextInstancePtr->prevInstancePtr = ioPtr->prevInstancePtr;
+    }
     if (ioPtr->constructed) {
         Tcl_DeleteHashTable(ioPtr->constructed);
-        ckfree((char*)ioPtr->constructed);
+        ItclPoolFree(infoPtr, ioPtr->constructed, sizeof(Tcl_HashTable));
     }
     if (ioPtr->destructed) {
         Tcl_DeleteHashTable(ioPtr->destructed);
-        ckfree((char*)ioPtr->destructed);
+        ItclPoolFree(infoPtr, ioPtr->destructed, sizeof(Tcl_HashTable));
     }
-    ItclDeleteObjectsDictInfo(ioPtr->interp, ioPtr);
+    infoPtr->objectsDictStale = 1;
     /*
      *  Delete all context definitions.
      */
@@ -2695,19 +3135,45 @@ FreeObject(
 	}
 	callContextPtr = (ItclCallContext *)Tcl_GetHashValue(hPtr);
 	Tcl_DeleteHashEntry(hPtr);
-	ckfree((char *)callContextPtr);
+	ItclPoolFree(infoPtr, callContextPtr, sizeof(ItclCallContext));
+    }
+    for (i = 0; ioPtr->layoutPtr != NULL
+	    && i < ioPtr->layoutPtr->numSlots; i++) {
+	if (ioPtr->varSlots[i] != NULL) {
+	    Itcl_ReleaseVar(ioPtr->varSlots[i]);
+	}
+    }
+    if (ioPtr->extraVariables != NULL) {
+	FOREACH_HASH_VALUE(var, ioPtr->extraVariables) {
+	    Itcl_ReleaseVar(var);
+	}
+	Tcl_DeleteHashTable(ioPtr->extraVariables);
+	ItclPoolFree(infoPtr, ioPtr->extraVariables, sizeof(Tcl_HashTable));
+    }
+    if (ioPtr->optionSlots != NULL) {
+	for (i = 0; i < ioPtr->layoutPtr->numOptSlots; i++) {
+	    if (ioPtr->optionSlots[i] != NULL) {
+		Itcl_ReleaseVar(ioPtr->optionSlots[i]);
+	    }
+	}
+	ItclPoolFree(infoPtr, ioPtr->optionSlots,
+		ioPtr->layoutPtr->numOptSlots * sizeof(Tcl_Var));
     }
-    FOREACH_HASH_VALUE(var, &ioPtr->objectVariables) {
-	Itcl_ReleaseVar(var);
+    if (ioPtr->optionsVar != NULL) {
+	Itcl_ReleaseVar(ioPtr->optionsVar);
+    }
+    if (ioPtr->layoutPtr != NULL) {
+	ItclPoolFree(infoPtr, ioPtr->varSlots,
+		ioPtr->layoutPtr->numSlots * sizeof(Tcl_Var));
+	ItclReleaseInstanceLayout(ioPtr->layoutPtr);
     }
 
     Tcl_DeleteHashTable(&ioPtr->contextCache);
-    Tcl_DeleteHashTable(&ioPtr->objectVariables);
-    Tcl_DeleteHashTable(&ioPtr->objectOptions);
-    Tcl_DeleteHashTable(&ioPtr->objectComponents);
-    Tcl_DeleteHashTable(&ioPtr->objectMethodVariables);
-    Tcl_DeleteHashTable(&ioPtr->objectDelegatedOptions);
-    Tcl_DeleteHashTable(&ioPtr->objectDelegatedFunctions);
+    FreeObjectTable(ioPtr, ioPtr->objectOptions);
+    FreeObjectTable(ioPtr, ioPtr->objectComponents);
+    FreeObjectTable(ioPtr, ioPtr->objectMethodVariables);
+    FreeObjectTable(ioPtr, ioPtr->objectDelegatedOptions);
+    FreeObjectTable(ioPtr, ioPtr->objectDelegatedFunctions);
     Tcl_DecrRefCount(ioPtr->namePtr);
     Tcl_DecrRefCount(ioPtr->origNamePtr);
     if (ioPtr->createNamePtr != NULL) {
@@ -2717,11 +3183,21 @@ FreeObject(
         Tcl_DecrRefCount(ioPtr->hullWindowNamePtr);
     }
     Tcl_DecrRefCount(ioPtr->varNsNamePtr);
+    if (ioPtr->callbackNamePtr != NULL) {
+        Tcl_DecrRefCount(ioPtr->callbackNamePtr);
+    }
     if (ioPtr->resolvePtr != NULL) {
-	ckfree((char *)ioPtr->resolvePtr->clientData);
-        ckfree((char*)ioPtr->resolvePtr);
+	ItclPoolFree(infoPtr, ioPtr->resolvePtr->clientData,
+		sizeof(ItclResolveInfo));
+        ItclPoolFree(infoPtr, ioPtr->resolvePtr, sizeof(Tcl_Resolve));
     }
-    Itcl_Free(ioPtr);
+    ItclPoolFreePreservable(infoPtr, ioPtr, sizeof(ItclObject));
+
+    /*
+     *  Let go of the class last.  It keeps the ItclObjectInfo and with
+     *  it the record pools alive while the object memory goes back.
+     */
+    ItclReleaseClass(iclsPtr);
 }
 
 /*
@@ -2999,6 +3475,126 @@ GetClassFromClassName(
     return iclsPtr;
 }
 
+/*
+ * ------------------------------------------------------------------------
+ *  ResolveMethodName()
+ *
+ *  Does the name parsing part of ItclMapMethodNameProc(): splits off a
+ *  "Class::" prefix, finds that class and looks up the member the name
+ *  stands for in the virtual method table of iclsPtr.  Results for
+ *  names that resolve to a member are remembered in the class, so only
+ *  the first call with a name pays for this.  Returns the remembered
+ *  record, or mapPtr filled in for a name that has no member.
+ * ------------------------------------------------------------------------
+ */
+
+static ItclMethodMap *
+ResolveMethodName(
+    Tcl_Interp *interp,
+    ItclClass *iclsPtr,
+    Tcl_Obj *methodObj,
+    ItclMethodMap *mapPtr)
+{
+    Tcl_HashEntry *hPtr;
+    Tcl_DString buffer;
+    ItclObjectInfo *infoPtr;
+    ItclMethodMap *cachedPtr;
+    ItclClass *iclsPtr2;
+    Tcl_Obj *namePtr;
+    const char *head;
+    const char *tail;
+    int isNew;
+
+    infoPtr = iclsPtr->infoPtr;
+    if (iclsPtr->methodMapPtr != NULL) {
+        hPtr = Tcl_FindHashEntry(iclsPtr->methodMapPtr, (char *)methodObj);
+        if (hPtr != NULL) {
+            cachedPtr = (ItclMethodMap *)Tcl_GetHashValue(hPtr);
+            if (cachedPtr->classEpoch == infoPtr->classEpoch) {
+                return cachedPtr;
+            }
+        }
+    }
+
+    memset(mapPtr, 0, sizeof(ItclMethodMap));
+    namePtr = methodObj;
+    Itcl_ParseNamespPath(Tcl_GetString(methodObj), &buffer, &head, &tail);
+    if ((head != NULL) && (*head != '\0')) {
+        iclsPtr2 = GetClassFromClassName(interp, head, iclsPtr);
+        if (iclsPtr2 != NULL) {
+            mapPtr->startIclsPtr = iclsPtr2;
+            mapPtr->tailPtr = Tcl_NewStringObj(tail, -1);
+            Tcl_IncrRefCount(mapPtr->tailPtr);
+            namePtr = mapPtr->tailPtr;
+        }
+    }
+    Tcl_DStringFree(&buffer);
+    hPtr = Tcl_FindHashEntry(&iclsPtr->resolveCmds, (char *)namePtr);
+    if (hPtr == NULL) {
+        /*
+         *  Not remembered, so that unknown names can't fill the table.
+         *  The caller releases tailPtr.
+         */
+        return mapPtr;
+    }
+    mapPtr->imPtr = ((ItclCmdLookup *)Tcl_GetHashValue(hPtr))->imPtr;
+    mapPtr->classEpoch = infoPtr->classEpoch;
+
+    if (iclsPtr->methodMapPtr == NULL) {
+        iclsPtr->methodMapPtr = (Tcl_HashTable *)ckalloc(sizeof(Tcl_HashTable));
+        Tcl_InitObjHashTable(iclsPtr->methodMapPtr);
+    }
+    /*
+     *  The caller goes on to change methodObj, so the table gets a
+     *  key of its own.
+     */
+    namePtr = Tcl_NewStringObj(Tcl_GetString(methodObj), -1);
+    Tcl_IncrRefCount(namePtr);
+    hPtr = Tcl_CreateHashEntry(iclsPtr->methodMapPtr, (char *)namePtr, &isNew);
+    Tcl_DecrRefCount(namePtr);
+    if (isNew) {
+        cachedPtr = (ItclMethodMap *)ckalloc(sizeof(ItclMethodMap));
+        Tcl_SetHashValue(hPtr, cachedPtr);
+    } else {
+        cachedPtr = (ItclMethodMap *)Tcl_GetHashValue(hPtr);
+        if (cachedPtr->tailPtr != NULL) {
+            Tcl_DecrRefCount(cachedPtr->tailPtr);
+        }
+    }
+    *cachedPtr = *mapPtr;
+    return cachedPtr;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclDeleteMethodMap()
+ *
+ *  Frees the method names remembered by ResolveMethodName() for a
+ *  class.  Called when the class goes away.
+ * ------------------------------------------------------------------------
+ */
+
+void
+ItclDeleteMethodMap(
+    ItclClass *iclsPtr)
+{
+    FOREACH_HASH_DECLS;
+    ItclMethodMap *mapPtr;
+
+    if (iclsPtr->methodMapPtr == NULL) {
+        return;
+    }
+    FOREACH_HASH_VALUE(mapPtr, iclsPtr->methodMapPtr) {
+        if (mapPtr->tailPtr != NULL) {
+            Tcl_DecrRefCount(mapPtr->tailPtr);
+        }
+        ckfree((char *)mapPtr);
+    }
+    Tcl_DeleteHashTable(iclsPtr->methodMapPtr);
+    ckfree((char *)iclsPtr->methodMapPtr);
+    iclsPtr->methodMapPtr = NULL;
+}
+
 /*
  * ------------------------------------------------------------------------
  *  ItclMapMethodNameProc()
@@ -3012,22 +3608,17 @@ ItclMapMethodNameProc(
     Tcl_Class *startClsPtr,
     Tcl_Obj *methodObj)
 {
-    Tcl_Obj *methodName;
-    Tcl_Obj *className;
-    Tcl_DString buffer;
     Tcl_HashEntry *hPtr;
     Tcl_Namespace * myNsPtr;
     ItclObject *ioPtr;
     ItclClass *iclsPtr;
     ItclClass *iclsPtr2;
     ItclObjectInfo *infoPtr;
-    const char *head;
-    const char *tail;
-    const char *sp;
+    ItclMethodMap map;
+    ItclMethodMap *mapPtr;
 
     iclsPtr = NULL;
     iclsPtr2 = NULL;
-    methodName = NULL;
     infoPtr = (ItclObjectInfo *)Tcl_GetAssocData(interp,
             ITCL_INTERP_DATA, NULL);
     ioPtr = (ItclObject *)Tcl_ObjectGetMetadata(oPtr,
@@ -3054,41 +3645,27 @@ ItclMapMethodNameProc(
 	}
         iclsPtr = ioPtr->iclsPtr;
     }
-    sp = Tcl_GetString(methodObj);
-    Itcl_ParseNamespPath(sp, &buffer, &head, &tail);
-    if (head == NULL) {
+    if (strstr(Tcl_GetString(methodObj), "::") == NULL) {
         /* itcl bug #3600923 call private method in class
 	 * without namespace
 	 */
         myNsPtr = Tcl_GetCurrentNamespace(iclsPtr->interp);
-	hPtr = Tcl_FindHashEntry(&infoPtr->namespaceClasses, (char *) myNsPtr);
-	if (hPtr) {
-	    iclsPtr2 = (ItclClass *) Tcl_GetHashValue(hPtr);
+	iclsPtr2 = ItclNamespaceClass(infoPtr, myNsPtr);
+	if (iclsPtr2 != NULL) {
 	    if (Itcl_IsMethodCallFrame(iclsPtr->interp) > 0) {
 		iclsPtr = iclsPtr2;
 	    }
 	}
     }
-    if (head != NULL) {
-        className = NULL;
-        methodName = Tcl_NewStringObj(tail, -1);
-        Tcl_IncrRefCount(methodName);
-        className = Tcl_NewStringObj(head, -1);
-        Tcl_IncrRefCount(className);
-	if (strlen(head) > 0) {
-	    iclsPtr2 = GetClassFromClassName(interp, head, iclsPtr);
-	} else {
-	    iclsPtr2 = NULL;
-	}
-	if (iclsPtr2 != NULL) {
-	    *startClsPtr = iclsPtr2->clsPtr;
-	    Tcl_SetStringObj(methodObj, Tcl_GetString(methodName), -1);
-	}
-        Tcl_DecrRefCount(className);
-        Tcl_DecrRefCount(methodName);
+    mapPtr = ResolveMethodName(interp, iclsPtr, methodObj, &map);
+    if (mapPtr->startIclsPtr != NULL) {
+        *startClsPtr = mapPtr->startIclsPtr->clsPtr;
+        Tcl_SetStringObj(methodObj, Tcl_GetString(mapPtr->tailPtr), -1);
+        if (mapPtr == &map) {
+            Tcl_DecrRefCount(map.tailPtr);
+        }
     }
-    hPtr = Tcl_FindHashEntry(&iclsPtr->resolveCmds, (char *)methodObj);
-    if (hPtr == NULL) {
+    if (mapPtr->imPtr == NULL) {
         /* special case: we found the class for the class command,
 	 * for a relative or absolute class path name
 	 * but we have no method in that class that fits.
@@ -3100,12 +3677,22 @@ ItclMapMethodNameProc(
     } else {
 	ItclMemberFunc *imPtr;
 	Tcl_Namespace *nsPtr;
-	ItclCmdLookup *clookup;
 
 	nsPtr = Tcl_GetCurrentNamespace(interp);
-	clookup = (ItclCmdLookup *)Tcl_GetHashValue(hPtr);
-	imPtr = clookup->imPtr;
-        if (!Itcl_CanAccessFunc(imPtr, nsPtr)) {
+	imPtr = mapPtr->imPtr;
+        if (mapPtr->accessNsPtr == nsPtr) {
+            return TCL_OK;
+        }
+        if (Itcl_CanAccessFunc(imPtr, nsPtr)) {
+            /*
+             *  Only grants are remembered; a namespace that gets access
+             *  to a non-public member belongs to a class, and deleting
+             *  that class moves the epoch on.
+             */
+            if (mapPtr != &map) {
+                mapPtr->accessNsPtr = nsPtr;
+            }
+        } else {
 	    char *token = Tcl_GetString(imPtr->namePtr);
 	    if ((*token != 'i') || (strcmp(token, "info") != 0)) {
 		/* needed for test protect-2.5 */
@@ -3164,7 +3751,6 @@ ItclMapMethodNameProc(
             }
         }
     }
-    Tcl_DStringFree(&buffer);
     return TCL_OK;
 }
 
@@ -3742,12 +4328,7 @@ ItclClass *
 ItclNamespace2Class(Tcl_Namespace *nsPtr)
 {
     ItclObjectInfo * infoPtr;
-    Tcl_HashEntry *hPtr;
     infoPtr = (ItclObjectInfo *)Tcl_GetAssocData(((Namespace *)nsPtr)->interp,
 	ITCL_INTERP_DATA, NULL);
-    hPtr = Tcl_FindHashEntry(&(infoPtr->namespaceClasses), nsPtr);
-    if (hPtr == NULL) {
-	return NULL;
-    }
-    return (ItclClass *)Tcl_GetHashValue(hPtr);
+    return ItclNamespaceClass(infoPtr, nsPtr);
 }
@@ -135,6 +135,7 @@ static Tcl_ObjCmdProc Itcl_ClassForwardCmd;
 static Tcl_ObjCmdProc Itcl_ClassMethodVariableCmd;
 static Tcl_ObjCmdProc Itcl_ClassTypeConstructorCmd;
 static Tcl_ObjCmdProc ItclGenericClassCmd;
+static int SetClassSuperclasses(Tcl_Interp *interp, ItclClass *iclsPtr);
 
 static const struct {
     const char *name;
@@ -343,6 +344,9 @@ Itcl_ParseInit(
     Tcl_CreateObjCommand(interp, "::itcl::scope", Itcl_ScopeCmd,
         NULL, NULL);
 
+    Tcl_CreateObjCommand(interp, "::itcl::local", Itcl_LocalCmd,
+        NULL, NULL);
+
     /*
      *  Add the "filter" commands (add/delete)
      */
@@ -410,6 +414,100 @@ Itcl_ParseInit(
     }
     Itcl_PreserveData(infoPtr);
 
+    /*
+     *  Add the internal "snapshot" (record/load) commands.
+     */
+    if (Itcl_CreateEnsemble(interp,
+            "::itcl::internal::commands::snapshot") != TCL_OK) {
+        return TCL_ERROR;
+    }
+
+    if (Itcl_AddEnsemblePart(interp, "::itcl::internal::commands::snapshot",
+            "record", "fileName sourceFiles script",
+	    Itcl_SnapshotRecordCmd, infoPtr,
+	    Itcl_ReleaseData) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    Itcl_PreserveData(infoPtr);
+
+    if (Itcl_AddEnsemblePart(interp, "::itcl::internal::commands::snapshot",
+            "load", "fileName sourceFiles",
+	    Itcl_SnapshotLoadCmd, infoPtr,
+	    Itcl_ReleaseData) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    Itcl_PreserveData(infoPtr);
+
+    /*
+     *  Add the "autoindex" (create/add/load) commands.
+     */
+    if (Itcl_CreateEnsemble(interp, "::itcl::autoindex") != TCL_OK) {
+        return TCL_ERROR;
+    }
+
+    if (Itcl_AddEnsemblePart(interp, "::itcl::autoindex",
+            "create", "indexFile ?sourceFile ...?",
+	    Itcl_AutoIndexCreateCmd, infoPtr,
+	    Itcl_ReleaseData) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    Itcl_PreserveData(infoPtr);
+
+    if (Itcl_AddEnsemblePart(interp, "::itcl::autoindex",
+            "add", "indexFile",
+	    Itcl_AutoIndexAddCmd, infoPtr,
+	    Itcl_ReleaseData) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    Itcl_PreserveData(infoPtr);
+
+    if (Itcl_AddEnsemblePart(interp, "::itcl::autoindex",
+            "load", "fullName",
+	    Itcl_AutoIndexLoadCmd, infoPtr,
+	    Itcl_ReleaseData) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    Itcl_PreserveData(infoPtr);
+
+    /*
+     *  Add the "profile" (start/stop/reset/report) commands.
+     */
+    if (Itcl_CreateEnsemble(interp, "::itcl::profile") != TCL_OK) {
+        return TCL_ERROR;
+    }
+
+    if (Itcl_AddEnsemblePart(interp, "::itcl::profile",
+            "start", "",
+	    Itcl_ProfileStartCmd, infoPtr,
+	    Itcl_ReleaseData) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    Itcl_PreserveData(infoPtr);
+
+    if (Itcl_AddEnsemblePart(interp, "::itcl::profile",
+            "stop", "",
+	    Itcl_ProfileStopCmd, infoPtr,
+	    Itcl_ReleaseData) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    Itcl_PreserveData(infoPtr);
+
+    if (Itcl_AddEnsemblePart(interp, "::itcl::profile",
+            "reset", "",
+	    Itcl_ProfileResetCmd, infoPtr,
+	    Itcl_ReleaseData) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    Itcl_PreserveData(infoPtr);
+
+    if (Itcl_AddEnsemblePart(interp, "::itcl::profile",
+            "report", "?-sort key? ?-format dict|csv?",
+	    Itcl_ProfileReportCmd, infoPtr,
+	    Itcl_ReleaseData) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    Itcl_PreserveData(infoPtr);
+
     /*
      *  Add commands for handling import stubs at the Tcl level.
      */
@@ -479,6 +577,14 @@ Itcl_ParseInit(
         ItclGenericClassCmd, infoPtr, Itcl_ReleaseData);
     Itcl_PreserveData(infoPtr);
 
+    Tcl_CreateObjCommand(interp, ITCL_COMMANDS_NAMESPACE "::pools",
+        ItclPoolsCmd, infoPtr, Itcl_ReleaseData);
+    Itcl_PreserveData(infoPtr);
+
+    Tcl_CreateObjCommand(interp, ITCL_COMMANDS_NAMESPACE "::scopedvar",
+        ItclScopedVarCmd, infoPtr, Itcl_ReleaseData);
+    Itcl_PreserveData(infoPtr);
+
     /*
      *  Add the "delegate" (method/option) commands.
      */
@@ -718,6 +824,61 @@ ArgCallProc(
     return TCL_ERROR;
 }
 
+/*
+ * ------------------------------------------------------------------------
+ *  SetClassSuperclasses()
+ *
+ *  Installs the base classes of iclsPtr, or ::itcl::Root if it has
+ *  none, as the superclasses of the underlying TclOO class.  Called
+ *  once at the end of the class definition, so a class body with an
+ *  "inherit" changes the TclOO hierarchy only once.  The command words
+ *  are handed to "::oo::define" as they are, nothing is reparsed.
+ * ------------------------------------------------------------------------
+ */
+static int
+SetClassSuperclasses(
+    Tcl_Interp *interp,
+    ItclClass *iclsPtr)
+{
+    Tcl_Obj *staticObjv[8];
+    Tcl_Obj **objv;
+    Itcl_ListElem *elem;
+    int objc;
+    int i;
+    int result;
+
+    objc = 3 + Itcl_GetListLength(&iclsPtr->bases);
+    if (objc == 3) {
+        objc = 4;
+    }
+    objv = staticObjv;
+    if (objc > (int)(sizeof(staticObjv)/sizeof(staticObjv[0]))) {
+        objv = (Tcl_Obj **)ckalloc(objc * sizeof(Tcl_Obj *));
+    }
+    objv[0] = Tcl_NewStringObj("::oo::define", -1);
+    objv[1] = iclsPtr->fullNamePtr;
+    objv[2] = Tcl_NewStringObj("superclass", -1);
+    elem = Itcl_FirstListElem(&iclsPtr->bases);
+    if (elem == NULL) {
+        objv[3] = Tcl_NewStringObj("::itcl::Root", -1);
+    }
+    for (i = 3; elem != NULL; i++) {
+        objv[i] = ((ItclClass *)Itcl_GetListValue(elem))->fullNamePtr;
+        elem = Itcl_NextListElem(elem);
+    }
+    for (i = 0; i < objc; i++) {
+        Tcl_IncrRefCount(objv[i]);
+    }
+    result = Tcl_EvalObjv(interp, objc, objv, 0);
+    for (i = 0; i < objc; i++) {
+        Tcl_DecrRefCount(objv[i]);
+    }
+    if (objv != staticObjv) {
+        ckfree((char *)objv);
+    }
+    return result;
+}
+
 int
 ItclClassBaseCmd(
     ClientData clientData,   /* info for all known objects */
@@ -739,6 +900,7 @@ ItclClassBaseCmd(
     ItclObjectInfo* infoPtr;
     char *className;
     int isNewEntry;
+    int isSplitBody;
     int result;
     int noCleanup;
     ItclMemberFunc *imPtr;
@@ -813,8 +975,16 @@ ItclClassBaseCmd(
         /* isProcCallFrame */ 0);
 
     Itcl_SetCallFrameResolver(interp, iclsPtr->resolvePtr);
+    isSplitBody = 0;
     if (result == TCL_OK) {
-        result = Tcl_EvalObjEx(interp, objv[2], 0);
+        if (objv[2] == infoPtr->snapshotBodyPtr) {
+            /* defined by "snapshot load" */
+            infoPtr->snapshotBodyPtr = NULL;
+            isSplitBody = 1;
+            result = ItclEvalSnapshotBody(interp, objv[2]);
+        } else {
+            result = Tcl_EvalObjEx(interp, objv[2], 0);
+        }
         Itcl_PopCallFrame(interp);
     }
     Itcl_PopStack(&infoPtr->clsStack);
@@ -843,24 +1013,13 @@ ItclClassBaseCmd(
         goto errorReturn;
     }
 
-    if (Itcl_FirstListElem(&iclsPtr->bases) == NULL) {
-	/* No [inherit]. Use default inheritance root. */
-	Tcl_Obj *cmdPtr = Tcl_NewListObj(4, NULL);
-
-	Tcl_ListObjAppendElement(NULL, cmdPtr,
-		Tcl_NewStringObj("::oo::define", -1));
-	Tcl_ListObjAppendElement(NULL, cmdPtr, iclsPtr->fullNamePtr);
-	Tcl_ListObjAppendElement(NULL, cmdPtr,
-		Tcl_NewStringObj("superclass", -1));
-	Tcl_ListObjAppendElement(NULL, cmdPtr,
-		Tcl_NewStringObj("::itcl::Root", -1));
-
-	Tcl_IncrRefCount(cmdPtr);
-	result = Tcl_EvalObjEx(interp, cmdPtr, 0);
-	Tcl_DecrRefCount(cmdPtr);
-	if (result == TCL_ERROR) {
-	    goto errorReturn;
-	}
+    /*
+     *  Wire up the TclOO superclasses: the base classes named by
+     *  "inherit", or the default inheritance root.
+     */
+    result = SetClassSuperclasses(interp, iclsPtr);
+    if (result == TCL_ERROR) {
+        goto errorReturn;
     }
 
     /*
@@ -876,7 +1035,7 @@ ItclClassBaseCmd(
     /*
      *  Build the name resolution tables for all data members.
      */
-    Itcl_BuildVirtualTables(iclsPtr);
+    ItclFinishVirtualTables(iclsPtr);
 
     /* make the methods and procs known to TclOO */
     FOREACH_HASH_VALUE(imPtr, &iclsPtr->functions) {
@@ -1155,6 +1314,9 @@ if (imPtr->codePtr->flags & ITCL_IMPLEMENT_OBJCMD) {
         *iclsPtrPtr = iclsPtr;
     }
     ItclAddClassesDictInfo(interp, iclsPtr);
+    if (infoPtr->snapshotPtr != NULL) {
+        ItclSnapshotAddClass(infoPtr, iclsPtr, objv[2], isSplitBody);
+    }
     return result;
 errorReturn:
     if (!noCleanup) {
@@ -1300,7 +1462,6 @@ Itcl_ClassInheritCmd(
     int result;
     int i;
     int newEntry;
-    int haveClasses;
     const char *token;
     Itcl_ListElem *elem;
     Itcl_ListElem *elem2;
@@ -1310,7 +1471,6 @@ Itcl_ClassInheritCmd(
     ItclHierIter hier;
     Itcl_Stack stack;
     Tcl_CallFrame frame;
-    Tcl_DString buffer;
 
     ItclShowArgs(2, "Itcl_InheritCmd", objc, objv);
 
@@ -1402,6 +1562,7 @@ Itcl_ClassInheritCmd(
         Itcl_AppendList(&iclsPtr->bases, baseClsPtr);
 	ItclPreserveClass(baseClsPtr);
     }
+    ItclInvalidateHierarchy(iclsPtr);
 
     /*
      *  Scan through the inheritance list to make sure that no
@@ -1505,34 +1666,22 @@ Itcl_ClassInheritCmd(
      *  At this point, everything looks good.
      *  Finish the installation of the base classes.  Update
      *  each base class to recognize the current class as a
-     *  derived class.
+     *  derived class.  The TclOO superclasses follow at the end
+     *  of the class definition, see SetClassSuperclasses.
      */
-    Tcl_DStringInit(&buffer);
-    haveClasses = 0;
     elem = Itcl_FirstListElem(&iclsPtr->bases);
-    Tcl_DStringAppend(&buffer, "::oo::define ", -1);
-    Tcl_DStringAppend(&buffer, Tcl_GetString(iclsPtr->fullNamePtr), -1);
-    Tcl_DStringAppend(&buffer, " superclass", -1);
     while (elem) {
         baseClsPtr = (ItclClass*)Itcl_GetListValue(elem);
-        haveClasses++;
-        Tcl_DStringAppend(&buffer, " ", -1);
-        Tcl_DStringAppend(&buffer, Tcl_GetString(baseClsPtr->fullNamePtr), -1);
-
         Itcl_AppendList(&baseClsPtr->derived, iclsPtr);
 	ItclPreserveClass(iclsPtr);
 
         elem = Itcl_NextListElem(elem);
     }
     Itcl_PopCallFrame(interp);
-    if (haveClasses) {
-        result = Tcl_EvalEx(interp, Tcl_DStringValue(&buffer), -1, 0);
-    }
-    Tcl_DStringFree(&buffer);
 
     Itcl_BuildVirtualTables(iclsPtr);
 
-    return result;
+    return TCL_OK;
 
 
     /*
@@ -1547,6 +1696,7 @@ inheritError:
 	ItclReleaseClass( (ItclClass *)Itcl_GetListValue(elem) );
         elem = Itcl_DeleteListElem(elem);
     }
+    ItclInvalidateHierarchy(iclsPtr);
     return TCL_ERROR;
 }
 
@@ -2411,9 +2561,16 @@ ItclDelObjectInfo(
 	    /*hPtr = Tcl_NextHashEntry(&place);*/
     }
     Tcl_DeleteHashTable(&infoPtr->objects);
-    Tcl_DeleteHashTable(&infoPtr->frameContext);
+    ItclDeleteFrameContexts(infoPtr);
 
     Itcl_DeleteStack(&infoPtr->clsStack);
+    Itcl_DeleteStack(&infoPtr->freeClassIds);
+    assert(infoPtr->emptyObjectTable.numEntries == 0);
+    Tcl_DeleteHashTable(&infoPtr->emptyObjectTable);
+    Tcl_DecrRefCount(infoPtr->optionsVarNamePtr);
+    Tcl_DecrRefCount(infoPtr->namespaceWordPtr);
+    Tcl_DecrRefCount(infoPtr->inscopeWordPtr);
+    ItclDeletePools(infoPtr);
     Itcl_Free(infoPtr);
 }
 
@@ -2658,7 +2815,7 @@ ItclParseOption(
     }
     if (ioPtr != NULL) {
         /* check for already delegated!! */
-        hPtr = Tcl_FindHashEntry(&ioPtr->objectDelegatedOptions,
+        hPtr = Tcl_FindHashEntry(ioPtr->objectDelegatedOptions,
 	        (char *)objv[1]);
 	if (hPtr != NULL) {
 	    Tcl_AppendResult(interp, "cannot define option \"", optionName,
@@ -2832,6 +2989,7 @@ ItclParseOption(
     }
 
     ioptPtr = (ItclOption*)Itcl_Alloc(sizeof(ItclOption));
+    ioptPtr->slot         = -1;
     ioptPtr->protection   = Itcl_Protection(interp, 0);
     if (ioptPtr->protection == ITCL_DEFAULT_PROTECT) {
         ioptPtr->protection = ITCL_PROTECTED;
@@ -3003,6 +3161,7 @@ ItclCreateComponent(
         icPtr->ivPtr = ivPtr;
 	Tcl_SetHashValue(hPtr, icPtr);
         ItclAddClassVariableDictInfo(interp, iclsPtr, ivPtr);
+        ItclInvalidateInstanceLayout(iclsPtr);
     } else {
         icPtr = (ItclComponent *)Tcl_GetHashValue(hPtr);
     }
@@ -3407,7 +3566,7 @@ delegate method * ?to <componentName>? ?using <pattern>? ?except <methods>?";
     /* check for already delegated */
     methodNamePtr = Tcl_NewStringObj(methodName, -1);
     if (ioPtr != NULL) {
-        hPtr = Tcl_FindHashEntry(&ioPtr->objectDelegatedFunctions, (char *)
+        hPtr = Tcl_FindHashEntry(ioPtr->objectDelegatedFunctions, (char *)
                 methodNamePtr);
     } else {
         hPtr = Tcl_FindHashEntry(&iclsPtr->delegatedFunctions, (char *)
@@ -3701,7 +3860,7 @@ Itcl_HandleDelegateOptionCmd(
     allOptionNamePtr = Tcl_NewStringObj("*", -1);
     Tcl_IncrRefCount(allOptionNamePtr);
     if (ioPtr != NULL) {
-        hPtr = Tcl_FindHashEntry(&ioPtr->objectDelegatedOptions, (char *)
+        hPtr = Tcl_FindHashEntry(ioPtr->objectDelegatedOptions, (char *)
                 allOptionNamePtr);
     } else {
         hPtr = Tcl_FindHashEntry(&iclsPtr->delegatedOptions, (char *)
@@ -3752,7 +3911,7 @@ Itcl_HandleDelegateOptionCmd(
 	/* FIXME !!! */
         /* check for valid option name */
 	if (ioPtr != NULL) {
-	    hPtr = Tcl_FindHashEntry(&ioPtr->objectOptions,
+	    hPtr = Tcl_FindHashEntry(ioPtr->objectOptions,
 	            (char *)optionNamePtr);
 	} else {
             Itcl_InitHierIter(&hier, iclsPtr);
@@ -0,0 +1,612 @@
+/*
+ * itclProfile.c --
+ *
+ *      This file contains the method level profiler of [incr Tcl].  While
+ *      it is started with "itcl::profile start", ItclCheckCallMethod and
+ *      ItclAfterCallMethod report every call of a member function here,
+ *      and the number of calls, the inclusive and exclusive time and the
+ *      deepest recursion are counted for each ItclMemberFunc.  The
+ *      results are read with "itcl::profile report".  Inherited methods
+ *      and their overrides are different member functions, so they are
+ *      counted separately, under the name of the class defining them.
+ *
+ *      Time is taken from a monotonic clock where the platform has one.
+ *      Calls still running when a coroutine yields are charged for the
+ *      time until they return.
+ *
+ * See the file "license.terms" for information on usage and redistribution of
+ * this file, and for a DISCLAIMER OF ALL WARRANTIES.
+ */
+
+#include <stdlib.h>
+#include "itclInt.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+/*
+ *  The counters of one member function.
+ */
+typedef struct ItclProfileEntry {
+    ItclMemberFunc *imPtr;        /* member function counted, NULL once
+                                   * it is deleted */
+    Tcl_Obj *namePtr;             /* its full name */
+    Tcl_WideInt calls;            /* number of calls that returned */
+    Tcl_WideInt inclusive;        /* time spent in outermost calls,
+                                   * including called member functions,
+                                   * in nanoseconds */
+    Tcl_WideInt exclusive;        /* time spent in its own body, in
+                                   * nanoseconds */
+    int depth;                    /* calls currently running */
+    int maxDepth;                 /* largest depth of a counted call */
+    struct ItclProfileEntry *nextPtr;
+} ItclProfileEntry;
+
+/*
+ *  A call currently running.
+ */
+typedef struct ItclProfileFrame {
+    ItclProfileEntry *entryPtr;   /* member function called */
+    Tcl_WideInt start;            /* time of the call */
+    Tcl_WideInt childTime;        /* time spent in member functions it
+                                   * called */
+    int depth;                    /* depth of the entry with this call */
+} ItclProfileFrame;
+
+typedef struct ItclProfile {
+    ItclProfileEntry *entries;    /* counters, most recent first */
+    int numEntries;
+    ItclProfileFrame *frames;     /* calls running, innermost last */
+    int numFrames;
+    int maxFrames;
+} ItclProfile;
+
+/*
+ *  Columns of "itcl::profile report", also its sort keys.
+ */
+static const char *const reportKeys[] = {
+    "name", "calls", "inclusive", "exclusive", "maxdepth", NULL
+};
+enum ReportKey {
+    KEY_NAME, KEY_CALLS, KEY_INCLUSIVE, KEY_EXCLUSIVE, KEY_MAXDEPTH
+};
+
+
+/*
+ * ------------------------------------------------------------------------
+ *  ProfileNow()
+ *
+ *  Returns the time in nanoseconds from a monotonic clock, or from the
+ *  wall clock where there is none.
+ * ------------------------------------------------------------------------
+ */
+static Tcl_WideInt
+ProfileNow(void)
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER count;
+
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&count);
+    return (Tcl_WideInt)((double)count.QuadPart * 1.0e9
+            / (double)frequency.QuadPart);
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (Tcl_WideInt)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#else
+    Tcl_Time t;
+
+    Tcl_GetTime(&t);
+    return (Tcl_WideInt)t.sec * 1000000000 + (Tcl_WideInt)t.usec * 1000;
+#endif
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  GetProfile()
+ *
+ *  Returns the profile data of the interpreter, creating it on first
+ *  use.
+ * ------------------------------------------------------------------------
+ */
+static ItclProfile *
+GetProfile(
+    ItclObjectInfo *infoPtr)
+{
+    if (infoPtr->profilePtr == NULL) {
+        infoPtr->profilePtr = (ItclProfile *)ckalloc(sizeof(ItclProfile));
+        memset(infoPtr->profilePtr, 0, sizeof(ItclProfile));
+    }
+    return infoPtr->profilePtr;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  DiscardFrames()
+ *
+ *  Forgets the calls currently running, they are not counted when they
+ *  return.
+ * ------------------------------------------------------------------------
+ */
+static void
+DiscardFrames(
+    ItclProfile *profPtr)
+{
+    while (profPtr->numFrames > 0) {
+        profPtr->frames[--profPtr->numFrames].entryPtr->depth--;
+    }
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  FreeEntries()
+ *
+ *  Frees all counters and unlinks them from their member functions.
+ * ------------------------------------------------------------------------
+ */
+static void
+FreeEntries(
+    ItclProfile *profPtr)
+{
+    ItclProfileEntry *entryPtr;
+
+    profPtr->numFrames = 0;
+    while (profPtr->entries != NULL) {
+        entryPtr = profPtr->entries;
+        profPtr->entries = entryPtr->nextPtr;
+        if (entryPtr->imPtr != NULL) {
+            entryPtr->imPtr->profilePtr = NULL;
+        }
+        Tcl_DecrRefCount(entryPtr->namePtr);
+        ckfree((char *)entryPtr);
+    }
+    profPtr->numEntries = 0;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclProfileEnter()
+ *
+ *  Called by ItclCheckCallMethod, while profiling is on, when a call of
+ *  imPtr starts.  The call is counted when it returns, together with its
+ *  time.
+ * ------------------------------------------------------------------------
+ */
+void
+ItclProfileEnter(
+    ItclObjectInfo *infoPtr,
+    ItclMemberFunc *imPtr)
+{
+    ItclProfile *profPtr = infoPtr->profilePtr;
+    ItclProfileEntry *entryPtr;
+    ItclProfileFrame *framePtr;
+
+    entryPtr = imPtr->profilePtr;
+    if (entryPtr == NULL) {
+        entryPtr = (ItclProfileEntry *)ckalloc(sizeof(ItclProfileEntry));
+        memset(entryPtr, 0, sizeof(ItclProfileEntry));
+        entryPtr->imPtr = imPtr;
+        entryPtr->namePtr = imPtr->fullNamePtr;
+        Tcl_IncrRefCount(entryPtr->namePtr);
+        entryPtr->nextPtr = profPtr->entries;
+        profPtr->entries = entryPtr;
+        profPtr->numEntries++;
+        imPtr->profilePtr = entryPtr;
+    }
+    if (profPtr->numFrames == profPtr->maxFrames) {
+        profPtr->maxFrames = (profPtr->maxFrames == 0) ? 32
+                : 2 * profPtr->maxFrames;
+        profPtr->frames = (ItclProfileFrame *)ckrealloc(
+                (char *)profPtr->frames,
+                profPtr->maxFrames * sizeof(ItclProfileFrame));
+    }
+    framePtr = &profPtr->frames[profPtr->numFrames++];
+    framePtr->entryPtr = entryPtr;
+    framePtr->childTime = 0;
+    framePtr->depth = ++entryPtr->depth;
+    framePtr->start = ProfileNow();
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclProfileLeave()
+ *
+ *  Called by ItclAfterCallMethod, while profiling is on, when a call of
+ *  imPtr returns.  The call is normally the innermost one running; if
+ *  coroutines made calls return out of order, the innermost call of
+ *  imPtr is taken.  Calls started before profiling was turned on, or
+ *  before the last reset, are not found and ignored.  The depth of the
+ *  call counts for maxdepth only now, so that, like the number of calls,
+ *  it leaves out calls that were discarded.
+ * ------------------------------------------------------------------------
+ */
+void
+ItclProfileLeave(
+    ItclObjectInfo *infoPtr,
+    ItclMemberFunc *imPtr)
+{
+    ItclProfile *profPtr = infoPtr->profilePtr;
+    ItclProfileEntry *entryPtr = imPtr->profilePtr;
+    ItclProfileFrame *framePtr;
+    Tcl_WideInt elapsed;
+    int i;
+
+    if (entryPtr == NULL) {
+        return;
+    }
+    for (i = profPtr->numFrames - 1; i >= 0; i--) {
+        if (profPtr->frames[i].entryPtr == entryPtr) {
+            break;
+        }
+    }
+    if (i < 0) {
+        return;
+    }
+    framePtr = &profPtr->frames[i];
+    elapsed = ProfileNow() - framePtr->start;
+    entryPtr->calls++;
+    if (framePtr->depth > entryPtr->maxDepth) {
+        entryPtr->maxDepth = framePtr->depth;
+    }
+    entryPtr->exclusive += elapsed - framePtr->childTime;
+    if (--entryPtr->depth == 0) {
+        entryPtr->inclusive += elapsed;
+    }
+    if (i > 0) {
+        profPtr->frames[i-1].childTime += elapsed;
+    }
+    profPtr->numFrames--;
+    if (i < profPtr->numFrames) {
+        memmove(framePtr, framePtr + 1,
+                (profPtr->numFrames - i) * sizeof(ItclProfileFrame));
+    }
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclProfileForget()
+ *
+ *  Called when a member function is deleted.  Its counters are kept for
+ *  the report, under its name.  A member function is preserved while
+ *  it runs, so its calls normally have returned by now; any still on
+ *  the stack are taken off and not counted, as at "itcl::profile stop",
+ *  since ItclProfileLeave could no longer find them to pop them.
+ * ------------------------------------------------------------------------
+ */
+void
+ItclProfileForget(
+    ItclMemberFunc *imPtr)
+{
+    ItclProfile *profPtr = imPtr->infoPtr->profilePtr;
+    ItclProfileEntry *entryPtr = imPtr->profilePtr;
+    int i;
+    int j;
+
+    j = 0;
+    for (i = 0; i < profPtr->numFrames; i++) {
+        if (profPtr->frames[i].entryPtr == entryPtr) {
+            entryPtr->depth--;
+            continue;
+        }
+        if (j < i) {
+            profPtr->frames[j] = profPtr->frames[i];
+        }
+        j++;
+    }
+    profPtr->numFrames = j;
+    entryPtr->imPtr = NULL;
+    imPtr->profilePtr = NULL;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclDeleteProfile()
+ *
+ *  Frees the profile data.  Called when the interpreter is deleted.
+ * ------------------------------------------------------------------------
+ */
+void
+ItclDeleteProfile(
+    ItclObjectInfo *infoPtr)
+{
+    ItclProfile *profPtr = infoPtr->profilePtr;
+
+    infoPtr->profiling = 0;
+    if (profPtr == NULL) {
+        return;
+    }
+    FreeEntries(profPtr);
+    if (profPtr->frames != NULL) {
+        ckfree((char *)profPtr->frames);
+    }
+    ckfree((char *)profPtr);
+    infoPtr->profilePtr = NULL;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  Itcl_ProfileStartCmd()
+ *
+ *  Invoked by Tcl whenever the user issues an "itcl::profile start"
+ *  command.  Turns profiling on, the counters of earlier runs are kept
+ *  and added to.
+ * ------------------------------------------------------------------------
+ */
+int
+Itcl_ProfileStartCmd(
+    ClientData clientData,   /* infoPtr */
+    Tcl_Interp *interp,      /* current interpreter */
+    int objc,                /* number of arguments */
+    Tcl_Obj *const objv[])   /* argument objects */
+{
+    ItclObjectInfo *infoPtr = (ItclObjectInfo *)clientData;
+
+    ItclShowArgs(1, "Itcl_ProfileStartCmd", objc, objv);
+    if (objc != 1) {
+        Tcl_WrongNumArgs(interp, 1, objv, NULL);
+        return TCL_ERROR;
+    }
+    GetProfile(infoPtr);
+    infoPtr->profiling = 1;
+    return TCL_OK;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  Itcl_ProfileStopCmd()
+ *
+ *  Invoked by Tcl whenever the user issues an "itcl::profile stop"
+ *  command.  Turns profiling off, calls still running are not counted.
+ * ------------------------------------------------------------------------
+ */
+int
+Itcl_ProfileStopCmd(
+    ClientData clientData,   /* infoPtr */
+    Tcl_Interp *interp,      /* current interpreter */
+    int objc,                /* number of arguments */
+    Tcl_Obj *const objv[])   /* argument objects */
+{
+    ItclObjectInfo *infoPtr = (ItclObjectInfo *)clientData;
+
+    ItclShowArgs(1, "Itcl_ProfileStopCmd", objc, objv);
+    if (objc != 1) {
+        Tcl_WrongNumArgs(interp, 1, objv, NULL);
+        return TCL_ERROR;
+    }
+    infoPtr->profiling = 0;
+    if (infoPtr->profilePtr != NULL) {
+        DiscardFrames(infoPtr->profilePtr);
+    }
+    return TCL_OK;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  Itcl_ProfileResetCmd()
+ *
+ *  Invoked by Tcl whenever the user issues an "itcl::profile reset"
+ *  command.  Throws away all counters, profiling stays on if it is.
+ * ------------------------------------------------------------------------
+ */
+int
+Itcl_ProfileResetCmd(
+    ClientData clientData,   /* infoPtr */
+    Tcl_Interp *interp,      /* current interpreter */
+    int objc,                /* number of arguments */
+    Tcl_Obj *const objv[])   /* argument objects */
+{
+    ItclObjectInfo *infoPtr = (ItclObjectInfo *)clientData;
+
+    ItclShowArgs(1, "Itcl_ProfileResetCmd", objc, objv);
+    if (objc != 1) {
+        Tcl_WrongNumArgs(interp, 1, objv, NULL);
+        return TCL_ERROR;
+    }
+    if (infoPtr->profilePtr != NULL) {
+        FreeEntries(infoPtr->profilePtr);
+    }
+    return TCL_OK;
+}
+
+/*
+ *  Sort orders of the report: names ascending, numbers descending and
+ *  equal numbers by name.
+ */
+static int
+CompareNames(
+    const void *a,
+    const void *b)
+{
+    return strcmp(Tcl_GetString((*(ItclProfileEntry **)a)->namePtr),
+            Tcl_GetString((*(ItclProfileEntry **)b)->namePtr));
+}
+
+#define COMPARE_WIDE(x, y) \
+    (((x) < (y)) ? 1 : (((x) > (y)) ? -1 : CompareNames(a, b)))
+
+static int
+CompareCalls(
+    const void *a,
+    const void *b)
+{
+    return COMPARE_WIDE((*(ItclProfileEntry **)a)->calls,
+            (*(ItclProfileEntry **)b)->calls);
+}
+
+static int
+CompareInclusive(
+    const void *a,
+    const void *b)
+{
+    return COMPARE_WIDE((*(ItclProfileEntry **)a)->inclusive,
+            (*(ItclProfileEntry **)b)->inclusive);
+}
+
+static int
+CompareExclusive(
+    const void *a,
+    const void *b)
+{
+    return COMPARE_WIDE((*(ItclProfileEntry **)a)->exclusive,
+            (*(ItclProfileEntry **)b)->exclusive);
+}
+
+static int
+CompareMaxDepth(
+    const void *a,
+    const void *b)
+{
+    return COMPARE_WIDE((*(ItclProfileEntry **)a)->maxDepth,
+            (*(ItclProfileEntry **)b)->maxDepth);
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  AppendCsvName()
+ *
+ *  Appends name to the CSV text in objPtr, quoted if it has to be.
+ * ------------------------------------------------------------------------
+ */
+static void
+AppendCsvName(
+    Tcl_Obj *objPtr,
+    Tcl_Obj *namePtr)
+{
+    const char *name = Tcl_GetString(namePtr);
+    const char *p;
+
+    if (strpbrk(name, ",\"\r\n") == NULL) {
+        Tcl_AppendToObj(objPtr, name, -1);
+        return;
+    }
+    Tcl_AppendToObj(objPtr, "\"", 1);
+    for (p = name; *p != '\0'; p++) {
+        if (*p == '"') {
+            Tcl_AppendToObj(objPtr, "\"", 1);
+        }
+        Tcl_AppendToObj(objPtr, p, 1);
+    }
+    Tcl_AppendToObj(objPtr, "\"", 1);
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  Itcl_ProfileReportCmd()
+ *
+ *  Invoked by Tcl whenever the user issues an "itcl::profile report"
+ *  command.  Handles the following syntax:
+ *
+ *      itcl::profile report ?-sort key? ?-format dict|csv?
+ *
+ *  Returns the counters of all member functions called while profiling
+ *  was on.  The dict format maps each full name to a dict with the keys
+ *  calls, inclusive, exclusive and maxdepth, the csv format has a
+ *  header line and one line per member function.  Times are in
+ *  microseconds.  The default order is by exclusive time, largest
+ *  first.
+ * ------------------------------------------------------------------------
+ */
+int
+Itcl_ProfileReportCmd(
+    ClientData clientData,   /* infoPtr */
+    Tcl_Interp *interp,      /* current interpreter */
+    int objc,                /* number of arguments */
+    Tcl_Obj *const objv[])   /* argument objects */
+{
+    static const char *const options[] = {"-format", "-sort", NULL};
+    static const char *const formats[] = {"csv", "dict", NULL};
+    enum { OPT_FORMAT, OPT_SORT };
+    enum { FORMAT_CSV, FORMAT_DICT };
+    static int (*const compareProcs[])(const void *, const void *) = {
+        CompareNames, CompareCalls, CompareInclusive, CompareExclusive,
+        CompareMaxDepth
+    };
+
+    ItclObjectInfo *infoPtr = (ItclObjectInfo *)clientData;
+    ItclProfile *profPtr = infoPtr->profilePtr;
+    ItclProfileEntry **entryPtrs;
+    ItclProfileEntry *entryPtr;
+    Tcl_Obj *resultPtr;
+    Tcl_Obj *rowPtr;
+    int sortKey = KEY_EXCLUSIVE;
+    int format = FORMAT_DICT;
+    int numEntries;
+    int option;
+    int i;
+
+    ItclShowArgs(1, "Itcl_ProfileReportCmd", objc, objv);
+    if ((objc % 2) == 0) {
+        Tcl_WrongNumArgs(interp, 1, objv, "?-sort key? ?-format dict|csv?");
+        return TCL_ERROR;
+    }
+    for (i = 1; i < objc; i += 2) {
+        if (Tcl_GetIndexFromObj(interp, objv[i], options, "option", 0,
+                &option) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        if (option == OPT_SORT) {
+            if (Tcl_GetIndexFromObj(interp, objv[i+1], reportKeys,
+                    "sort key", 0, &sortKey) != TCL_OK) {
+                return TCL_ERROR;
+            }
+        } else if (Tcl_GetIndexFromObj(interp, objv[i+1], formats,
+                "format", 0, &format) != TCL_OK) {
+            return TCL_ERROR;
+        }
+    }
+
+    numEntries = (profPtr == NULL) ? 0 : profPtr->numEntries;
+    entryPtrs = (ItclProfileEntry **)ckalloc(
+            (numEntries + 1) * sizeof(ItclProfileEntry *));
+    i = 0;
+    if (profPtr != NULL) {
+        for (entryPtr = profPtr->entries; entryPtr != NULL;
+                entryPtr = entryPtr->nextPtr) {
+            entryPtrs[i++] = entryPtr;
+        }
+    }
+    qsort(entryPtrs, numEntries, sizeof(ItclProfileEntry *),
+            compareProcs[sortKey]);
+
+    if (format == FORMAT_CSV) {
+        resultPtr = Tcl_NewStringObj(
+                "name,calls,inclusive,exclusive,maxdepth\n", -1);
+        for (i = 0; i < numEntries; i++) {
+            entryPtr = entryPtrs[i];
+            AppendCsvName(resultPtr, entryPtr->namePtr);
+            Tcl_AppendPrintfToObj(resultPtr, ",%" TCL_LL_MODIFIER "d"
+                    ",%.3f,%.3f,%d\n", entryPtr->calls,
+                    entryPtr->inclusive / 1000.0,
+                    entryPtr->exclusive / 1000.0, entryPtr->maxDepth);
+        }
+    } else {
+        resultPtr = Tcl_NewDictObj();
+        for (i = 0; i < numEntries; i++) {
+            entryPtr = entryPtrs[i];
+            rowPtr = Tcl_NewDictObj();
+            Tcl_DictObjPut(NULL, rowPtr,
+                    Tcl_NewStringObj(reportKeys[KEY_CALLS], -1),
+                    Tcl_NewWideIntObj(entryPtr->calls));
+            Tcl_DictObjPut(NULL, rowPtr,
+                    Tcl_NewStringObj(reportKeys[KEY_INCLUSIVE], -1),
+                    Tcl_NewDoubleObj(entryPtr->inclusive / 1000.0));
+            Tcl_DictObjPut(NULL, rowPtr,
+                    Tcl_NewStringObj(reportKeys[KEY_EXCLUSIVE], -1),
+                    Tcl_NewDoubleObj(entryPtr->exclusive / 1000.0));
+            Tcl_DictObjPut(NULL, rowPtr,
+                    Tcl_NewStringObj(reportKeys[KEY_MAXDEPTH], -1),
+                    Tcl_NewIntObj(entryPtr->maxDepth));
+            Tcl_DictObjPut(NULL, resultPtr, entryPtr->namePtr, rowPtr);
+        }
+    }
+    ckfree((char *)entryPtrs);
+    Tcl_SetObjResult(interp, resultPtr);
+    return TCL_OK;
+}
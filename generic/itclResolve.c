@@ -64,11 +64,10 @@ Itcl_ClassCmdResolver(
     Tcl_Command *rPtr)		/* returns: resolved command */
 {
     Tcl_HashEntry *hPtr;
-    Tcl_Obj *objPtr;
-    Tcl_Obj *namePtr;
     ItclClass *iclsPtr;
     ItclObjectInfo *infoPtr;
     ItclMemberFunc *imPtr;
+    ItclCmdLookup *clookup;
     int inOptionHandling;
     int isCmdDeleted;
 
@@ -77,76 +76,25 @@ Itcl_ClassCmdResolver(
     }
     infoPtr = (ItclObjectInfo *)Tcl_GetAssocData(interp,
                 ITCL_INTERP_DATA, NULL);
-    hPtr = Tcl_FindHashEntry(&infoPtr->namespaceClasses, (char *)nsPtr);
-    if (hPtr == NULL) {
+    iclsPtr = ItclNamespaceClass(infoPtr, nsPtr);
+    if (iclsPtr == NULL) {
         return TCL_CONTINUE;
     }
-    iclsPtr = (ItclClass *)Tcl_GetHashValue(hPtr);
     /*
-     *  If the command is a member function
+     *  If the command is a member function (or a delegated function
+     *  of an extendedclass, which is entered as its "unknown" method).
      */
-    imPtr = NULL;
-    objPtr = Tcl_NewStringObj(name, -1);
-    hPtr = Tcl_FindHashEntry(&iclsPtr->resolveCmds, (char *)objPtr);
-    Tcl_DecrRefCount(objPtr);
+    hPtr = Tcl_FindHashEntry(&iclsPtr->resolveCmdNames, name);
     if (hPtr == NULL) {
-	ItclCmdLookup *clookup;
-	if ((iclsPtr->flags & ITCL_ECLASS)) {
-	    namePtr = Tcl_NewStringObj(name, -1);
-	    hPtr = Tcl_FindHashEntry(&iclsPtr->delegatedFunctions,
-	            (char *)namePtr);
-	    if (hPtr != NULL) {
-                objPtr = Tcl_NewStringObj("unknown", -1);
-                hPtr = Tcl_FindHashEntry(&iclsPtr->resolveCmds, (char *)objPtr);
-                Tcl_DecrRefCount(objPtr);
-	    }
-	    Tcl_DecrRefCount(namePtr);
-	}
-        if (hPtr == NULL) {
-            return TCL_CONTINUE;
-        }
-        clookup = (ItclCmdLookup *)Tcl_GetHashValue(hPtr);
-        imPtr = clookup->imPtr;
-    } else {
-        ItclCmdLookup *clookup;
-        clookup = (ItclCmdLookup *)Tcl_GetHashValue(hPtr);
-        imPtr = clookup->imPtr;
+        return TCL_CONTINUE;
     }
+    clookup = (ItclCmdLookup *)Tcl_GetHashValue(hPtr);
+    imPtr = clookup->imPtr;
 
     if (iclsPtr->flags & (ITCL_TYPE|ITCL_WIDGET|ITCL_WIDGETADAPTOR)) {
 	/* FIXME check if called from an (instance) method (not from a typemethod) and only then error */
-	int isOk = 0;
-	if (strcmp(name, "info") == 0) {
-	    isOk = 1;
-	}
-	if (strcmp(name, "mytypemethod") == 0) {
-	    isOk = 1;
-	}
-	if (strcmp(name, "myproc") == 0) {
-	    isOk = 1;
-	}
-	if (strcmp(name, "mymethod") == 0) {
-	    isOk = 1;
-	}
-	if (strcmp(name, "mytypevar") == 0) {
-	    isOk = 1;
-	}
-	if (strcmp(name, "myvar") == 0) {
-	    isOk = 1;
-	}
-	if (strcmp(name, "itcl_hull") == 0) {
-	    isOk = 1;
-	}
-	if (strcmp(name, "callinstance") == 0) {
-	    isOk = 1;
-	}
-	if (strcmp(name, "getinstancevar") == 0) {
-	    isOk = 1;
-	}
-	if (strcmp(name, "installcomponent") == 0) {
-	    isOk = 1;
-	}
-	if (! isOk) {
+	if (!(imPtr->flags & ITCL_TYPE_RESOLVABLE)
+	        || (strcmp(name, Tcl_GetString(imPtr->namePtr)) != 0)) {
 	    if ((imPtr->flags & ITCL_TYPE_METHOD) != 0) {
 	        Tcl_AppendResult(interp, "invalid command name \"", name,
 	                 "\"", NULL);
@@ -245,6 +193,7 @@ Itcl_ClassVarResolver(
     ItclClass *iclsPtr;
     ItclObject *contextIoPtr;
     Tcl_HashEntry *hPtr;
+    Tcl_Var objVarPtr;
     ItclVarLookup *vlookup;
 
     contextIoPtr = NULL;
@@ -267,11 +216,10 @@ Itcl_ClassVarResolver(
 
     infoPtr = (ItclObjectInfo *)Tcl_GetAssocData(interp,
                 ITCL_INTERP_DATA, NULL);
-    hPtr = Tcl_FindHashEntry(&infoPtr->namespaceClasses, (char *)nsPtr);
-    if (hPtr == NULL) {
+    iclsPtr = ItclNamespaceClass(infoPtr, nsPtr);
+    if (iclsPtr == NULL) {
         return TCL_CONTINUE;
     }
-    iclsPtr = (ItclClass *)Tcl_GetHashValue(hPtr);
 
     /*
      *  See if the variable is a known data member and accessible.
@@ -322,10 +270,9 @@ Itcl_ClassVarResolver(
                 }
             }
         }
-        hPtr = Tcl_FindHashEntry(&contextIoPtr->objectVariables,
-                (char *)vlookup->ivPtr);
+        objVarPtr = ItclGetObjectVar(contextIoPtr, vlookup->ivPtr);
 
-    if (hPtr == NULL) {
+    if (objVarPtr == NULL) {
         return TCL_CONTINUE;
     }
     if (strcmp(name, "this") == 0) {
@@ -383,11 +330,8 @@ Itcl_ClassVarResolver(
 	    return TCL_OK;
         }
     }
-    if (hPtr != NULL) {
-        *rPtr = (Tcl_Var)Tcl_GetHashValue(hPtr);
-        return TCL_OK;
-    }
-    return TCL_CONTINUE;
+    *rPtr = objVarPtr;
+    return TCL_OK;
 }
 
 
@@ -428,11 +372,10 @@ Itcl_ClassCompiledVarResolver(
 
     infoPtr = (ItclObjectInfo *)Tcl_GetAssocData(interp,
                 ITCL_INTERP_DATA, NULL);
-    hPtr = Tcl_FindHashEntry(&infoPtr->namespaceClasses, (char *)nsPtr);
-    if (hPtr == NULL) {
+    iclsPtr = ItclNamespaceClass(infoPtr, nsPtr);
+    if (iclsPtr == NULL) {
         return TCL_CONTINUE;
     }
-    iclsPtr = (ItclClass *)Tcl_GetHashValue(hPtr);
     /*
      *  Copy the name to local storage so we can NULL terminate it.
      *  If the name is long, allocate extra space for it.
@@ -499,6 +442,7 @@ ItclClassRuntimeVarResolver(
     ItclClass *iclsPtr;
     ItclObject *contextIoPtr;
     Tcl_HashEntry *hPtr;
+    Tcl_Var objVarPtr;
 
     /*
      *  If this is a common data member, then the associated
@@ -536,8 +480,7 @@ ItclClassRuntimeVarResolver(
 	        }
 	    }
         }
-        hPtr = Tcl_FindHashEntry(&contextIoPtr->objectVariables,
-                (char *)vlookup->ivPtr);
+        objVarPtr = ItclGetObjectVar(contextIoPtr, vlookup->ivPtr);
         if (strcmp(Tcl_GetString(vlookup->ivPtr->namePtr), "this") == 0) {
             Tcl_Var varPtr;
             Tcl_DString buffer;
@@ -594,10 +537,7 @@ ItclClassRuntimeVarResolver(
 	        return varPtr;
             }
         }
-        if (hPtr != NULL) {
-            return (Tcl_Var)Tcl_GetHashValue(hPtr);
-        }
-    return NULL;
+    return objVarPtr;
 }
 
 /*
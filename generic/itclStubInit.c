@@ -237,6 +237,7 @@ const ItclStubs itclStubs = {
     Itcl_DiscardInterpState, /* 25 */
     Itcl_Alloc, /* 26 */
     Itcl_Free, /* 27 */
+    Itcl_GetScopedVar, /* 28 */
 };
 
 /* !END!: Do not edit above this line. */
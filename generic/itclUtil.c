@@ -30,12 +30,24 @@
  */
 #include "itclInt.h"
 #include <limits.h>
+#include <stdlib.h>
 
 /*
  *  POOL OF LIST ELEMENTS FOR LINKED LIST
+ *
+ *  Each thread keeps its own pool, so that interpreters running in
+ *  different threads never share it.
  */
-static Itcl_ListElem *listPool = NULL;
-static int listPoolLen = 0;
+typedef struct ThreadSpecificData {
+    Itcl_ListElem *listPool;        /* unused list elements */
+    int listPoolLen;                /* number of elements in listPool */
+    int initialized;                /* set once the exit handler that
+                                     * frees the pool is registered */
+} ThreadSpecificData;
+
+static Tcl_ThreadDataKey dataKey;
+
+static Tcl_ExitProc FreeListPool;
 
 #define ITCL_VALID_LIST 0x01face10  /* magic bit pattern for validation */
 #define ITCL_LIST_POOL_SIZE 200     /* max number of elements in listPool */
@@ -263,12 +275,14 @@ Itcl_ListElem*
 Itcl_CreateListElem(
     Itcl_List *listPtr)     /* list that will contain this new element */
 {
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
+            Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
     Itcl_ListElem *elemPtr;
 
-    if (listPoolLen > 0) {
-        elemPtr = listPool;
-        listPool = elemPtr->next;
-        --listPoolLen;
+    if (tsdPtr->listPoolLen > 0) {
+        elemPtr = tsdPtr->listPool;
+        tsdPtr->listPool = elemPtr->next;
+        --tsdPtr->listPoolLen;
     } else {
         elemPtr = (Itcl_ListElem*)ckalloc((unsigned)sizeof(Itcl_ListElem));
     }
@@ -293,6 +307,8 @@ Itcl_ListElem*
 Itcl_DeleteListElem(
     Itcl_ListElem *elemPtr)     /* list element to be deleted */
 {
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
+            Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
     Itcl_List *listPtr;
     Itcl_ListElem *nextPtr;
 
@@ -314,10 +330,14 @@ Itcl_DeleteListElem(
     }
     --listPtr->num;
 
-    if (listPoolLen < ITCL_LIST_POOL_SIZE) {
-        elemPtr->next = listPool;
-        listPool = elemPtr;
-        ++listPoolLen;
+    if (tsdPtr->listPoolLen < ITCL_LIST_POOL_SIZE) {
+        if (!tsdPtr->initialized) {
+            tsdPtr->initialized = 1;
+            Tcl_CreateThreadExitHandler(FreeListPool, NULL);
+        }
+        elemPtr->next = tsdPtr->listPool;
+        tsdPtr->listPool = elemPtr;
+        ++tsdPtr->listPoolLen;
     } else {
         ckfree((char*)elemPtr);
     }
@@ -498,24 +518,42 @@ Itcl_SetListValue(
  * ------------------------------------------------------------------------
  *  Itcl_FinishList()
  *
- *  free all memory used in the list pool
+ *  free all memory used in the list pool of the current thread
  * ------------------------------------------------------------------------
  */
 void
 Itcl_FinishList()
 {
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
+            Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
     Itcl_ListElem *listPtr;
     Itcl_ListElem *elemPtr;
 
-    listPtr = listPool;
+    listPtr = tsdPtr->listPool;
     while (listPtr != NULL) {
         elemPtr = listPtr;
 	listPtr = elemPtr->next;
 	ckfree((char *)elemPtr);
         elemPtr = NULL;
     }
-    listPool = NULL;
-    listPoolLen = 0;
+    tsdPtr->listPool = NULL;
+    tsdPtr->listPoolLen = 0;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  FreeListPool()
+ *
+ *  Thread exit handler, frees the list pool of the exiting thread.
+ * ------------------------------------------------------------------------
+ */
+static void
+FreeListPool(
+    ClientData clientData)
+{
+    (void)clientData;
+
+    Itcl_FinishList();
 }
 
 
@@ -685,6 +723,425 @@ void Itcl_Free(void *ptr) {
     assert(blk->freeProc == NULL); /* it should be released */
     ckfree(blk);
 }
+
+/*
+ * ========================================================================
+ *  RECORD POOLS
+ *
+ *  Objects and classes carry a number of small fixed size records
+ *  (resolver info, lookup entries, call contexts, ...).  The procedures
+ *  below carve them from per-interpreter pools, one for each multiple
+ *  of ITCL_POOL_GRANULE, so that creating and destroying objects does
+ *  not go to ckalloc for each of them.  Released records are kept on
+ *  the free list of their pool.  Once a pool holds many more free
+ *  records than it hands out, the chunks without any record in use are
+ *  given back (see TrimPool()); the rest is released when the
+ *  ItclObjectInfo of the interpreter is deleted.
+ *
+ *  Building with PURIFY defined bypasses the pools, which keeps memory
+ *  debuggers useful.
+ */
+
+typedef struct ItclPoolChunk {
+    struct ItclPoolChunk *nextPtr;  /* next block of the same pool */
+    int numFree;                    /* free records in the block, only
+                                     * valid while trimming */
+} ItclPoolChunk;
+
+/*
+ *  Records start ITCL_POOL_GRANULE bytes into a chunk, so they are
+ *  aligned as well as anything ckalloc returns.
+ */
+#define ITCL_POOL_CHUNK_HEADER ITCL_POOL_GRANULE
+
+/*
+ *  A pool is not trimmed before it has this many chunks worth of free
+ *  records.
+ */
+#define ITCL_POOL_TRIM_CHUNKS 2
+
+static int
+ChunkRecords(
+    size_t recSize)
+{
+    int numRecords;
+
+    numRecords = (ITCL_POOL_CHUNK_SIZE - ITCL_POOL_CHUNK_HEADER) / recSize;
+    if (numRecords < 4) {
+        numRecords = 4;
+    }
+    return numRecords;
+}
+
+static ItclPool *
+GetPool(
+    ItclObjectInfo *infoPtr,
+    size_t size,
+    size_t *recSizePtr)
+{
+    size_t idx;
+
+    *recSizePtr = size;
+#ifdef PURIFY
+    return NULL;
+#else
+    idx = (size == 0) ? 0 : (size - 1) / ITCL_POOL_GRANULE;
+    if (idx >= ITCL_POOL_NUM_SIZES) {
+        return NULL;
+    }
+    *recSizePtr = (idx + 1) * ITCL_POOL_GRANULE;
+    return &infoPtr->pools[idx];
+#endif
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclPoolAlloc()
+ *
+ *  Returns zero-initialized memory for a record of the given size,
+ *  taken from the matching pool of the interpreter.  The record must
+ *  be given back with ItclPoolFree() using the same size.
+ * ------------------------------------------------------------------------
+ */
+void *
+ItclPoolAlloc(
+    ItclObjectInfo *infoPtr,    /* info for the interpreter */
+    size_t size)                /* size of the record */
+{
+    ItclPool *poolPtr;
+    ItclPoolChunk *chunkPtr;
+    size_t recSize;
+    char *recPtr;
+    void *ptr;
+    int numRecords;
+
+    poolPtr = GetPool(infoPtr, size, &recSize);
+    if (poolPtr == NULL) {
+        ptr = ckalloc(size);
+        memset(ptr, 0, size);
+        return ptr;
+    }
+
+    if (poolPtr->freePtr == NULL) {
+        numRecords = ChunkRecords(recSize);
+        chunkPtr = (ItclPoolChunk *)ckalloc(ITCL_POOL_CHUNK_HEADER
+                + numRecords * recSize);
+        chunkPtr->nextPtr = poolPtr->chunksPtr;
+        poolPtr->chunksPtr = chunkPtr;
+        poolPtr->numChunks++;
+        poolPtr->trimLimit = 0;
+        poolPtr->numRecords += numRecords;
+
+        /*
+         *  Thread the new records onto the free list, lowest address
+         *  first.
+         */
+        recPtr = (char *)chunkPtr + ITCL_POOL_CHUNK_HEADER
+                + numRecords * recSize;
+        while (numRecords-- > 0) {
+            recPtr -= recSize;
+            *(void **)recPtr = poolPtr->freePtr;
+            poolPtr->freePtr = recPtr;
+        }
+    }
+
+    ptr = poolPtr->freePtr;
+    poolPtr->freePtr = *(void **)ptr;
+    poolPtr->numInUse++;
+    poolPtr->numAllocs++;
+    memset(ptr, 0, recSize);
+    return ptr;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  TrimPool()
+ *
+ *  Gives the chunks of a pool that have no record in use back to the
+ *  system.  The chunks are sorted by address so that the chunk of each
+ *  free record can be found with a binary search; the free list is then
+ *  rebuilt without the records of the empty chunks.
+ *
+ *  Records left free in chunks that are still partly used raise the
+ *  trim limit of the pool: it is not trimmed again before half as many
+ *  records as are in use plus ITCL_POOL_TRIM_CHUNKS chunks worth were
+ *  freed on top of them, so the cost of a trim is spread over the frees
+ *  that led to it.  The limit is reset when the pool has to grow again.
+ * ------------------------------------------------------------------------
+ */
+static int
+CompareChunks(
+    const void *a,
+    const void *b)
+{
+    const char *aPtr = *(const char *const *)a;
+    const char *bPtr = *(const char *const *)b;
+
+    return (aPtr < bPtr) ? -1 : (aPtr > bPtr);
+}
+
+static ItclPoolChunk *
+FindChunk(
+    ItclPoolChunk **chunks,
+    int numChunks,
+    size_t chunkBytes,
+    const char *recPtr)
+{
+    int lo = 0;
+    int hi = numChunks - 1;
+    int mid;
+
+    while (lo <= hi) {
+        mid = (lo + hi) / 2;
+        if (recPtr < (char *)chunks[mid]) {
+            hi = mid - 1;
+        } else if (recPtr >= (char *)chunks[mid] + chunkBytes) {
+            lo = mid + 1;
+        } else {
+            return chunks[mid];
+        }
+    }
+    assert(0); /* every free record belongs to a chunk of its pool */
+    return NULL;
+}
+
+static void
+TrimPool(
+    ItclPool *poolPtr,          /* pool to be trimmed */
+    size_t recSize)             /* size of its records */
+{
+    ItclPoolChunk **chunks;
+    ItclPoolChunk *chunkPtr;
+    ItclPoolChunk **prevChunkPtr;
+    void **prevPtr;
+    void *recPtr;
+    size_t chunkBytes;
+    int numRecords;
+    int i;
+
+    numRecords = ChunkRecords(recSize);
+    chunkBytes = ITCL_POOL_CHUNK_HEADER + numRecords * recSize;
+
+    chunks = (ItclPoolChunk **)ckalloc(
+            poolPtr->numChunks * sizeof(ItclPoolChunk *));
+    i = 0;
+    for (chunkPtr = poolPtr->chunksPtr; chunkPtr != NULL;
+            chunkPtr = chunkPtr->nextPtr) {
+        chunkPtr->numFree = 0;
+        chunks[i++] = chunkPtr;
+    }
+    qsort(chunks, poolPtr->numChunks, sizeof(ItclPoolChunk *),
+            CompareChunks);
+
+    for (recPtr = poolPtr->freePtr; recPtr != NULL;
+            recPtr = *(void **)recPtr) {
+        FindChunk(chunks, poolPtr->numChunks, chunkBytes,
+                (char *)recPtr)->numFree++;
+    }
+
+    /*
+     *  Unlink the records of the empty chunks from the free list,
+     *  keeping the order of the others.
+     */
+    prevPtr = &poolPtr->freePtr;
+    while (*prevPtr != NULL) {
+        recPtr = *prevPtr;
+        chunkPtr = FindChunk(chunks, poolPtr->numChunks, chunkBytes,
+                (char *)recPtr);
+        if (chunkPtr->numFree == numRecords) {
+            *prevPtr = *(void **)recPtr;
+        } else {
+            prevPtr = (void **)recPtr;
+        }
+    }
+    ckfree(chunks);
+
+    prevChunkPtr = &poolPtr->chunksPtr;
+    while (*prevChunkPtr != NULL) {
+        chunkPtr = *prevChunkPtr;
+        if (chunkPtr->numFree == numRecords) {
+            *prevChunkPtr = chunkPtr->nextPtr;
+            poolPtr->numChunks--;
+            poolPtr->numRecords -= numRecords;
+            ckfree(chunkPtr);
+        } else {
+            prevChunkPtr = &chunkPtr->nextPtr;
+        }
+    }
+
+    poolPtr->trimLimit = poolPtr->numRecords - poolPtr->numInUse
+            + poolPtr->numInUse / 2 + ITCL_POOL_TRIM_CHUNKS * numRecords;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclPoolFree()
+ *
+ *  Gives a record obtained from ItclPoolAlloc() back to its pool.  When
+ *  the pool then holds more free records than in use, more than
+ *  ITCL_POOL_TRIM_CHUNKS chunks worth and more than its trim limit,
+ *  the chunks that are entirely free are released.
+ * ------------------------------------------------------------------------
+ */
+void
+ItclPoolFree(
+    ItclObjectInfo *infoPtr,    /* info for the interpreter */
+    void *ptr,                  /* record to be freed */
+    size_t size)                /* size passed to ItclPoolAlloc */
+{
+    ItclPool *poolPtr;
+    size_t recSize;
+    int numFree;
+
+    if (ptr == NULL) {
+        return;
+    }
+    poolPtr = GetPool(infoPtr, size, &recSize);
+    if (poolPtr == NULL) {
+        ckfree(ptr);
+        return;
+    }
+    assert(poolPtr->numInUse > 0);
+    *(void **)ptr = poolPtr->freePtr;
+    poolPtr->freePtr = ptr;
+    poolPtr->numInUse--;
+
+    numFree = poolPtr->numRecords - poolPtr->numInUse;
+    if (numFree > poolPtr->numInUse && numFree > poolPtr->trimLimit
+            && numFree > ITCL_POOL_TRIM_CHUNKS * ChunkRecords(recSize)) {
+        TrimPool(poolPtr, recSize);
+    }
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclPoolAllocPreservable()
+ *
+ *  Like Itcl_Alloc(), but the memory comes from the record pools.  The
+ *  result can be handed to Itcl_PreserveData() and friends.  It must be
+ *  freed with ItclPoolFreePreservable() rather than Itcl_Free().
+ * ------------------------------------------------------------------------
+ */
+void *
+ItclPoolAllocPreservable(
+    ItclObjectInfo *infoPtr,    /* info for the interpreter */
+    size_t size)                /* size of the record */
+{
+    PresMemoryPrefix *blk;
+
+    blk = (PresMemoryPrefix *)ItclPoolAlloc(infoPtr,
+            size + sizeof(PresMemoryPrefix));
+    return blk+1;
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclPoolFreePreservable()
+ *
+ *  Releases memory from ItclPoolAllocPreservable() that is no longer
+ *  preserved.
+ * ------------------------------------------------------------------------
+ */
+void
+ItclPoolFreePreservable(
+    ItclObjectInfo *infoPtr,    /* info for the interpreter */
+    void *ptr,                  /* record to be freed */
+    size_t size)                /* size passed to ItclPoolAllocPreservable */
+{
+    PresMemoryPrefix *blk;
+
+    if (ptr == NULL) {
+        return;
+    }
+    blk = ((PresMemoryPrefix *)ptr)-1;
+
+    assert(blk->refCount == 0); /* it should be not preserved */
+    assert(blk->freeProc == NULL); /* it should be released */
+    ItclPoolFree(infoPtr, blk, size + sizeof(PresMemoryPrefix));
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclDeletePools()
+ *
+ *  Gives the memory of all record pools back to the system.  Called
+ *  when the interpreter's ItclObjectInfo is deleted; no pooled record
+ *  may be in use by then.
+ * ------------------------------------------------------------------------
+ */
+void
+ItclDeletePools(
+    ItclObjectInfo *infoPtr)    /* info for the interpreter */
+{
+    ItclPool *poolPtr;
+    ItclPoolChunk *chunkPtr;
+    int i;
+
+    for (i = 0; i < ITCL_POOL_NUM_SIZES; i++) {
+        poolPtr = &infoPtr->pools[i];
+        while (poolPtr->chunksPtr != NULL) {
+            chunkPtr = poolPtr->chunksPtr;
+            poolPtr->chunksPtr = chunkPtr->nextPtr;
+            ckfree(chunkPtr);
+        }
+        memset(poolPtr, 0, sizeof(ItclPool));
+    }
+}
+
+/*
+ * ------------------------------------------------------------------------
+ *  ItclPoolsCmd()
+ *
+ *  Invoked by Tcl to report the occupancy of the record pools:
+ *
+ *    ::itcl::internal::commands::pools
+ *
+ *  Returns a dictionary keyed by record size.  Each value is a
+ *  dictionary with the number of chunks, of records carved from them,
+ *  of records in use and free, and of allocations served so far.
+ *  Pools that were never used are left out.
+ * ------------------------------------------------------------------------
+ */
+int
+ItclPoolsCmd(
+    ClientData clientData,   /* info for the interpreter */
+    Tcl_Interp *interp,      /* current interpreter */
+    int objc,                /* number of arguments */
+    Tcl_Obj *const objv[])   /* argument objects */
+{
+    ItclObjectInfo *infoPtr = (ItclObjectInfo *)clientData;
+    ItclPool *poolPtr;
+    Tcl_Obj *resultPtr;
+    Tcl_Obj *poolObj;
+    int i;
+
+    if (objc != 1) {
+        Tcl_WrongNumArgs(interp, 1, objv, "");
+        return TCL_ERROR;
+    }
+    resultPtr = Tcl_NewDictObj();
+    for (i = 0; i < ITCL_POOL_NUM_SIZES; i++) {
+        poolPtr = &infoPtr->pools[i];
+        if (poolPtr->numChunks == 0) {
+            continue;
+        }
+        poolObj = Tcl_NewDictObj();
+        Tcl_DictObjPut(NULL, poolObj, Tcl_NewStringObj("chunks", -1),
+                Tcl_NewIntObj(poolPtr->numChunks));
+        Tcl_DictObjPut(NULL, poolObj, Tcl_NewStringObj("records", -1),
+                Tcl_NewIntObj(poolPtr->numRecords));
+        Tcl_DictObjPut(NULL, poolObj, Tcl_NewStringObj("inuse", -1),
+                Tcl_NewIntObj(poolPtr->numInUse));
+        Tcl_DictObjPut(NULL, poolObj, Tcl_NewStringObj("free", -1),
+                Tcl_NewIntObj(poolPtr->numRecords - poolPtr->numInUse));
+        Tcl_DictObjPut(NULL, poolObj, Tcl_NewStringObj("allocs", -1),
+                Tcl_NewWideIntObj(poolPtr->numAllocs));
+        Tcl_DictObjPut(NULL, resultPtr,
+                Tcl_NewIntObj((i + 1) * ITCL_POOL_GRANULE), poolObj);
+    }
+    Tcl_SetObjResult(interp, resultPtr);
+    return TCL_OK;
+}
 
 /*
  * ------------------------------------------------------------------------
@@ -887,7 +1344,6 @@ Itcl_CanAccess2(
     Tcl_Namespace* fromNsPtr)  /* namespace requesting access */
 {
     ItclClass* fromIclsPtr;
-    Tcl_HashEntry *entry;
 
     /*
      *  If the protection level is "public" or "private", then the
@@ -897,12 +1353,8 @@ Itcl_CanAccess2(
         return 1;
     } else {
         if (protection == ITCL_PRIVATE) {
-	    entry = Tcl_FindHashEntry(&iclsPtr->infoPtr->namespaceClasses,
-		fromNsPtr);
-	    if (entry == NULL) {
-		return 0;
-	    }
-	    return (iclsPtr == Tcl_GetHashValue(entry));
+	    return (iclsPtr == ItclNamespaceClass(iclsPtr->infoPtr,
+	            fromNsPtr));
         }
     }
 
@@ -913,20 +1365,9 @@ Itcl_CanAccess2(
      */
     assert (protection == ITCL_PROTECTED);
 
-    if (Itcl_IsClassNamespace(fromNsPtr)) {
-	entry = Tcl_FindHashEntry(&iclsPtr->infoPtr->namespaceClasses,
-		fromNsPtr);
-	if (entry == NULL) {
-	    return 0;
-	}
-	fromIclsPtr = (ItclClass *)Tcl_GetHashValue(entry);
-
-        entry = Tcl_FindHashEntry(&fromIclsPtr->heritage,
-	        (char*)iclsPtr);
-
-        if (entry) {
-            return 1;
-        }
+    fromIclsPtr = ItclNamespaceClass(iclsPtr->infoPtr, fromNsPtr);
+    if (fromIclsPtr != NULL) {
+        return ItclClassIsa(fromIclsPtr, iclsPtr);
     }
     return 0;
 }
@@ -992,19 +1433,14 @@ Itcl_CanAccessFunc(
      *  is one, then this method overrides it, and the base class
      *  has access.
      */
-    if ((imPtr->flags & ITCL_COMMON) == 0 &&
-            Itcl_IsClassNamespace(fromNsPtr)) {
-        Tcl_HashEntry *hPtr;
-
+    if ((imPtr->flags & ITCL_COMMON) == 0) {
         iclsPtr = imPtr->iclsPtr;
-	hPtr = Tcl_FindHashEntry(&iclsPtr->infoPtr->namespaceClasses,
-	        (char *)fromNsPtr);
-	if (hPtr == NULL) {
+        fromIclsPtr = ItclNamespaceClass(iclsPtr->infoPtr, fromNsPtr);
+	if (fromIclsPtr == NULL) {
 	    return 0;
 	}
-        fromIclsPtr = (ItclClass *)Tcl_GetHashValue(hPtr);
 
-        if (Tcl_FindHashEntry(&iclsPtr->heritage, (char*)fromIclsPtr)) {
+        if (ItclClassIsa(iclsPtr, fromIclsPtr)) {
             entry = Tcl_FindHashEntry(&fromIclsPtr->resolveCmds,
                 (char *)imPtr->namePtr);
 
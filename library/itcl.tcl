@@ -18,25 +18,6 @@ proc ::itcl::delete_helper { name args } {
     ::itcl::delete object $name
 }
 
-# ----------------------------------------------------------------------
-#  USAGE:  local <className> <objName> ?<arg> <arg>...?
-#
-#  Creates a new object called <objName> in class <className>, passing
-#  the remaining <arg>'s to the constructor.  Unlike the usual
-#  [incr Tcl] objects, however, an object created by this procedure
-#  will be automatically deleted when the local call frame is destroyed.
-#  This command is useful for creating objects that should only remain
-#  alive until a procedure exits.
-# ----------------------------------------------------------------------
-proc ::itcl::local {class name args} {
-    set ptr [uplevel [list $class $name] $args]
-    uplevel [list set itcl-local-$ptr $ptr]
-    set cmd [uplevel namespace which -command $ptr]
-    uplevel [list trace variable itcl-local-$ptr u \
-        "::itcl::delete_helper $cmd"]
-    return $ptr
-}
-
 # ----------------------------------------------------------------------
 # auto_mkindex
 # ----------------------------------------------------------------------
@@ -180,7 +180,736 @@ proc test-obj-instance {{reptime 1000}} {
 
 # ------------------------------------------------------------------------
 
-proc test {{reptime 1000}} {
+# deep class hierarchy (10 levels, traversed via the hierarchy iterator):
+proc test-deep-hier {{reptime 1000}} {
+  _test_start $reptime
+  itcl::class timeDeep0 {
+    public variable v0 0
+    method m {} {}
+  }
+  for {set i 1} {$i < 10} {incr i} {
+    itcl::class timeDeep$i "
+      inherit timeDeep[expr {$i-1}]
+      public variable v$i 0
+    "
+  }
+  _test_run $reptime {
+    setup {set i 0; timeDeep9 o}
+    # create + delete object:
+    {timeDeep9 x; itcl::delete object x}
+    # configure base class option:
+    {o configure -v0 1}
+    # cget base class option:
+    {o cget -v0}
+    # info heritage:
+    {o info heritage}
+    # isa base class:
+    {o isa timeDeep0}
+    cleanup {itcl::delete object o}
+  }
+  itcl::delete class timeDeep0
+  _test_out_total
+}
+
+# ------------------------------------------------------------------------
+
+# delete populated class (while many objects of other classes exist):
+proc test-cls-delete {{reptime {3000 20}}} {
+  _test_start $reptime
+  itcl::class timeDelOther {}
+  for {set i 0} {$i < 20000} {incr i} {timeDelOther ::timeDelOther$i}
+  _test_run $reptime {
+    # define class, create 2000 instances, delete class:
+    {itcl::class timeDelClass {}
+     for {set i 0} {$i < 2000} {incr i} {timeDelClass ::timeDelObj$i}
+     itcl::delete class timeDelClass}
+  }
+  itcl::delete class timeDelOther
+  _test_out_total
+}
+
+# class definition with a deep hierarchy of many methods:
+proc test-cls-define {{reptime {3000 10}}} {
+  _test_start $reptime
+  namespace eval ::timeDef::ns {}
+  set body {}
+  for {set i 0} {$i < 100} {incr i} {
+    append body "method m$i {} {}\n"
+  }
+  itcl::class ::timeDef::ns::Base $body
+  proc ::timeDef::chain {} {
+    set prev ::timeDef::ns::Base
+    for {set i 0} {$i < 30} {incr i} {
+      itcl::class ::timeDef::ns::D$i "inherit $prev; method own {} {}"
+      set prev ::timeDef::ns::D$i
+    }
+    itcl::delete class ::timeDef::ns::D0
+  }
+  for {set i 0} {$i < 8} {incr i} {
+    itcl::class ::timeDef::ns::M$i {}
+  }
+  proc ::timeDef::multi {} {
+    set bases [info commands ::timeDef::ns::M*]
+    for {set i 0} {$i < 30} {incr i} {
+      itcl::class ::timeDef::ns::E$i "inherit $bases"
+    }
+    foreach cls [info commands ::timeDef::ns::E*] {
+      itcl::delete class $cls
+    }
+  }
+  _test_run $reptime {
+    # define 30 classes deriving from a class with 100 methods, delete them:
+    {::timeDef::chain}
+    # define 30 classes with 8 base classes each, delete them:
+    {::timeDef::multi}
+  }
+  namespace delete ::timeDef
+  _test_out_total
+}
+
+# class definition from a source file vs. from a snapshot of it:
+proc test-snapshot {{reptime {3000 10}}} {
+  _test_start $reptime
+  set dir [file join [pwd] timeSnap[pid]]
+  file mkdir $dir
+  set src [file join $dir defs.tcl]
+  set snap [file join $dir defs.snap]
+  set f [open $src w]
+  for {set c 0} {$c < 50} {incr c} {
+    puts $f "itcl::class ::timeSnap::C$c {"
+    for {set m 0} {$m < 20} {incr m} {
+      puts $f "  method m$m {a {b 2}} {\n    set x \[expr {\$a + \$b}\]\n    return \$x\n  }"
+    }
+    puts $f "  variable v 0\n  common c {}\n}"
+  }
+  close $f
+  namespace eval ::timeSnap {}
+  itcl::internal::commands::snapshot record $snap [list $src] \
+      [list source $src]
+  namespace delete ::timeSnap
+  proc ::timeSnapSource {src} {
+    source $src
+    namespace delete ::timeSnap
+  }
+  proc ::timeSnapLoad {snap src} {
+    itcl::internal::commands::snapshot load $snap [list $src]
+    namespace delete ::timeSnap
+  }
+  # the paths are passed in variables, so the case names do not change
+  # from run to run:
+  set ::timeSnapSrc $src
+  set ::timeSnapFile $snap
+  _test_run $reptime {
+    # define 50 classes by sourcing their definitions:
+    {::timeSnapSource $::timeSnapSrc}
+    # define the same classes from a snapshot:
+    {::timeSnapLoad $::timeSnapFile $::timeSnapSrc}
+  }
+  unset ::timeSnapSrc ::timeSnapFile
+  rename ::timeSnapSource {}
+  rename ::timeSnapLoad {}
+  file delete -force $dir
+  _test_out_total
+}
+
+# ------------------------------------------------------------------------
+
+# autoload one class of many, by tclIndex and by binary itcl index:
+proc test-autoindex {{reptime {3000 10}}} {
+  _test_start $reptime
+  set dir [file join [pwd] timeAutoIdx[pid]]
+  file mkdir $dir
+  set src [file join $dir defs.tcl]
+  set f [open $src w]
+  for {set c 0} {$c < 50} {incr c} {
+    puts $f "itcl::class ::timeAutoIdx::C$c {"
+    for {set m 0} {$m < 20} {incr m} {
+      puts $f "  method m$m {a {b 2}} {\n    return \[expr {\$a + \$b}\]\n  }"
+    }
+    puts $f "}"
+  }
+  close $f
+  auto_mkindex $dir defs.tcl
+  itcl::autoindex create [file join $dir defs.idx] $src
+  proc ::timeAutoIdxUse {} {
+    ::timeAutoIdx::C25 o
+    namespace delete ::timeAutoIdx
+  }
+  _test_run $reptime [string map [list @DIR@ [list $dir]] {
+    # autoload one class, tclIndex sources the whole file:
+    setup {set ::auto_path [linsert $::auto_path 0 @DIR@]}
+    {::timeAutoIdxUse}
+    cleanup {set ::auto_path [lrange $::auto_path 1 end]}
+    # autoload one class from the binary index:
+    setup {itcl::autoindex add [file join @DIR@ defs.idx]}
+    {::timeAutoIdxUse}
+  }]
+  rename ::timeAutoIdxUse {}
+  file delete -force $dir
+  _test_out_total
+}
+
+# ------------------------------------------------------------------------
+
+# command resolution in class namespaces (uncompiled lookups):
+proc test-cmd-resolve {{reptime 1000}} {
+  _test_start $reptime
+  itcl::class timeResClass {
+    public method m {} {}
+    public method callv {cmd} {$cmd}
+    public method callq {} {timeResClass::m}
+  }
+  itcl::type timeResType {
+    method m {} {}
+    method callv {cmd args} {$cmd {*}$args}
+  }
+  _test_run $reptime {
+    setup {timeResClass o; timeResType t}
+    # class) resolve method:
+    {o callv m}
+    # class) resolve qualified method:
+    {o callq}
+    # class) resolve global command (miss):
+    {o callv list}
+    # type) resolve built-in method:
+    {t callv mymethod m}
+    # type) resolve global command (miss):
+    {t callv list}
+    cleanup {itcl::delete object o; t destroy}
+  }
+  itcl::delete class timeResClass
+  timeResType destroy
+  _test_out_total
+}
+
+# ------------------------------------------------------------------------
+
+# method dispatch (call context push/pop per invocation):
+proc test-method-call {{reptime 1000}} {
+  _test_start $reptime
+  itcl::class timeCallBase {
+    public method m {} {}
+    public method inner {} {m}
+    public method nested {n} {if {$n} {nested [incr n -1]}}
+    public proc p {} {}
+    public method callp {} {p}
+  }
+  itcl::class timeCallClass {
+    inherit timeCallBase
+    public method m {} {}
+    public method up {} {timeCallBase::m}
+    public method info_ {} {info class}
+    public method this_ {} {set this}
+    public method thisn {} {for {set i 0} {$i < 100} {incr i} {set this}}
+    public method viaThis {} {$this m}
+    protected method pm {} {}
+    public method callpm {} {pm}
+  }
+  _test_run $reptime {
+    setup {timeCallClass o}
+    # trivial method from outside:
+    {o m}
+    # base class method by qualified name from outside:
+    {o timeCallBase::m}
+    # method called through the object command from a method:
+    {o viaThis}
+    # protected method from a method:
+    {o callpm}
+    # method calling a method:
+    {o inner}
+    # method calling a base class method:
+    {o up}
+    # method calling a common proc:
+    {o callp}
+    # nested method calls (depth 10):
+    {o nested 10}
+    # object info from a method:
+    {o info_}
+    # built-in variable "this" from a method:
+    {o this_}
+    # built-in variable "this" read 100 times:
+    {o thisn}
+    cleanup {itcl::delete object o}
+  }
+  itcl::delete class timeCallBase
+  _test_out_total
+}
+
+# ------------------------------------------------------------------------
+
+# configure/cget of type options:
+proc test-type-options {{reptime 1000}} {
+  _test_start $reptime
+  itcl::type timeOptType {
+    option -a 1
+    option -b 2
+    option -c 3
+    option -d 4
+    method getC {} {set itcl_options(-c)}
+  }
+  _test_run $reptime {
+    setup {timeOptType o}
+    # cget of an option:
+    {o cget -c}
+    # configure of one option:
+    {o configure -c 5}
+    # configure of four options:
+    {o configure -a 1 -b 2 -c 3 -d 4}
+    # option read in a method:
+    {o getC}
+    # list all options:
+    {o configure}
+    cleanup {o destroy}
+    # create with options and destroy:
+    {timeOptType o -a 1 -b 2 -c 3; o destroy}
+  }
+  itcl::delete class timeOptType
+  _test_out_total
+}
+
+# ------------------------------------------------------------------------
+
+# configure/cget of public variables (30 options):
+proc test-public-config {{reptime 1000}} {
+  _test_start $reptime
+  set body {constructor {args} {configure {*}$args}}
+  set ::cfgArgs {}
+  for {set i 0} {$i < 30} {incr i} {
+    append body "\npublic variable v$i $i"
+    lappend ::cfgArgs -v$i x$i
+  }
+  itcl::class timeCfgClass $body
+  _test_run $reptime {
+    setup {timeCfgClass o}
+    # cget of a public variable:
+    {o cget -v7}
+    # configure of one public variable:
+    {o configure -v7 5}
+    # configure of 30 public variables:
+    {o configure {*}$::cfgArgs}
+    # list all options:
+    {o configure}
+    cleanup {itcl::delete object o}
+    # create with 30 options and delete:
+    {timeCfgClass o {*}$::cfgArgs; itcl::delete object o}
+  }
+  itcl::delete class timeCfgClass
+  unset ::cfgArgs
+  _test_out_total
+}
+
+proc test-ensemble {{reptime 1000}} {
+  _test_start $reptime
+  set body {}
+  foreach n {alpha beta delta gamma kappa lambda omega sigma} {
+    append body "part $n {args} {return $n}\n"
+  }
+  itcl::ensemble timeEns "
+    $body
+    ensemble sub {$body}
+  "
+  _test_run $reptime {
+    # top level part:
+    {timeEns delta}
+    # top level part by unique prefix:
+    {timeEns del}
+    # nested part:
+    {timeEns sub sigma 1 2}
+    # nested part by unique prefix:
+    {timeEns su si 1 2}
+    # find a sub ensemble in a definition:
+    {itcl::ensemble timeEns ensemble sub {}}
+  }
+  itcl::delete ensemble timeEns
+  _test_out_total
+}
+
+# ------------------------------------------------------------------------
+
+# method dispatch at hierarchy depths 1, 5 and 10:
+proc test-dispatch-depth {{reptime 1000}} {
+  _test_start $reptime
+  itcl::class timeDisp0 {
+    public variable v 0
+    public method base {} {}
+    public method over {} {}
+    public method getv {} {set v}
+  }
+  for {set i 1} {$i < 10} {incr i} {
+    itcl::class timeDisp$i "
+      inherit timeDisp[expr {$i-1}]
+      public method over {} {}
+    "
+  }
+  foreach depth {1 5 10} {
+    set cls timeDisp[expr {$depth-1}]
+    _test_run $reptime [string map [list \$cls $cls \$depth $depth] {
+      setup {$cls o}
+      # depth $depth) method of the most derived class:
+      {o over}
+      # depth $depth) method of the base class:
+      {o base}
+      # depth $depth) base class variable in a base class method:
+      {o getv}
+      # depth $depth) base class method by qualified name:
+      {o timeDisp0::over}
+      cleanup {itcl::delete object o}
+    }]
+  }
+  itcl::delete class timeDisp0
+  _test_out_total
+}
+
+# ------------------------------------------------------------------------
+
+# instance and common variables, compiled and uncompiled access:
+proc test-var-access {{reptime 1000}} {
+  _test_start $reptime
+  itcl::class timeVarClass {
+    public variable inst 0
+    public common com 0
+    public method getInst {} {set inst}
+    public method setInst {} {set inst 1}
+    public method getCom {} {set com}
+    public method setCom {} {set com 1}
+    public method getVar {name} {set $name}
+    public method setVar {name} {set $name 1}
+  }
+  _test_run $reptime {
+    setup {timeVarClass o}
+    # instance variable, compiled read:
+    {o getInst}
+    # instance variable, compiled write:
+    {o setInst}
+    # instance variable, uncompiled read:
+    {o getVar inst}
+    # instance variable, uncompiled write:
+    {o setVar inst}
+    # common variable, compiled read:
+    {o getCom}
+    # common variable, compiled write:
+    {o setCom}
+    # common variable, uncompiled read:
+    {o getVar com}
+    # common variable, uncompiled write:
+    {o setVar com}
+    cleanup {itcl::delete object o}
+  }
+  itcl::delete class timeVarClass
+  _test_out_total
+}
+
+# ------------------------------------------------------------------------
+
+# delegation of methods and options to a component of an itcl::type:
+proc test-delegation {{reptime 1000}} {
+  _test_start $reptime
+  itcl::type ::timeDelegTarget {
+    option -color red
+    method m {} {}
+    method echo {x} {return $x}
+  }
+  itcl::type ::timeDelegType {
+    component target
+    delegate method m to target
+    delegate method echo to target
+    delegate option -color to target
+    constructor {args} {
+      set target [timeDelegTarget %AUTO%]
+    }
+    destructor {
+      catch {$target destroy}
+    }
+  }
+  _test_run $reptime {
+    setup {timeDelegType o}
+    # delegated method:
+    {o m}
+    # delegated method with an argument:
+    {o echo x}
+    # cget of a delegated option:
+    {o cget -color}
+    # configure of a delegated option:
+    {o configure -color blue}
+    cleanup {o destroy}
+    # create and destroy with a component:
+    {timeDelegType o; o destroy}
+  }
+  timeDelegType destroy
+  timeDelegTarget destroy
+  _test_out_total
+}
+
+# ------------------------------------------------------------------------
+
+# itcl::find and info queries (100 classes, 1000 objects):
+proc test-find-info {{reptime 1000}} {
+  _test_start $reptime
+  for {set i 0} {$i < 100} {incr i} {
+    itcl::class timeFind$i {
+      public variable a 0
+      public variable b 0
+      public method m {} {}
+      public method infoFunc {} {info function m}
+      public method infoVar {} {info variable a -value}
+    }
+  }
+  for {set i 0} {$i < 1000} {incr i} {
+    timeFind[expr {$i % 100}] ::timeFindObj$i
+  }
+  _test_run $reptime {
+    # find all classes:
+    {itcl::find classes}
+    # find classes by pattern:
+    {itcl::find classes timeFind5*}
+    # find all objects:
+    {itcl::find objects}
+    # find objects of a class:
+    {itcl::find objects -class timeFind50}
+    # find objects by isa:
+    {itcl::find objects -isa timeFind50}
+    # is object:
+    {itcl::is object ::timeFindObj500}
+    # info class:
+    {::timeFindObj500 info class}
+    # info function from a method:
+    {::timeFindObj500 infoFunc}
+    # info variable value from a method:
+    {::timeFindObj500 infoVar}
+  }
+  for {set i 0} {$i < 100} {incr i} {
+    itcl::delete class timeFind$i
+  }
+  _test_out_total
+}
+
+# ------------------------------------------------------------------------
+
+# variable names from itcl::scope:
+proc test-scope {{reptime 1000}} {
+  _test_start $reptime
+  itcl::class timeScopeClass {
+    variable v 0
+    method scoped {} {itcl::scope v}
+  }
+  timeScopeClass ::timeScopeObj
+  set ::timeScopeName [::timeScopeObj scoped]
+  _test_run $reptime {
+    # scope an instance variable:
+    {::timeScopeObj scoped}
+    # resolve a scoped name (cached variable):
+    {itcl::internal::commands::scopedvar $::timeScopeName}
+    # resolve the same name as a new string (namespace lookup):
+    {itcl::internal::commands::scopedvar [string range $::timeScopeName 0 end]}
+  }
+  unset ::timeScopeName
+  itcl::delete class timeScopeClass
+  _test_out_total
+}
+
+# ------------------------------------------------------------------------
+
+# callbacks made by itcl::code and mymethod:
+proc test-callback {{reptime 1000}} {
+  _test_start $reptime
+  itcl::class timeCodeClass {
+    method handler {args} {}
+    method callback {} {itcl::code $this handler}
+  }
+  itcl::type timeCallbackType {
+    method handler {args} {}
+    method callback {} {mymethod handler}
+  }
+  timeCodeClass ::timeCodeObj
+  timeCallbackType ::timeCallbackObj
+  set ::timeCodeCb [::timeCodeObj callback]
+  set ::timeMyMethodCb [::timeCallbackObj callback]
+  _test_run $reptime {
+    # fire an itcl::code callback:
+    {uplevel #0 $::timeCodeCb}
+    # make and fire a new itcl::code callback:
+    {uplevel #0 [::timeCodeObj callback]}
+    # fire a mymethod callback:
+    {uplevel #0 $::timeMyMethodCb}
+    # make and fire a new mymethod callback:
+    {uplevel #0 [::timeCallbackObj callback]}
+  }
+  unset ::timeCodeCb ::timeMyMethodCb
+  itcl::delete class timeCodeClass
+  timeCallbackType destroy
+  _test_out_total
+}
+
+# ------------------------------------------------------------------------
+
+# method calls with the profiler off and on:
+proc test-profile {{reptime 1000}} {
+  _test_start $reptime
+  itcl::class ::timeProfileBase {
+    method m {} {}
+    proc p {} {}
+  }
+  itcl::class ::timeProfileClass {
+    inherit ::timeProfileBase
+    method m {} {chain}
+  }
+  ::timeProfileClass ::timeProfileObj
+  itcl::profile reset
+  _test_run $reptime {
+    # profiler off:
+    {::timeProfileObj m}
+    {::timeProfileBase::p}
+    setup {itcl::profile start}
+    # profiler on:
+    {::timeProfileObj m}
+    {::timeProfileBase::p}
+    setup {itcl::profile stop}
+    # report:
+    {itcl::profile report}
+  }
+  itcl::profile reset
+  itcl::delete class ::timeProfileBase
+  _test_out_total
+}
+
+# ------------------------------------------------------------------------
+
+# object and class deletion at scale (10000 objects):
+proc test-delete-scale {{reptime {3000 10}}} {
+  _test_start $reptime
+  itcl::class timeScaleClass {
+    public variable a 0
+    public method m {} {}
+  }
+  _test_run $reptime {
+    # create and delete 10000 objects:
+    {for {set i 0} {$i < 10000} {incr i} {timeScaleClass ::timeScale$i}
+     for {set i 0} {$i < 10000} {incr i} {itcl::delete object ::timeScale$i}}
+    # create 10000 objects and delete their class:
+    {itcl::class timeScaleDel {public variable a 0}
+     for {set i 0} {$i < 10000} {incr i} {timeScaleDel ::timeScaleDel$i}
+     itcl::delete class timeScaleDel}
+  }
+  itcl::delete class timeScaleClass
+  _test_out_total
+}
+
+# ------------------------------------------------------------------------
+
+# memory in use by the process (bytes), or empty if it can't be told:
+proc _mem_used {} {
+  if {![catch {memory info} info]} {
+    regexp {current bytes allocated\s+(\d+)} $info -> bytes
+    return $bytes
+  }
+  if {![catch {open /proc/self/status} fd]} {
+    set data [read $fd]
+    close $fd
+    if {[regexp {VmRSS:\s+(\d+)\s+kB} $data -> kb]} {
+      return [expr {$kb * 1024}]
+    }
+  }
+  return {}
+}
+
+# memory footprint of objects (bytes per instance, 1M instances):
+proc test-obj-memory {{count 1000000}} {
+  itcl::class timeMemClass {
+    public variable a 0
+    public variable b {}
+    private variable c
+    method m {} {}
+  }
+  itcl::type timeMemType {
+    option -a 0
+    variable b {}
+    method m {} {}
+  }
+  foreach cls {timeMemClass timeMemType} {
+    # warm up (layouts, pools, literal tables):
+    $cls ::timeMemWarm
+    ::timeMemWarm m
+    itcl::delete object ::timeMemWarm
+    set before [_mem_used]
+    if {$before eq {}} {
+      puts "memory usage can't be measured on this platform"
+      break
+    }
+    set start [clock milliseconds]
+    for {set i 0} {$i < $count} {incr i} {
+      $cls ::timeMemObj$i
+    }
+    set after [_mem_used]
+    set ms [expr {[clock milliseconds] - $start}]
+    set bytes [expr {double($after - $before) / $count}]
+    puts [format "%-14s : %d objects, %.1f bytes/object, %.3f us/object" \
+      $cls $count $bytes [expr {$ms * 1000.0 / $count}]]
+    if {[namespace which _test_record] ne ""} {
+      _test_record "$cls bytes/object" $bytes bytes
+    }
+    for {set i 0} {$i < $count} {incr i} {
+      itcl::delete object ::timeMemObj$i
+    }
+  }
+  itcl::delete class timeMemClass
+  timeMemType destroy
+}
+
+# ------------------------------------------------------------------------
+
+# the script implementation itcl::local had before, for comparison:
+proc timeScriptLocal {class name args} {
+  set ptr [uplevel [list $class $name] $args]
+  uplevel [list set itcl-local-$ptr $ptr]
+  set cmd [uplevel namespace which -command $ptr]
+  uplevel [list trace variable itcl-local-$ptr u \
+    "::itcl::delete_helper $cmd"]
+  return $ptr
+}
+
+# objects local to a procedure, created and destroyed count times:
+proc test-local {{count 1000000}} {
+  itcl::class ::timeLocalClass {
+    public variable a 0
+    method m {} {}
+  }
+  proc ::timeLocalC {} {
+    itcl::local ::timeLocalClass #auto
+  }
+  proc ::timeLocalScript {} {
+    ::itclTestPerf-Basic::timeScriptLocal ::timeLocalClass #auto
+  }
+  proc ::timeLocalExplicit {} {
+    itcl::delete object [::timeLocalClass #auto]
+  }
+  foreach {name cmd} {
+    {itcl::local} ::timeLocalC
+    {script local} ::timeLocalScript
+    {create and delete} ::timeLocalExplicit
+  } {
+    $cmd
+    set start [clock microseconds]
+    for {set i 0} {$i < $count} {incr i} {
+      $cmd
+    }
+    set us [expr {double([clock microseconds] - $start) / $count}]
+    puts [format "%-17s : %d objects, %.3f us/object" $name $count $us]
+    if {[namespace which _test_record] ne ""} {
+      _test_record "$name us/object" $us us
+    }
+  }
+  if {[llength [itcl::find objects -class ::timeLocalClass]]} {
+    error "local objects left over"
+  }
+  rename ::timeLocalC {}
+  rename ::timeLocalScript {}
+  rename ::timeLocalExplicit {}
+  itcl::delete class ::timeLocalClass
+}
+
+# ------------------------------------------------------------------------
+
+proc test {{reptime 1000} {objcount 1000000}} {
   set reptm $reptime
   lset reptm 0 [expr {[lindex $reptm 0] * 10}]
   if {[llength $reptm] == 1} {
@@ -194,6 +923,46 @@ proc test {{reptime 1000}} {
   test-access $reptime
   puts "==== object instance ====\n"
   test-obj-instance $reptime
+  puts "==== deep hierarchy ====\n"
+  test-deep-hier $reptime
+  puts "==== class deletion ====\n"
+  test-cls-delete
+  puts "==== class definition ====\n"
+  test-cls-define
+  puts "==== class definition snapshots ====\n"
+  test-snapshot
+  puts "==== autoload index ====\n"
+  test-autoindex
+  puts "==== command resolution ====\n"
+  test-cmd-resolve $reptime
+  puts "==== method calls ====\n"
+  test-method-call $reptime
+  puts "==== type options ====\n"
+  test-type-options $reptime
+  puts "==== public variable options ====\n"
+  test-public-config $reptime
+  puts "==== ensembles ====\n"
+  test-ensemble $reptime
+  puts "==== method dispatch by hierarchy depth ====\n"
+  test-dispatch-depth $reptime
+  puts "==== variable access ====\n"
+  test-var-access $reptime
+  puts "==== delegation ====\n"
+  test-delegation $reptime
+  puts "==== find and info ====\n"
+  test-find-info $reptime
+  puts "==== scoped variables ====\n"
+  test-scope $reptime
+  puts "==== callbacks ====\n"
+  test-callback $reptime
+  puts "==== profiler ====\n"
+  test-profile $reptime
+  puts "==== deletion at scale ====\n"
+  test-delete-scale
+  puts "==== local objects ====\n"
+  test-local $objcount
+  puts "==== object memory ====\n"
+  test-obj-memory $objcount
 
   puts \n**OK**
 }
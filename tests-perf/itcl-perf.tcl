@@ -0,0 +1,352 @@
+#!/usr/bin/tclsh
+
+# ------------------------------------------------------------------------
+#
+# itcl-perf.tcl --
+#
+#  Runs the itcl performance tests, writes their results as JSON and
+#  compares them with the results of an earlier run.
+#
+#  Usage: tclsh itcl-perf.tcl ?-time ms? ?-runs count? ?-json file?
+#                             ?-baseline file? ?-threshold percent?
+#                             ?-floor ns? ?-stable file? ?-fail bool?
+#                             ?-objects count? ?-load script? ?-lib lib?
+#
+#  Every measured case is stored under a key made of the test procedure,
+#  the comment describing the case and the case script, with the time per
+#  iteration in microseconds (or the bytes per object of the memory test).
+#  The tests are run -runs times; the minimum over the runs is stored as
+#  the value of a case, the median along with it.
+#
+#  If a baseline file is given and exists, the cases that got slower (or
+#  bigger) than the baseline by more than the threshold percentage, and
+#  by more than -floor nanoseconds for times, are reported.  Only the
+#  cases matching a pattern in the -stable file are gated: with -fail 1
+#  the exit status is 1 when one of them regressed.  The other cases are
+#  single samples or depend on what ran before them, and are reported
+#  for information only.
+#
+# ------------------------------------------------------------------------
+#
+# See the file "license.terms" for information on usage and redistribution
+# of this file.
+#
+
+# The timing procedures used by itcl-basic.perf.tcl, normally provided by
+# tests-perf/test-performance.tcl of the Tcl sources.  These record every
+# result in addition to printing it.
+
+namespace eval ::tclTestPerf {
+
+namespace path {::tcl::unsupported}
+
+variable results {}
+variable test {}
+variable iter 0
+
+proc _adjust_maxcount {reptime maxcount} {
+  if {[llength $reptime] > 1} {
+    lreplace $reptime 1 1 [expr {min($maxcount,[lindex $reptime 1])}]
+  } else {
+    lappend reptime $maxcount
+  }
+}
+
+proc _test_start {reptime} {
+  variable test
+  variable iter
+  upvar _ _
+  array set _ [list itm {} reptime $reptime starttime [clock milliseconds]]
+  set test [lindex [info level -1] 0]
+  set iter 0
+}
+
+# records a value under a key unique for the test:
+proc _record {test name value unit} {
+  variable results
+  set key "[namespace tail $test]: $name"
+  if {[dict exists $results $key]} {
+    set n 2
+    while {[dict exists $results "$key #$n"]} {
+      incr n
+    }
+    append key " #$n"
+  }
+  dict set results $key [list $value $unit]
+}
+
+# records a value measured by the calling test itself:
+proc _test_record {name value unit} {
+  _record [lindex [info level -1] 0] $name $value $unit
+}
+
+proc _test_result {lvl comment script res} {
+  variable test
+  upvar $lvl _ _
+  puts $res
+  puts ""
+  lappend _(itm) $res
+  set name [regsub -all {\s*\n\s*} [string trim $script] {; }]
+  if {$comment ne ""} {
+    set name "$comment: $name"
+  }
+  _record $test $name [lindex $res 0] us
+}
+
+# result of a timerate measured by the test itself:
+proc _test_iter {lvl res} {
+  variable iter
+  incr lvl
+  _test_result $lvl {} "iteration [incr iter]" $res
+}
+
+proc _test_run {reptime lst} {
+  variable test
+  upvar _ _
+  set test [lindex [info level -1] 0]
+  set comment {}
+  set item {}
+  foreach line [split $lst \n] {
+    if {$item eq ""} {
+      set line [string trim $line]
+      if {$line eq ""} {
+        continue
+      }
+      if {[string index $line 0] eq "#"} {
+        set comment [string trimright [string trimleft $line "# "] ":"]
+        puts $line
+        continue
+      }
+    } else {
+      append item \n
+    }
+    append item $line
+    if {![info complete $item]} {
+      continue
+    }
+    switch -- [lindex $item 0] {
+      setup - cleanup {
+        uplevel 1 [lindex $item 1]
+      }
+      default {
+        set script [lindex $item 0]
+        puts "% [regsub -all {\s*\n\s*} [string trim $script] {; }]"
+        set res [uplevel 1 [list timerate $script {*}$reptime]]
+        _test_result 2 $comment $script $res
+      }
+    }
+    set item {}
+  }
+}
+
+proc _test_out_total {} {
+  upvar _ _
+  set tcnt [llength $_(itm)]
+  if {!$tcnt} {
+    puts ""
+    return
+  }
+  set total 0.0
+  set mintm {}
+  set maxtm {}
+  foreach res $_(itm) {
+    set tm [lindex $res 0]
+    set total [expr {$total + $tm}]
+    if {$mintm eq {} || $tm < $mintm} {set mintm $tm}
+    if {$maxtm eq {} || $tm > $maxtm} {set maxtm $tm}
+  }
+  puts [string repeat ** 40]
+  puts [format "Total %d cases in %.2f sec." $tcnt \
+    [expr {([clock milliseconds] - $_(starttime)) / 1000.0}]]
+  puts [format "Average: %.6f us/#" [expr {$total / $tcnt}]]
+  puts [format "Min: %.6f us/#" $mintm]
+  puts [format "Max: %.6f us/#" $maxtm]
+  puts [string repeat ** 40]
+  puts ""
+}
+
+}; # end of ::tclTestPerf
+
+namespace eval ::itclTestPerf {
+
+variable samples {}
+variable unitOf {}
+
+proc _json_string {str} {
+  return "\"[string map [list \\ \\\\ \" \\\" \n \\n \t \\t] $str]\""
+}
+
+# adds the results of one run to the samples of all runs:
+proc add-run {} {
+  variable samples
+  variable unitOf
+  dict for {key res} $::tclTestPerf::results {
+    lassign $res value unit
+    dict lappend samples $key $value
+    dict set unitOf $key $unit
+  }
+  set ::tclTestPerf::results {}
+}
+
+# returns a dict from case key to {min median unit}:
+proc summary {} {
+  variable samples
+  variable unitOf
+  set result {}
+  dict for {key values} $samples {
+    set sorted [lsort -real $values]
+    set n [llength $sorted]
+    if {$n % 2} {
+      set median [lindex $sorted [expr {$n / 2}]]
+    } else {
+      set median [expr {([lindex $sorted [expr {$n / 2 - 1}]]
+        + [lindex $sorted [expr {$n / 2}]]) / 2.0}]
+    }
+    dict set result $key [list [lindex $sorted 0] $median \
+      [dict get $unitOf $key]]
+  }
+  return $result
+}
+
+# writes the summarized results as JSON:
+proc write-json {file time runs} {
+  set lines {}
+  dict for {key res} [summary] {
+    lassign $res value median unit
+    lappend lines [format {    %s: {"value": %s, "median": %s, "unit": %s}} \
+      [_json_string $key] $value $median [_json_string $unit]]
+  }
+  set f [open $file w]
+  fconfigure $f -encoding utf-8
+  puts $f "\{"
+  puts $f "  \"tcl\": [_json_string [info patchlevel]],"
+  puts $f "  \"itcl\": [_json_string [package present itcl]],"
+  puts $f "  \"time\": $time,"
+  puts $f "  \"runs\": $runs,"
+  puts $f "  \"results\": \{"
+  puts $f [join $lines ",\n"]
+  puts $f "  \}"
+  puts $f "\}"
+  close $f
+}
+
+# reads the results of a file written by write-json:
+proc read-json {file} {
+  set f [open $file]
+  fconfigure $f -encoding utf-8
+  set data [read $f]
+  close $f
+  set results {}
+  foreach {-> key value} [regexp -all -inline -line \
+      {^\s*"((?:[^"\\]|\\.)*)": \{"value": ([-+.0-9eE]+),} $data] {
+    dict set results [subst -nocommands -novariables $key] $value
+  }
+  return $results
+}
+
+# reads the patterns of the stable cases, one per line:
+proc read-stable {file} {
+  set patterns {}
+  set f [open $file]
+  fconfigure $f -encoding utf-8
+  foreach line [split [read $f] \n] {
+    set line [string trim $line]
+    if {$line ne "" && [string index $line 0] ne "#"} {
+      lappend patterns $line
+    }
+  }
+  close $f
+  return $patterns
+}
+
+proc is-stable {key patterns} {
+  foreach pattern $patterns {
+    if {[string match $pattern $key]} {
+      return 1
+    }
+  }
+  return 0
+}
+
+# prints cases that got worse than baseline by more than threshold
+# percent and, for times, by more than floor nanoseconds.  Returns the
+# number of such cases among the stable ones:
+proc compare {baseline threshold floor patterns} {
+  set gated 0
+  set other 0
+  set compared 0
+  set base [read-json $baseline]
+  puts [string repeat ** 40]
+  puts "Comparison with $baseline (threshold $threshold%, floor $floor ns):"
+  dict for {key res} [summary] {
+    if {![dict exists $base $key]} {
+      continue
+    }
+    incr compared
+    set old [dict get $base $key]
+    lassign $res new median unit
+    if {$old <= 0 || $new <= $old * (1.0 + $threshold / 100.0)} {
+      continue
+    }
+    if {$unit eq "us" && ($new - $old) * 1000.0 < $floor} {
+      continue
+    }
+    if {[is-stable $key $patterns]} {
+      incr gated
+      set label REGRESSION
+    } else {
+      incr other
+      set label "(unstable)"
+    }
+    puts [format "  %s %+.1f%% : %s (%s -> %s)" $label \
+      [expr {($new - $old) * 100.0 / $old}] $key $old $new]
+  }
+  puts "$compared cases compared, $gated regressions in stable cases,\
+    $other changes in other cases"
+  puts [string repeat ** 40]
+  return $gated
+}
+
+}; # end of ::itclTestPerf
+
+# ------------------------------------------------------------------------
+
+array set in {
+  -time 500 -runs 3 -json {} -baseline {} -threshold 20 -floor 100
+  -stable {} -fail 0 -objects 100000 -lib {} -load {}
+}
+array set in $argv
+if {$in(-load) ne ""} {
+  eval $in(-load)
+}
+if {![namespace exists ::itcl]} {
+  if {$in(-lib) eq ""} {
+    package require itcl
+  } else {
+    puts "testing with $in(-lib)"
+    load $in(-lib) itcl
+  }
+}
+
+if {$in(-stable) eq ""} {
+  set in(-stable) [file join [file dirname [info script]] itcl-perf.stable]
+}
+source [file join [file dirname [info script]] itcl-basic.perf.tcl]
+for {set run 1} {$run <= $in(-runs)} {incr run} {
+  puts "==== run $run of $in(-runs) ====\n"
+  ::itclTestPerf-Basic::test $in(-time) $in(-objects)
+  ::itclTestPerf::add-run
+}
+
+if {$in(-json) ne ""} {
+  ::itclTestPerf::write-json $in(-json) $in(-time) $in(-runs)
+  puts "results written to $in(-json)"
+}
+if {$in(-baseline) ne ""} {
+  if {![file exists $in(-baseline)]} {
+    puts "no baseline $in(-baseline), nothing compared"
+  } elseif {[::itclTestPerf::compare $in(-baseline) $in(-threshold) \
+      $in(-floor) [::itclTestPerf::read-stable $in(-stable)]] && $in(-fail)} {
+    exit 1
+  }
+}
@@ -0,0 +1,188 @@
+/*
+ * itclThreadPerf.c --
+ *
+ *      Multi-threaded stress test and benchmark for [incr Tcl].  Runs
+ *      class definition, object creation and deletion churn in one
+ *      interpreter per thread, concurrently on 1, 2, 4 ... threads, checks
+ *      that every interpreter got the expected result and reports the
+ *      throughput and how it scales with the number of threads.
+ *
+ *      Usage: itclThreadPerf -lib itclLibrary ?-threads max? ?-rounds n?
+ *
+ *      Built and run by "make perf-threads".
+ *
+ * See the file "license.terms" for information on usage and redistribution of
+ * this file, and for a DISCLAIMER OF ALL WARRANTIES.
+ */
+
+#undef USE_TCL_STUBS
+#undef USE_TCLOO_STUBS
+#include <tcl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ *  One round defines a small hierarchy, creates and deletes objects of
+ *  it and deletes the classes again.  The result is checked, so that a
+ *  corrupted shared structure shows up as a failure and not only as a
+ *  crash.
+ */
+static const char churnScript[] =
+    "proc churn {rounds} {\n"
+    "    set sum 0\n"
+    "    for {set r 0} {$r < $rounds} {incr r} {\n"
+    "        itcl::class Base$r {\n"
+    "            variable v 0\n"
+    "            method bump {} {incr v}\n"
+    "        }\n"
+    "        itcl::class Mixin$r {\n"
+    "            method name {} {return [namespace tail [info class]]}\n"
+    "        }\n"
+    "        itcl::class Derived$r \"\n"
+    "            inherit Base$r Mixin$r\n"
+    "            method bump {} {chain}\n"
+    "        \"\n"
+    "        for {set i 0} {$i < 20} {incr i} {\n"
+    "            Derived$r o$i\n"
+    "            incr sum [o$i bump]\n"
+    "            itcl::delete object o$i\n"
+    "        }\n"
+    "        itcl::delete class Base$r Mixin$r\n"
+    "    }\n"
+    "    return $sum\n"
+    "}\n";
+
+typedef struct ThreadArgs {
+    const char *lib;            /* itcl shared library to load */
+    int rounds;                 /* rounds of churn to run */
+    int ok;                     /* set if the result was as expected */
+    char message[200];          /* error message otherwise */
+} ThreadArgs;
+
+static Tcl_ThreadCreateType
+ChurnThread(
+    ClientData clientData)
+{
+    ThreadArgs *argsPtr = (ThreadArgs *)clientData;
+    Tcl_Interp *interp;
+    Tcl_Obj *scriptPtr;
+    int sum;
+
+    interp = Tcl_CreateInterp();
+    scriptPtr = Tcl_ObjPrintf("load {%s} Itcl; %s; churn %d", argsPtr->lib,
+            churnScript, argsPtr->rounds);
+    Tcl_IncrRefCount(scriptPtr);
+    if ((Tcl_Init(interp) != TCL_OK)
+            || (Tcl_EvalObjEx(interp, scriptPtr, 0) != TCL_OK)) {
+        snprintf(argsPtr->message, sizeof(argsPtr->message), "%s",
+                Tcl_GetStringResult(interp));
+    } else if ((Tcl_GetIntFromObj(NULL, Tcl_GetObjResult(interp), &sum)
+            != TCL_OK) || (sum != argsPtr->rounds * 20)) {
+        snprintf(argsPtr->message, sizeof(argsPtr->message),
+                "wrong result \"%s\"", Tcl_GetStringResult(interp));
+    } else {
+        argsPtr->ok = 1;
+    }
+    Tcl_DecrRefCount(scriptPtr);
+    Tcl_DeleteInterp(interp);
+    Tcl_ExitThread(0);
+    TCL_THREAD_CREATE_RETURN;
+}
+
+/*
+ *  Runs the churn on numThreads threads at once.  Returns the elapsed
+ *  time in seconds, or a negative value if a thread failed.
+ */
+static double
+RunThreads(
+    const char *lib,
+    int numThreads,
+    int rounds)
+{
+    Tcl_ThreadId *ids;
+    ThreadArgs *args;
+    Tcl_Time start;
+    Tcl_Time end;
+    int failed = 0;
+    int result;
+    int i;
+
+    ids = (Tcl_ThreadId *)ckalloc(numThreads * sizeof(Tcl_ThreadId));
+    args = (ThreadArgs *)ckalloc(numThreads * sizeof(ThreadArgs));
+    memset(args, 0, numThreads * sizeof(ThreadArgs));
+    Tcl_GetTime(&start);
+    for (i = 0; i < numThreads; i++) {
+        args[i].lib = lib;
+        args[i].rounds = rounds;
+        if (Tcl_CreateThread(&ids[i], ChurnThread, &args[i],
+                TCL_THREAD_STACK_DEFAULT, TCL_THREAD_JOINABLE) != TCL_OK) {
+            fprintf(stderr, "can't create thread %d\n", i);
+            exit(1);
+        }
+    }
+    for (i = 0; i < numThreads; i++) {
+        Tcl_JoinThread(ids[i], &result);
+        if (!args[i].ok) {
+            fprintf(stderr, "thread %d failed: %s\n", i, args[i].message);
+            failed = 1;
+        }
+    }
+    Tcl_GetTime(&end);
+    ckfree((char *)ids);
+    ckfree((char *)args);
+    if (failed) {
+        return -1.0;
+    }
+    return (end.sec - start.sec) + (end.usec - start.usec) / 1e6;
+}
+
+int
+main(
+    int argc,
+    char **argv)
+{
+    const char *lib = NULL;
+    int maxThreads = 8;
+    int rounds = 200;
+    double single = 0.0;
+    double seconds;
+    double rate;
+    int n;
+    int i;
+
+    for (i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-lib") == 0) {
+            lib = argv[i+1];
+        } else if (strcmp(argv[i], "-threads") == 0) {
+            maxThreads = atoi(argv[i+1]);
+        } else if (strcmp(argv[i], "-rounds") == 0) {
+            rounds = atoi(argv[i+1]);
+        } else {
+            break;
+        }
+    }
+    if ((lib == NULL) || (i < argc) || (maxThreads < 1) || (rounds < 1)) {
+        fprintf(stderr, "usage: %s -lib itclLibrary ?-threads max?"
+                " ?-rounds n?\n", argv[0]);
+        return 2;
+    }
+    Tcl_FindExecutable(argv[0]);
+
+    printf("%d rounds of class/object churn per thread\n", rounds);
+    printf("threads    seconds    rounds/sec    speedup\n");
+    for (n = 1; n <= maxThreads; n *= 2) {
+        seconds = RunThreads(lib, n, rounds);
+        if (seconds < 0.0) {
+            return 1;
+        }
+        rate = n * rounds / seconds;
+        if (n == 1) {
+            single = rate;
+        }
+        printf("%7d %10.3f %13.1f %10.2f\n", n, seconds, rate, rate / single);
+        fflush(stdout);
+    }
+    Tcl_Finalize();
+    return 0;
+}